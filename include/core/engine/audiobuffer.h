@@ -67,6 +67,9 @@ public:
     void fillRemainingWithSilence();
     void adjustVolumeOfSamples(double volume);
 
+    /** Scales the samples in @p data, which must be in @p format, in place. */
+    static void adjustVolumeOfSamples(std::span<std::byte> data, const AudioFormat& format, double volume);
+
 private:
     struct Private;
     QExplicitlySharedDataPointer<Private> p;
@@ -43,6 +43,14 @@ enum TrackStatus
     InvalidTrack
 };
 
+struct PlaybackStats
+{
+    //! Number of times the output ran dry while more audio was still to come
+    uint64_t underruns{0};
+    //! Number of writes which couldn't fill the output's free space with decoded audio
+    uint64_t shortWrites{0};
+};
+
 class FYCORE_EXPORT AudioEngine : public QObject
 {
     Q_OBJECT
@@ -66,6 +74,9 @@ public:
     virtual void setAudioOutput(const OutputCreator& output) = 0;
     virtual void setOutputDevice(const QString& device)      = 0;
 
+    /** Returns counters for measuring playback stability; safe to call from any thread. */
+    [[nodiscard]] virtual PlaybackStats playbackStats() const = 0;
+
 signals:
     void stateChanged(PlaybackState state);
     void trackStatusChanged(TrackStatus status);
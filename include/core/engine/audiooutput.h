@@ -24,6 +24,9 @@
 
 #include <QString>
 
+#include <chrono>
+#include <span>
+
 namespace Fooyin {
 struct OutputState
 {
@@ -105,6 +108,36 @@ public:
     virtual int write(const AudioBuffer& buffer) = 0;
     virtual void setPaused(bool pause)           = 0;
 
+    /*!
+     * Returns a region of the driver's own buffer with room for at most @p frames frames, for drivers
+     * which can expose it directly. The region must be filled and passed to @fn commitBuffer before
+     * any other call is made.
+     * @note this will only be called if @fn initialised returns @c true.
+     * @returns an empty span if unsupported, in which case @fn write is used instead.
+     */
+    virtual std::span<std::byte> mapBuffer(int /*frames*/)
+    {
+        return {};
+    }
+    /*!
+     * Hands the first @p frames frames of the region returned by @fn mapBuffer to the driver.
+     * @returns the number of frames committed.
+     */
+    virtual int commitBuffer(int /*frames*/)
+    {
+        return 0;
+    }
+
+    /*!
+     * Blocks until the driver has room for more data or @p timeout has passed.
+     * @note this will only be called if @fn initialised returns @c true.
+     * @returns @c false if the driver can't be waited on, in which case the caller will sleep instead.
+     */
+    virtual bool waitForSpace(std::chrono::milliseconds /*timeout*/)
+    {
+        return false;
+    }
+
     /*!
      * Set's the volume of the audio driver.
      * @note this will only be called if @fn canHandleVolume returns @c true.
@@ -55,6 +55,9 @@ public:
 
     virtual std::unique_ptr<AudioDecoder> createDecoder() = 0;
 
+    /** Returns underrun and short write counts for the current playback engine. */
+    [[nodiscard]] virtual PlaybackStats playbackStats() const = 0;
+
 signals:
     void outputChanged(const QString& output);
     void deviceChanged(const QString& device);
@@ -26,6 +26,7 @@
 #include <QObject>
 
 namespace Fooyin {
+class TrackStore;
 struct LibraryInfo;
 
 /*!
@@ -47,6 +48,17 @@ struct ScanRequest
     std::function<void()> cancel;
 };
 
+/*!
+ * A queued request to write metadata to files and the database.
+ * Progress is reported through metadataWriteProgress, and tracks which couldn't be written through
+ * metadataWriteFailed. Cancelling stops the request after the files currently being written.
+ */
+struct WriteRequest
+{
+    int id{-1};
+    std::function<void()> cancel;
+};
+
 /*!
  * Represents a music library containing Track objects.
  * Acts as a unified library view for all tracks in all libraries,
@@ -86,11 +98,28 @@ public:
     /** Returns all tracks for all libraries */
     [[nodiscard]] virtual TrackList tracks() const = 0;
 
+    /*!
+     * Returns the frequently scanned fields of all tracks, stored column by column.
+     * Prefer this over tracks() for passes over the whole library which only need a few fields.
+     * @note the store is updated as the library changes, so rows shouldn't be held on to.
+     */
+    [[nodiscard]] virtual const TrackStore& trackStore() const = 0;
+
     /** Returns a TrackList containing each track (if) found with an id from @p ids  */
     [[nodiscard]] virtual TrackList tracksForIds(const TrackIds& ids) const = 0;
 
-    /** Updates the metdata in the database for @p tracks and writes metdata to files  */
-    virtual void updateTrackMetadata(const TrackList& tracks) = 0;
+    /** Returns all tracks with files located anywhere within @p dir */
+    [[nodiscard]] virtual TrackList tracksInDirectory(const QString& dir) const = 0;
+
+    /** Returns the tracks with a filepath matching any of @p filepaths */
+    [[nodiscard]] virtual TrackList tracksForPaths(const QStringList& filepaths) const = 0;
+
+    /*!
+     * Updates the metdata in the database for @p tracks and writes metdata to files.
+     * Tracks are written in batches, with tracksUpdated emitted for each.
+     * @returns a WriteRequest representing the queued write.
+     */
+    virtual WriteRequest updateTrackMetadata(const TrackList& tracks) = 0;
 
     /** Updates the statistics (playcount, rating etc) in the database for @p track  */
     virtual void updateTrackStats(const Track& track) = 0;
@@ -99,6 +128,9 @@ signals:
     void scanProgress(int id, int percent);
     void tracksScanned(int id, const TrackList& tracks);
 
+    void metadataWriteProgress(int id, int processed, int total);
+    void metadataWriteFailed(int id, const TrackList& tracks);
+
     void tracksLoaded(const TrackList& tracks);
     void tracksAdded(const TrackList& tracks);
     void tracksUpdated(const TrackList& tracks);
@@ -27,17 +27,21 @@ class QString;
 
 namespace Fooyin::Filter {
 /*!
- * Filters @p tracks using the @p search string
+ * Filters @p tracks using the @p search query
  *
- * Tracks are currently filtered on the following fields:
- * - Title
- * - Album
- * - Artist
- * - Album Artist
- * @note the search is case-insensitive
+ * Plain words are matched against the title, album, artist and album artist, while
+ * fields, ranges and boolean operators can be used for anything more specific.
+ * @note see TrackQuery for the query syntax
  * @param tracks the tracks to filter
- * @param search the search string
+ * @param search the search query
  * @returns a new TrackList containing the tracks which match @p search
  */
 FYCORE_EXPORT TrackList filterTracks(const TrackList& tracks, const QString& search);
+
+/*!
+ * Returns true if every track matching @p search also matches @p previous, so
+ * results already filtered by @p previous can be filtered further rather than
+ * starting again from all tracks.
+ */
+FYCORE_EXPORT bool narrowsSearch(const QString& previous, const QString& search);
 } // namespace Fooyin::Filter
@@ -0,0 +1,95 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fycore_export.h"
+
+#include <core/trackfwd.h>
+
+#include <QString>
+
+#include <memory>
+
+namespace Fooyin {
+struct QueryError
+{
+    int position{-1};
+    QString message;
+};
+
+/*!
+ * A search query compiled into a predicate tree which can be evaluated against tracks.
+ *
+ * A query is made up of terms, which are implicitly joined by AND:
+ * - @c word or @c "quoted phrase": matches if the artist, title, album or album artist contains it
+ * - @c field:value: the built-in field contains value (text) or equals value (numbers and dates)
+ * - @c field=value, @c field!=value: the field equals, or doesn't equal, value
+ * - @c field<value, @c field<=value, @c field>value, @c field>=value: numeric and date comparisons
+ * - @c field:low..high: an inclusive numeric or date range, either end of which may be omitted
+ * - @c AND, @c OR, @c NOT and parentheses: combine terms, with NOT binding tightest and OR loosest
+ *
+ * Text comparisons are case-insensitive, and list fields (artist, genre...) match if any value does.
+ * Other tags are named as in scripts, e.g. @c %mood%:happy. Words which don't start with a built-in
+ * field or a @c %tag% are plain text, so searching for "Star Wars: Episode" works as expected.
+ *
+ * Dates (addedtime, modifiedtime, firstplayed, lastplayed) accept @c yyyy, @c yyyy-MM, @c yyyy-MM-dd
+ * or @c yyyy-MM-ddTHH:mm[:ss] in local time, where each value covers the whole period given, or a
+ * relative time such as @c 30d for 30 days ago (units: h, d, w, y). Tracks without a date never match.
+ * Durations are in seconds or @c m:ss.
+ *
+ * If the query can't be parsed, the whole of it is searched for as a single phrase, matching
+ * the behaviour of a plain search.
+ */
+class FYCORE_EXPORT TrackQuery
+{
+public:
+    //! Creates an empty query, which matches every track
+    TrackQuery();
+    explicit TrackQuery(const QString& query);
+    ~TrackQuery();
+
+    TrackQuery(const TrackQuery& other);
+    TrackQuery& operator=(const TrackQuery& other);
+    TrackQuery(TrackQuery&& other) noexcept;
+    TrackQuery& operator=(TrackQuery&& other) noexcept;
+
+    [[nodiscard]] QString query() const;
+    [[nodiscard]] bool isEmpty() const;
+    [[nodiscard]] bool isValid() const;
+    [[nodiscard]] QueryError error() const;
+
+    /*!
+     * Returns true if this query is made up only of words and phrases, and every track it
+     * matches is also matched by @p other, so results for @p other can be filtered further.
+     */
+    [[nodiscard]] bool narrows(const TrackQuery& other) const;
+
+    [[nodiscard]] bool matches(const Track& track) const;
+    /*!
+     * Returns the tracks matching this query, in their original order.
+     * Large lists are split into chunks which are evaluated in parallel.
+     */
+    [[nodiscard]] TrackList filter(const TrackList& tracks) const;
+
+private:
+    struct Private;
+    std::shared_ptr<const Private> p;
+};
+} // namespace Fooyin
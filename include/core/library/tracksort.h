@@ -48,7 +48,8 @@ TrackList FYCORE_EXPORT calcSortFields(const QString& sort, const TrackList& tra
 TrackList FYCORE_EXPORT calcSortFields(const ParsedScript& sortScript, const TrackList& tracks);
 
 /*!
- * Sorts @p tracks using their current sort fields
+ * Sorts @p tracks using their current sort fields.
+ * Tracks with equal sort fields keep their relative order.
  * @param tracks the tracks to sort
  * @param order the order in which to sort the tracks
  * @returns a new sorted TrackList
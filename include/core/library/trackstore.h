@@ -0,0 +1,99 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fycore_export.h"
+
+#include <core/track.h>
+
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace Fooyin {
+/*!
+ * The frequently scanned fields of the library's tracks, stored column by column.
+ *
+ * Passes over the whole library read these contiguous arrays rather than following
+ * every Track's pointer, and only touch the Track itself for rows which match.
+ * Row i of every column describes track(i); the Track stands in as the handle for the row.
+ *
+ * Rows are kept up to date as tracks are inserted and removed rather than being rebuilt.
+ * They are in no particular order: removing a track moves the last row into its place.
+ *
+ * String fields are stored as ids of their interned data (see StringPool), so tracks
+ * with equal values have equal ids, and empty values have an id of 0.
+ */
+class FYCORE_EXPORT TrackStore
+{
+public:
+    using StringId = quintptr;
+
+    [[nodiscard]] bool empty() const;
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] bool contains(int id) const;
+
+    [[nodiscard]] const Track& track(size_t row) const;
+    //! Returns the row of the track with @p id, if it's in the store
+    [[nodiscard]] std::optional<size_t> rowForId(int id) const;
+
+    [[nodiscard]] std::span<const int> ids() const;
+    [[nodiscard]] std::span<const int> libraryIds() const;
+    [[nodiscard]] std::span<const uint64_t> durations() const;
+    [[nodiscard]] std::span<const int> years() const;
+    //! qHash of each track's hash
+    [[nodiscard]] std::span<const size_t> hashKeys() const;
+    [[nodiscard]] std::span<const StringId> artistIds() const;
+    [[nodiscard]] std::span<const StringId> albumArtistIds() const;
+    [[nodiscard]] std::span<const StringId> albumIds() const;
+    [[nodiscard]] std::span<const StringId> genreIds() const;
+
+    //! Returns the rows of tracks with a hash of @p hash
+    [[nodiscard]] std::vector<size_t> rowsWithHash(const QString& hash) const;
+    //! Returns the rows of tracks belonging to library @p libraryId
+    [[nodiscard]] std::vector<size_t> rowsInLibrary(int libraryId) const;
+
+    //! Adds @p track, or updates its row in place if a track with the same id is already stored
+    void insert(const Track& track);
+    //! Removes the track with @p id, returning true if it was found
+    bool remove(int id);
+    void clear();
+
+    static StringId stringId(const QString& str);
+    static StringId stringId(const QStringList& list);
+
+private:
+    void setRow(size_t row, const Track& track);
+
+    TrackList m_tracks;
+    std::unordered_map<int, size_t> m_rows;
+
+    std::vector<int> m_ids;
+    std::vector<int> m_libraryIds;
+    std::vector<uint64_t> m_durations;
+    std::vector<int> m_years;
+    std::vector<size_t> m_hashKeys;
+    std::vector<StringId> m_artistIds;
+    std::vector<StringId> m_albumArtistIds;
+    std::vector<StringId> m_albumIds;
+    std::vector<StringId> m_genreIds;
+};
+} // namespace Fooyin
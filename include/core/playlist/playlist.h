@@ -119,6 +119,13 @@ private:
     void replaceTracks(const TrackList& tracks);
     void appendTracks(const TrackList& tracks);
     std::vector<int> removeTracks(const std::vector<int>& indexes);
+    /*!
+     * Replaces every occurrence of @p tracks in this playlist, matched by track id.
+     * @returns the sorted indexes of the tracks which were replaced.
+     */
+    std::vector<int> updateTracks(const TrackList& tracks);
+    /** Returns the sorted indexes of every occurrence of @p tracks, matched by track id. */
+    [[nodiscard]] std::vector<int> indexesOf(const TrackList& tracks) const;
 
     /** Removes all tracks, including all shuffle order history */
     void clear();
@@ -35,6 +35,31 @@ enum Type : int
 };
 }
 
+/*!
+ * A variable name resolved once by a ScriptRegistry, so evaluating it doesn't
+ * require looking the name up again.
+ * @see ScriptRegistry::resolveVariable
+ */
+struct VariableAccessor
+{
+    enum Type : int
+    {
+        // Evaluated by name through ScriptRegistry::value
+        Unresolved = 0,
+        // Built-in track field, index into the registry's field accessors
+        Metadata,
+        // Track::extraTag lookup using the uppercased tag
+        ExtraTag,
+        // Property of a TrackList, index into the registry's list properties
+        TrackList,
+    };
+
+    Type type{Unresolved};
+    int id{-1};
+    QString name;
+    QString tag;
+};
+
 struct Expression;
 using ExpressionList = std::vector<Expression>;
 
@@ -50,5 +75,7 @@ struct Expression
 {
     Expr::Type type{Expr::Null};
     ExpressionValue value{QStringLiteral("")};
+    // Only set for Variable and VariableList expressions
+    VariableAccessor accessor;
 };
 } // namespace Fooyin
@@ -27,6 +27,10 @@
 #include <QObject>
 
 namespace Fooyin {
+namespace Scripting {
+struct ScriptProgram;
+}
+
 struct ScriptError
 {
     int position;
@@ -40,6 +44,8 @@ struct ParsedScript
     QString input;
     ExpressionList expressions;
     ErrorList errors;
+    // Bytecode compiled from expressions, evaluated in place of the expression tree if present
+    std::shared_ptr<Scripting::ScriptProgram> program;
 
     [[nodiscard]] bool isValid() const
     {
@@ -21,6 +21,7 @@
 
 #include "fycore_export.h"
 
+#include <core/scripting/expression.h>
 #include <core/scripting/scriptvalue.h>
 #include <core/trackfwd.h>
 
@@ -41,8 +42,24 @@ public:
 
     virtual ScriptResult value(const QString& var, const Track& track) const;
     virtual ScriptResult value(const QString& var, const TrackList& tracks) const;
+
+    /*!
+     * Resolves @p var into an accessor which can be evaluated without further name lookups.
+     * Registries which override @fn value should return an unresolved accessor for the variables
+     * they handle, so those are still evaluated by name.
+     */
+    [[nodiscard]] virtual VariableAccessor resolveVariable(const QString& var) const;
+    ScriptResult value(const VariableAccessor& accessor, const Track& track) const;
+    ScriptResult value(const VariableAccessor& accessor, const TrackList& tracks) const;
     virtual ScriptResult function(const QString& func, const ScriptValueList& args) const;
 
+    /*!
+     * Returns a stable slot for @p func which can be passed to @fn function(int, ScriptValueList),
+     * or -1 if the function doesn't exist.
+     */
+    [[nodiscard]] int functionIndex(const QString& func) const;
+    ScriptResult function(int index, const ScriptValueList& args) const;
+
     virtual void setValue(const QString& var, const FuncRet& value, Track& track);
 
 protected:
@@ -21,8 +21,13 @@
 
 #include "fyutils_export.h"
 
+#include "dbquery.h"
+
 #include <QSqlDatabase>
 
+#include <map>
+#include <unordered_map>
+
 namespace Fooyin {
 class FYUTILS_EXPORT DbConnection
 {
@@ -33,6 +38,8 @@ public:
         QString connectOptions;
         QString hostName;
         QString filePath;
+        // Set on every connection when it's opened, e.g. {"journal_mode", "WAL"}
+        std::map<QString, QString> pragmas;
     };
 
     DbConnection(const DbParams& params, const QString& connectionName);
@@ -51,7 +58,16 @@ public:
 
     [[nodiscard]] QSqlDatabase db() const;
 
+    /*!
+     * Returns a prepared query for @p statement which is kept for the lifetime of this connection,
+     * so later calls with the same statement skip preparing it again.
+     * Bound values are not cleared between uses.
+     * @returns the query, or nullptr if the statement could not be prepared.
+     */
+    DbQuery* cachedQuery(const QString& statement);
+
 private:
     QString m_name;
+    std::unordered_map<QString, DbQuery> m_queryCache;
 };
 } // namespace Fooyin
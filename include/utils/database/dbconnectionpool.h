@@ -54,5 +54,6 @@ private:
     QThreadStorage<DbConnection*> m_threadConnections;
     std::atomic_int m_connectionCount;
     DbConnection m_prototype;
+    std::map<QString, QString> m_pragmas;
 };
 } // namespace Fooyin
@@ -31,6 +31,8 @@ public:
     explicit DbConnectionProvider(DbConnectionPoolPtr pool);
 
     [[nodiscard]] QSqlDatabase db() const;
+    //! @see DbConnection::cachedQuery
+    [[nodiscard]] DbQuery* cachedQuery(const QString& statement) const;
 
 private:
     DbConnectionPoolPtr m_connectionPool;
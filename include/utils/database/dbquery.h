@@ -47,6 +47,7 @@ public:
     [[nodiscard]] QSqlError lastError() const;
 
     void bindValue(const QString& placeholder, const QVariant& value);
+    void bindValue(int pos, const QVariant& value);
     [[nodiscard]] QString executedQuery() const;
     bool exec();
 
@@ -55,6 +56,9 @@ public:
     [[nodiscard]] bool next();
     [[nodiscard]] QVariant value(int index) const;
 
+    // Releases the result set so a prepared query can be executed again
+    void finish();
+
 private:
     QSqlQuery m_query;
     Status m_status;
@@ -0,0 +1,67 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fyutils_export.h"
+
+#include <QStringList>
+
+#include <memory>
+
+namespace Fooyin {
+/*!
+ * Walks directory trees on background threads, handing out files as they are found.
+ *
+ * Entry types come from readdir where the platform provides them, so only symlinks and
+ * entries on filesystems which don't report a type need to be stat'd. As with QDir,
+ * hidden entries are skipped and symlinks are followed, but each directory is only
+ * visited once.
+ *
+ * Each directory's files are handed out together, sorted by name ignoring case. With a
+ * single thread, directories are walked breadth first in the same order.
+ */
+class FYUTILS_EXPORT FileEnumerator
+{
+public:
+    /*!
+     * Starts walking @p dirs, keeping files which match one of @p nameFilters (e.g. "*.flac").
+     * Separate subtrees are walked in parallel on up to @p threadCount threads.
+     */
+    explicit FileEnumerator(const QStringList& dirs, const QStringList& nameFilters = {}, int threadCount = 1);
+    //! Stops the walk if it hasn't already finished
+    ~FileEnumerator();
+
+    FileEnumerator(const FileEnumerator&)            = delete;
+    FileEnumerator& operator=(const FileEnumerator&) = delete;
+
+    /*!
+     * Returns up to @p maxCount files, waiting until at least one has been found.
+     * An empty list means the walk has finished and every file has been returned.
+     */
+    QStringList takeFiles(qsizetype maxCount);
+
+    //! Stops walking; files which have already been found can still be taken
+    void cancel();
+
+private:
+    struct Private;
+    std::unique_ptr<Private> p;
+};
+} // namespace Fooyin
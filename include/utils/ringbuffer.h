@@ -0,0 +1,133 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace Fooyin {
+/*!
+ * A lock-free ring buffer for exactly one producer thread and one consumer thread.
+ *
+ * The producer may only call write and writeAvailable, the consumer read, skip and
+ * readAvailable. resize and clear must only be called while neither side is active.
+ */
+template <typename T>
+    requires std::is_trivially_copyable_v<T>
+class RingBuffer
+{
+public:
+    explicit RingBuffer(size_t capacity = 0)
+    {
+        resize(capacity);
+    }
+
+    //! Reallocates the buffer to hold at least @p capacity items, discarding its contents
+    void resize(size_t capacity)
+    {
+        m_buffer.assign(capacity > 0 ? std::bit_ceil(capacity) : 0, T{});
+        m_mask = m_buffer.empty() ? 0 : m_buffer.size() - 1;
+        clear();
+    }
+
+    void clear()
+    {
+        m_readPos.store(0, std::memory_order_relaxed);
+        m_writePos.store(0, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] size_t capacity() const
+    {
+        return m_buffer.size();
+    }
+
+    [[nodiscard]] size_t readAvailable() const
+    {
+        return m_writePos.load(std::memory_order_acquire) - m_readPos.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] size_t writeAvailable() const
+    {
+        return capacity() - (m_writePos.load(std::memory_order_relaxed) - m_readPos.load(std::memory_order_acquire));
+    }
+
+    //! Copies up to @p data.size() items into the buffer, returning the number written
+    size_t write(std::span<const T> data)
+    {
+        const size_t writePos = m_writePos.load(std::memory_order_relaxed);
+        const size_t count
+            = std::min(data.size(), capacity() - (writePos - m_readPos.load(std::memory_order_acquire)));
+
+        const size_t start = index(writePos);
+        const size_t first = std::min(count, capacity() - start);
+        std::copy_n(data.data(), first, m_buffer.data() + start);
+        std::copy_n(data.data() + first, count - first, m_buffer.data());
+
+        m_writePos.store(writePos + count, std::memory_order_release);
+
+        return count;
+    }
+
+    //! Copies up to @p data.size() items out of the buffer, returning the number read
+    size_t read(std::span<T> data)
+    {
+        const size_t readPos = m_readPos.load(std::memory_order_relaxed);
+        const size_t count   = std::min(data.size(), m_writePos.load(std::memory_order_acquire) - readPos);
+
+        const size_t start = index(readPos);
+        const size_t first = std::min(count, capacity() - start);
+        std::copy_n(m_buffer.data() + start, first, data.data());
+        std::copy_n(m_buffer.data(), count - first, data.data() + first);
+
+        m_readPos.store(readPos + count, std::memory_order_release);
+
+        return count;
+    }
+
+    //! Discards up to @p count items, returning the number discarded
+    size_t skip(size_t count)
+    {
+        const size_t readPos = m_readPos.load(std::memory_order_relaxed);
+        count                = std::min(count, m_writePos.load(std::memory_order_acquire) - readPos);
+
+        m_readPos.store(readPos + count, std::memory_order_release);
+
+        return count;
+    }
+
+private:
+    // Positions only ever increase, so wrap them into the buffer here
+    [[nodiscard]] size_t index(size_t pos) const
+    {
+        return pos & m_mask;
+    }
+
+    std::vector<T> m_buffer;
+    size_t m_mask{0};
+
+    // Kept on separate cache lines so the two threads don't contend
+    alignas(64) std::atomic<size_t> m_readPos{0};
+    alignas(64) std::atomic<size_t> m_writePos{0};
+};
+} // namespace Fooyin
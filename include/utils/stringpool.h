@@ -0,0 +1,63 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fyutils_export.h"
+
+#include <QStringList>
+
+namespace Fooyin {
+/*!
+ * A thread-safe pool of shared strings.
+ *
+ * Interning a string returns the pool's copy of an equal string, so that repeated
+ * values (artists, genres etc.) share a single allocation however many tracks hold them.
+ * Two strings returned by the pool are equal only if they share the same data.
+ * Entries live for the lifetime of the process.
+ */
+class FYUTILS_EXPORT StringPool
+{
+public:
+    struct Stats
+    {
+        //! Number of distinct strings and lists held
+        size_t strings{0};
+        size_t lists{0};
+        //! Bytes of character data held by the pool
+        size_t bytes{0};
+    };
+
+    static StringPool& instance();
+
+    //! Returns the pooled copy of @p str, adding it if not already pooled
+    QString intern(const QString& str);
+    //! Returns the pooled copy of @p list, with each of its strings also interned
+    QStringList intern(const QStringList& list);
+
+    [[nodiscard]] Stats stats() const;
+
+private:
+    StringPool();
+    ~StringPool();
+
+    struct Private;
+    std::unique_ptr<Private> p;
+};
+} // namespace Fooyin
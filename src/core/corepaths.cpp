@@ -33,6 +33,11 @@ QString settingsPath()
     return QDir::cleanPath(Utils::configPath().append(QStringLiteral("/fooyin.conf")));
 }
 
+QString librarySnapshotPath()
+{
+    return QDir::cleanPath(Utils::sharePath().append(QStringLiteral("/library.snapshot")));
+}
+
 QStringList pluginPaths()
 {
     QStringList paths;
@@ -25,6 +25,7 @@
 
 namespace Fooyin::Core {
 FYCORE_EXPORT QString settingsPath();
+FYCORE_EXPORT QString librarySnapshotPath();
 FYCORE_EXPORT QStringList pluginPaths();
 FYCORE_EXPORT QString userPluginsPath();
 FYCORE_EXPORT QString translationsPath();
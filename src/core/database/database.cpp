@@ -28,15 +28,21 @@
 
 #include <QFileInfo>
 
-const auto CurrentSchemaVersion = 3;
+const auto CurrentSchemaVersion = 5;
 
 namespace {
-Fooyin::DbConnection::DbParams dbConnectionParams()
+Fooyin::DbConnection::DbParams dbConnectionParams(const QString& dbFilepath)
 {
     Fooyin::DbConnection::DbParams params;
     params.type           = QStringLiteral("QSQLITE");
     params.connectOptions = QStringLiteral("QSQLITE_OPEN_URI");
-    params.filePath       = Fooyin::Utils::sharePath() + QStringLiteral("/fooyin.db");
+    params.filePath       = dbFilepath;
+
+    // WAL lets readers on other threads continue while a scan is writing
+    params.pragmas = {{QStringLiteral("journal_mode"), QStringLiteral("WAL")},
+                      {QStringLiteral("synchronous"), QStringLiteral("NORMAL")},
+                      {QStringLiteral("mmap_size"), QStringLiteral("268435456")},
+                      {QStringLiteral("cache_size"), QStringLiteral("-16384")}};
 
     return params;
 }
@@ -44,8 +50,12 @@ Fooyin::DbConnection::DbParams dbConnectionParams()
 
 namespace Fooyin {
 Database::Database(QObject* parent)
+    : Database{Utils::sharePath() + QStringLiteral("/fooyin.db"), parent}
+{ }
+
+Database::Database(const QString& dbFilepath, QObject* parent)
     : QObject{parent}
-    , m_dbPool(DbConnectionPool::create(dbConnectionParams(), QStringLiteral("fooyin")))
+    , m_dbPool(DbConnectionPool::create(dbConnectionParams(dbFilepath), QStringLiteral("fooyin")))
     , m_connectionHandler{m_dbPool}
     , m_status{Status::Ok}
 {
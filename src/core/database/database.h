@@ -19,13 +19,15 @@
 
 #pragma once
 
+#include "fycore_export.h"
+
 #include <utils/database/dbconnectionhandler.h>
 #include <utils/database/dbconnectionpool.h>
 
 #include <QObject>
 
 namespace Fooyin {
-class Database : public QObject
+class FYCORE_EXPORT Database : public QObject
 {
     Q_OBJECT
 
@@ -40,6 +42,7 @@ public:
     };
 
     explicit Database(QObject* parent = nullptr);
+    explicit Database(const QString& dbFilepath, QObject* parent = nullptr);
 
     [[nodiscard]] DbConnectionPoolPtr connectionPool() const;
 
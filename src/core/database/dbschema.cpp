@@ -52,6 +52,36 @@ int readSchemaVersion(const Fooyin::SettingsDatabase& settings, const QString& k
 
     return schemaVersion;
 }
+
+QStringList splitStatements(const QString& sql)
+{
+    QStringList statements;
+    QString trigger;
+
+    const QStringList parts = sql.split(QStringLiteral(";"));
+    for(const QString& part : parts) {
+        const QString simplified = part.simplified();
+
+        // Trigger bodies contain their own statements, so keep everything up to the closing END together
+        if(!trigger.isEmpty() || simplified.startsWith(u"CREATE TRIGGER", Qt::CaseInsensitive)) {
+            trigger.append(part + u';');
+            if(simplified.compare(u"END", Qt::CaseInsensitive) == 0) {
+                trigger.chop(1);
+                statements.append(trigger);
+                trigger.clear();
+            }
+            continue;
+        }
+
+        statements.append(part);
+    }
+
+    if(!trigger.isEmpty()) {
+        statements.append(trigger);
+    }
+
+    return statements;
+}
 } // namespace
 
 namespace Fooyin {
@@ -253,7 +283,7 @@ DbSchema::UpgradeResult DbSchema::applyRevision(int currentRevision, int revisio
 
     DbTransaction transaction{db()};
 
-    const QStringList statements = revision.sql.split(QStringLiteral(";"));
+    const QStringList statements = splitStatements(revision.sql);
 
     bool result{false};
 
@@ -27,7 +27,7 @@
 
 #include <QFileInfo>
 
-using BindingsMap = std::map<QString, QVariant>;
+#include <unordered_set>
 
 namespace {
 QString fetchTrackColumns()
@@ -66,34 +66,96 @@ QString fetchTrackColumns()
     return columns;
 }
 
-BindingsMap trackBindings(const Fooyin::Track& track)
+// Column order shared by the insert and update statements
+QString trackColumns()
 {
-    return {{QStringLiteral(":filePath"), Fooyin::Utils::File::cleanPath(track.filepath())},
-            {QStringLiteral(":title"), track.title()},
-            {QStringLiteral(":trackNumber"), track.trackNumber()},
-            {QStringLiteral(":trackTotal"), track.trackTotal()},
-            {QStringLiteral(":artists"), track.artists()},
-            {QStringLiteral(":albumArtist"), track.albumArtists()},
-            {QStringLiteral(":album"), track.album()},
-            {QStringLiteral(":discNumber"), track.discNumber()},
-            {QStringLiteral(":discTotal"), track.discTotal()},
-            {QStringLiteral(":date"), track.date()},
-            {QStringLiteral(":composer"), track.composer()},
-            {QStringLiteral(":performer"), track.performer()},
-            {QStringLiteral(":genres"), track.genres()},
-            {QStringLiteral(":comment"), track.comment()},
-            {QStringLiteral(":duration"), QVariant::fromValue(track.duration())},
-            {QStringLiteral(":fileSize"), QVariant::fromValue(track.fileSize())},
-            {QStringLiteral(":bitRate"), track.bitrate()},
-            {QStringLiteral(":sampleRate"), track.sampleRate()},
-            {QStringLiteral(":extraTags"), track.serialiseExtrasTags()},
-            {QStringLiteral(":type"), static_cast<int>(track.type())},
-            {QStringLiteral(":modifiedDate"), QVariant::fromValue(track.modifiedTime())},
-            {QStringLiteral(":trackHash"), track.hash()},
-            {QStringLiteral(":libraryID"), track.libraryId()}};
+    static const QString columns = QStringLiteral("FilePath,"
+                                                  "Title,"
+                                                  "TrackNumber,"
+                                                  "TrackTotal,"
+                                                  "Artists,"
+                                                  "AlbumArtist,"
+                                                  "Album,"
+                                                  "DiscNumber,"
+                                                  "DiscTotal,"
+                                                  "Date,"
+                                                  "Composer,"
+                                                  "Performer,"
+                                                  "Genres,"
+                                                  "Comment,"
+                                                  "Duration,"
+                                                  "FileSize,"
+                                                  "BitRate,"
+                                                  "SampleRate,"
+                                                  "ExtraTags,"
+                                                  "Type,"
+                                                  "ModifiedDate,"
+                                                  "TrackHash,"
+                                                  "LibraryID");
+    return columns;
+}
+
+QString insertTrackStatement()
+{
+    static const QString statement = [] {
+        const QString columns = trackColumns();
+        const auto count      = columns.count(u',') + 1;
+
+        QStringList placeholders;
+        placeholders.fill(QStringLiteral("?"), count);
+
+        return QStringLiteral("INSERT INTO Tracks (%1) VALUES (%2);").arg(columns, placeholders.join(u','));
+    }();
+    return statement;
+}
+
+QString updateTrackStatement()
+{
+    static const QString statement = [] {
+        QStringList assignments = trackColumns().split(u',');
+        for(QString& column : assignments) {
+            column.append(QStringLiteral(" = ?"));
+        }
+
+        return QStringLiteral("UPDATE Tracks SET %1 WHERE TrackID = ?;").arg(assignments.join(u','));
+    }();
+    return statement;
+}
+
+// Binds the values for trackColumns in order, returning the next position
+int bindTrack(Fooyin::DbQuery& query, const Fooyin::Track& track)
+{
+    int pos{0};
+
+    query.bindValue(pos++, Fooyin::Utils::File::cleanPath(track.filepath()));
+    query.bindValue(pos++, track.title());
+    query.bindValue(pos++, track.trackNumber());
+    query.bindValue(pos++, track.trackTotal());
+    query.bindValue(pos++, track.artists());
+    query.bindValue(pos++, track.albumArtists());
+    query.bindValue(pos++, track.album());
+    query.bindValue(pos++, track.discNumber());
+    query.bindValue(pos++, track.discTotal());
+    query.bindValue(pos++, track.date());
+    query.bindValue(pos++, track.composer());
+    query.bindValue(pos++, track.performer());
+    query.bindValue(pos++, track.genres());
+    query.bindValue(pos++, track.comment());
+    query.bindValue(pos++, QVariant::fromValue(track.duration()));
+    query.bindValue(pos++, QVariant::fromValue(track.fileSize()));
+    query.bindValue(pos++, track.bitrate());
+    query.bindValue(pos++, track.sampleRate());
+    query.bindValue(pos++, track.serialiseExtrasTags());
+    query.bindValue(pos++, static_cast<int>(track.type()));
+    query.bindValue(pos++, QVariant::fromValue(track.modifiedTime()));
+    query.bindValue(pos++, track.hash());
+    query.bindValue(pos++, track.libraryId());
+
+    return pos;
 }
 
-Fooyin::Track readToTrack(const Fooyin::DbQuery& q)
+// Existence checks stat every file, so loading the whole library defers them to a background pass
+Fooyin::Track readToTrack(const Fooyin::DbQuery& q, bool checkExists = true)
 {
     Fooyin::Track track;
 
@@ -127,8 +189,13 @@ Fooyin::Track readToTrack(const Fooyin::DbQuery& q)
     track.setLastPlayed(q.value(27).toULongLong());
     track.setPlayCount(q.value(28).toInt());
 
-    track.generateHash();
-    track.setIsEnabled(QFileInfo::exists(track.filepath()));
+    // The stored hash is kept in sync on write, so it only needs generating for rows which predate it
+    if(track.hash().isEmpty()) {
+        track.generateHash();
+    }
+    if(checkExists) {
+        track.setIsEnabled(QFileInfo::exists(track.filepath()));
+    }
 
     return track;
 }
@@ -147,6 +214,7 @@ bool TrackDatabase::storeTracks(TrackList& tracks)
         return false;
     }
 
+    // Both statements are prepared once and reused for every track in the batch
     for(auto& track : tracks) {
         if(track.id() >= 0) {
             updateTrack(track);
@@ -223,7 +291,7 @@ TrackList TrackDatabase::getAllTracks() const
     }
 
     while(q.next()) {
-        tracks.emplace_back(readToTrack(q));
+        tracks.emplace_back(readToTrack(q, false));
     }
 
     return tracks;
@@ -251,6 +319,120 @@ TrackList TrackDatabase::tracksByHash(const QString& hash) const
     return tracks;
 }
 
+uint64_t TrackDatabase::generation() const
+{
+    const auto statement = QStringLiteral("SELECT Value FROM Settings WHERE Name = 'TrackGeneration';");
+
+    DbQuery query{db(), statement};
+
+    if(!query.exec() || !query.next()) {
+        return 0;
+    }
+
+    return query.value(0).toULongLong();
+}
+
+FileStatMap TrackDatabase::fileStats(const TrackIds& ids) const
+{
+    if(ids.empty()) {
+        return {};
+    }
+
+    // Stored as signed 64-bit integers, so cast back rather than converting
+    const auto readStat = [](const DbQuery& query, int column) {
+        return FileStat{.inode      = static_cast<uint64_t>(query.value(column).toLongLong()),
+                        .size       = static_cast<uint64_t>(query.value(column + 1).toLongLong()),
+                        .modifiedNs = query.value(column + 2).toLongLong()};
+    };
+
+    FileStatMap stats;
+    stats.reserve(ids.size());
+
+    {
+        DbQuery countQuery{db(), QStringLiteral("SELECT COUNT(*) FROM FileStats;")};
+        if(!countQuery.exec() || !countQuery.next()) {
+            return {};
+        }
+
+        // Reading the whole table in one pass is much quicker than a lookup per track when most of it is wanted
+        if(ids.size() >= countQuery.value(0).toULongLong() / 2) {
+            const std::unordered_set<int> wantedIds{ids.cbegin(), ids.cend()};
+
+            DbQuery query{db(), QStringLiteral("SELECT TrackID, Inode, Size, ModifiedNs FROM FileStats;")};
+            if(!query.exec()) {
+                return {};
+            }
+
+            while(query.next()) {
+                const int id = query.value(0).toInt();
+                if(wantedIds.contains(id)) {
+                    stats.emplace(id, readStat(query, 1));
+                }
+            }
+
+            return stats;
+        }
+    }
+
+    const auto statement = QStringLiteral("SELECT Inode, Size, ModifiedNs FROM FileStats WHERE TrackID = ?;");
+
+    DbQuery* query = cachedQuery(statement);
+    if(!query) {
+        return {};
+    }
+
+    for(const int id : ids) {
+        query->bindValue(0, id);
+
+        if(!query->exec()) {
+            return {};
+        }
+
+        if(query->next()) {
+            stats.emplace(id, readStat(*query, 0));
+        }
+    }
+
+    // Don't keep the read open while the query sits in the cache
+    query->finish();
+
+    return stats;
+}
+
+bool TrackDatabase::storeFileStats(const FileStatMap& stats)
+{
+    if(stats.empty()) {
+        return true;
+    }
+
+    DbTransaction transaction{db()};
+
+    if(!transaction) {
+        return false;
+    }
+
+    const auto statement = QStringLiteral(
+        "INSERT OR REPLACE INTO FileStats (TrackID, Inode, Size, ModifiedNs) VALUES (?, ?, ?, ?);");
+
+    DbQuery* query = cachedQuery(statement);
+    if(!query) {
+        return false;
+    }
+
+    for(const auto& [id, stat] : stats) {
+        query->bindValue(0, id);
+        query->bindValue(1, static_cast<qint64>(stat.inode));
+        query->bindValue(2, static_cast<qint64>(stat.size));
+        query->bindValue(3, static_cast<qint64>(stat.modifiedNs));
+
+        if(!query->exec()) {
+            return false;
+        }
+    }
+
+    return transaction.commit();
+}
+
 bool TrackDatabase::updateTrack(const Track& track)
 {
     if(track.id() < 0) {
@@ -258,42 +440,36 @@ bool TrackDatabase::updateTrack(const Track& track)
         return false;
     }
 
-    const auto statement = QStringLiteral("UPDATE TRACKS SET "
-                                          "FilePath = :filePath,"
-                                          "Title = :title, "
-                                          "TrackNumber = :trackNumber,"
-                                          "TrackTotal = :trackTotal,"
-                                          "Artists = :artists,"
-                                          "AlbumArtist = :albumArtist,"
-                                          "Album = :album,"
-                                          "DiscNumber = :discNumber,"
-                                          "DiscTotal = :discTotal,"
-                                          "Date = :date,"
-                                          "Composer = :composer,"
-                                          "Performer = :performer,"
-                                          "Genres = :genres,"
-                                          "Comment = :comment,"
-                                          "Duration = :duration,"
-                                          "FileSize = :fileSize,"
-                                          "BitRate = :bitRate,"
-                                          "SampleRate = :sampleRate,"
-                                          "ExtraTags = :extraTags,"
-                                          "Type = :type,"
-                                          "ModifiedDate = :modifiedDate,"
-                                          "TrackHash = :trackHash,"
-                                          "LibraryID = :libraryID"
-                                          " WHERE TrackID = :trackId;");
+    DbQuery* query = cachedQuery(updateTrackStatement());
+    if(!query) {
+        return false;
+    }
+
+    const int idPos = bindTrack(*query, track);
+    query->bindValue(idPos, track.id());
 
-    DbQuery query{db(), statement};
+    return query->exec();
+}
 
-    query.bindValue(QStringLiteral(":trackId"), track.id());
+bool TrackDatabase::updateTracks(const TrackList& tracks)
+{
+    if(tracks.empty()) {
+        return true;
+    }
 
-    const auto bindings = trackBindings(track);
-    for(const auto& [name, value] : bindings) {
-        query.bindValue(name, value);
+    DbTransaction transaction{db()};
+
+    if(!transaction) {
+        return false;
     }
 
-    return query.exec();
+    for(const Track& track : tracks) {
+        if(!updateTrack(track)) {
+            return false;
+        }
+    }
+
+    return transaction.commit();
 }
 
 bool TrackDatabase::updateTrackStats(const TrackList& tracks)
@@ -468,69 +644,18 @@ int TrackDatabase::trackCount() const
 
 bool TrackDatabase::insertTrack(Track& track) const
 {
-    const auto statement = QStringLiteral("INSERT INTO Tracks ("
-                                          "FilePath,"
-                                          "Title,"
-                                          "TrackNumber,"
-                                          "TrackTotal,"
-                                          "Artists,"
-                                          "AlbumArtist,"
-                                          "Album,"
-                                          "DiscNumber,"
-                                          "DiscTotal,"
-                                          "Date,"
-                                          "Composer,"
-                                          "Performer,"
-                                          "Genres,"
-                                          "Comment,"
-                                          "Duration,"
-                                          "FileSize,"
-                                          "BitRate,"
-                                          "SampleRate,"
-                                          "ExtraTags,"
-                                          "Type,"
-                                          "ModifiedDate,"
-                                          "TrackHash,"
-                                          "LibraryID"
-                                          ") "
-                                          "VALUES ("
-                                          ":filePath,"
-                                          ":title, "
-                                          ":trackNumber,"
-                                          ":trackTotal,"
-                                          ":artists,"
-                                          ":albumArtist,"
-                                          ":album,"
-                                          ":discNumber,"
-                                          ":discTotal,"
-                                          ":date, "
-                                          ":composer,"
-                                          ":performer,"
-                                          ":genres,"
-                                          ":comment,"
-                                          ":duration,"
-                                          ":fileSize,"
-                                          ":bitRate,"
-                                          ":sampleRate,"
-                                          ":extraTags, "
-                                          ":type,"
-                                          ":modifiedDate,"
-                                          ":trackHash,"
-                                          ":libraryID"
-                                          ");");
-
-    DbQuery query{db(), statement};
-
-    const auto bindings = trackBindings(track);
-    for(const auto& [name, value] : bindings) {
-        query.bindValue(name, value);
+    DbQuery* query = cachedQuery(insertTrackStatement());
+    if(!query) {
+        return false;
     }
 
-    if(!query.exec()) {
+    bindTrack(*query, track);
+
+    if(!query->exec()) {
         return false;
     }
 
-    track.setId(query.lastInsertId().toInt());
+    track.setId(query->lastInsertId().toInt());
 
     return insertOrUpdateStats(track);
 }
@@ -551,20 +676,26 @@ bool TrackDatabase::insertOrUpdateStats(const Track& track) const
         const auto statement = QStringLiteral("SELECT AddedDate, FirstPlayed, LastPlayed, PlayCount, Rating FROM "
                                               "TrackStats WHERE TrackHash = :trackHash;");
 
-        DbQuery query{db(), statement};
+        DbQuery* query = cachedQuery(statement);
+        if(!query) {
+            return false;
+        }
 
-        query.bindValue(QStringLiteral(":trackHash"), track.hash());
+        query->bindValue(QStringLiteral(":trackHash"), track.hash());
 
-        if(!query.exec()) {
+        if(!query->exec()) {
             return false;
         }
 
-        if(query.next()) {
-            added       = query.value(0).toULongLong();
-            firstPlayed = query.value(1).toULongLong();
-            lastPlayed  = query.value(2).toULongLong();
-            playCount   = query.value(3).toInt();
+        if(query->next()) {
+            added       = query->value(0).toULongLong();
+            firstPlayed = query->value(1).toULongLong();
+            lastPlayed  = query->value(2).toULongLong();
+            playCount   = query->value(3).toInt();
         }
+
+        // Don't keep the read open while the query sits in the cache
+        query->finish();
     }
 
     bool dbNeedsUpdate{false};
@@ -607,15 +738,18 @@ bool TrackDatabase::insertOrUpdateStats(const Track& track) const
         "INSERT OR REPLACE INTO TrackStats (TrackHash, AddedDate, FirstPlayed, LastPlayed, PlayCount) VALUES "
         "(:trackHash, :addedDate, :firstPlayed, :lastPlayed, :playCount);");
 
-    DbQuery query{db(), statement};
+    DbQuery* query = cachedQuery(statement);
+    if(!query) {
+        return false;
+    }
 
-    query.bindValue(QStringLiteral(":trackHash"), track.hash());
-    query.bindValue(QStringLiteral(":addedDate"), QVariant::fromValue(added));
-    query.bindValue(QStringLiteral(":firstPlayed"), QVariant::fromValue(firstPlayed));
-    query.bindValue(QStringLiteral(":lastPlayed"), QVariant::fromValue(lastPlayed));
-    query.bindValue(QStringLiteral(":playCount"), playCount);
+    query->bindValue(QStringLiteral(":trackHash"), track.hash());
+    query->bindValue(QStringLiteral(":addedDate"), QVariant::fromValue(added));
+    query->bindValue(QStringLiteral(":firstPlayed"), QVariant::fromValue(firstPlayed));
+    query->bindValue(QStringLiteral(":lastPlayed"), QVariant::fromValue(lastPlayed));
+    query->bindValue(QStringLiteral(":playCount"), playCount);
 
-    return query.exec();
+    return query->exec();
 }
 
 void TrackDatabase::removeUnmanagedTracks() const
@@ -19,23 +19,48 @@
 
 #pragma once
 
-#include <core/trackfwd.h>
+#include "fycore_export.h"
+
+#include <core/track.h>
 #include <utils/database/dbmodule.h>
 
 #include <set>
+#include <unordered_map>
 
 namespace Fooyin {
-class TrackDatabase : public DbModule
+// What a track's file looked like when its tags were last read
+struct FileStat
+{
+    uint64_t inode{0};
+    uint64_t size{0};
+    int64_t modifiedNs{0};
+
+    bool operator==(const FileStat& other) const = default;
+};
+// Keyed by track id
+using FileStatMap = std::unordered_map<int, FileStat>;
+
+class FYCORE_EXPORT TrackDatabase : public DbModule
 {
 public:
     bool storeTracks(TrackList& tracksToStore);
 
     bool reloadTrack(Track& track) const;
     bool reloadTracks(TrackList& tracks) const;
+    // Tracks are returned enabled; missing files are picked up later by TrackDatabaseManager::verifyTracks
     [[nodiscard]] TrackList getAllTracks() const;
     [[nodiscard]] TrackList tracksByHash(const QString& hash) const;
 
+    // Changes whenever tracks, their stats or libraries are written; maintained by triggers
+    [[nodiscard]] uint64_t generation() const;
+
+    //! Returns the cached attributes of the tracks with @p ids
+    [[nodiscard]] FileStatMap fileStats(const TrackIds& ids) const;
+    bool storeFileStats(const FileStatMap& stats);
+
     bool updateTrack(const Track& track);
+    // Updates all @p tracks in a single transaction; nothing is written if any update fails
+    bool updateTracks(const TrackList& tracks);
     bool updateTrackStats(const TrackList& track);
 
     bool deleteTrack(int id);
@@ -24,6 +24,21 @@
 #include <ranges>
 #include <utility>
 
+namespace {
+template <typename T>
+void adjustVolume(std::span<std::byte> data, int bps, const double volume)
+{
+    const auto bytes = static_cast<int>(data.size());
+
+    for(int i{0}; i < bytes; i += bps) {
+        T sample;
+        std::memcpy(&sample, data.data() + i, bps);
+        sample *= volume;
+        std::memcpy(data.data() + i, &sample, bps);
+    }
+}
+} // namespace
+
 namespace Fooyin {
 struct AudioBuffer::Private : QSharedData
 {
@@ -58,20 +73,6 @@ struct AudioBuffer::Private : QSharedData
         std::fill(buffer.begin() + buffer.size(), buffer.begin() + buffer.capacity(),
                   unsignedFormat ? std::byte{0x80} : std::byte{0});
     }
-
-    template <typename T>
-    void adjustVolume(const double volume)
-    {
-        const auto bytes = static_cast<int>(buffer.size());
-        const int bps    = format.bytesPerSample();
-
-        for(int i{0}; i < bytes; i += bps) {
-            T sample;
-            std::memcpy(&sample, buffer.data() + i, bps);
-            sample *= volume;
-            std::memcpy(buffer.data() + i, &sample, bps);
-        }
-    }
 };
 
 AudioBuffer::AudioBuffer() = default;
@@ -239,19 +240,34 @@ void AudioBuffer::adjustVolumeOfSamples(double volume)
         return;
     }
 
-    switch(format().sampleFormat()) {
+    adjustVolumeOfSamples(p->buffer, format(), volume);
+}
+
+void AudioBuffer::adjustVolumeOfSamples(std::span<std::byte> data, const AudioFormat& format, double volume)
+{
+    if(volume == 1.0) {
+        return;
+    }
+
+    const int bps = format.bytesPerSample();
+
+    switch(format.sampleFormat()) {
         case(SampleFormat::U8):
-            p->adjustVolume<uint8_t>(volume);
+            if(volume == 0.0) {
+                std::ranges::fill(data, std::byte{0x80});
+                break;
+            }
+            adjustVolume<uint8_t>(data, bps, volume);
             break;
         case(SampleFormat::S16):
-            p->adjustVolume<int16_t>(volume);
+            adjustVolume<int16_t>(data, bps, volume);
             break;
         case(SampleFormat::S24):
         case(SampleFormat::S32):
-            p->adjustVolume<int32_t>(volume);
+            adjustVolume<int32_t>(data, bps, volume);
             break;
         case(SampleFormat::Float):
-            p->adjustVolume<float>(volume);
+            adjustVolume<float>(data, bps, volume);
             break;
         case(SampleFormat::Unknown):
         default:
@@ -0,0 +1,113 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "audiodecodethread.h"
+
+#include <core/engine/audiodecoder.h>
+
+using namespace std::chrono_literals;
+
+namespace {
+// How long to wait for the renderer to make room once the buffer is full
+constexpr auto FullBufferWait = 10ms;
+} // namespace
+
+namespace Fooyin {
+AudioDecodeThread::AudioDecodeThread(AudioDecoder* decoder, RingBuffer<std::byte>* buffer, QObject* parent)
+    : QObject{parent}
+    , m_decoder{decoder}
+    , m_buffer{buffer}
+    , m_thread{[this]() { run(); }}
+{ }
+
+AudioDecodeThread::~AudioDecodeThread()
+{
+    {
+        const std::scoped_lock lock{m_mutex};
+        m_quit = true;
+    }
+    m_cv.notify_all();
+    m_thread.join();
+}
+
+void AudioDecodeThread::start()
+{
+    {
+        const std::scoped_lock lock{m_mutex};
+        m_decoder->start();
+        m_active = true;
+        m_atEnd  = false;
+    }
+    m_cv.notify_all();
+}
+
+void AudioDecodeThread::stop()
+{
+    // The decode loop checks this between reads and then waits, releasing the lock
+    m_active = false;
+    m_cv.notify_all();
+
+    const std::scoped_lock lock{m_mutex};
+
+    m_atEnd = false;
+    m_pending.reset();
+    m_pendingOffset = 0;
+}
+
+bool AudioDecodeThread::atEnd() const
+{
+    return m_atEnd;
+}
+
+void AudioDecodeThread::run()
+{
+    std::unique_lock lock{m_mutex};
+
+    while(!m_quit) {
+        if(!m_active) {
+            m_cv.wait(lock, [this]() { return m_quit || m_active; });
+            continue;
+        }
+
+        if(!m_pending.isValid()) {
+            m_pending       = m_decoder->readBuffer();
+            m_pendingOffset = 0;
+
+            if(!m_pending.isValid()) {
+                m_active = false;
+                m_atEnd  = true;
+                emit finished();
+                continue;
+            }
+        }
+
+        m_pendingOffset += m_buffer->write(m_pending.constData().subspan(m_pendingOffset));
+
+        if(m_pendingOffset >= static_cast<size_t>(m_pending.byteCount())) {
+            m_pending.reset();
+            continue;
+        }
+
+        // The buffer is full, so give the renderer a chance to drain it
+        m_cv.wait_for(lock, FullBufferWait);
+    }
+}
+} // namespace Fooyin
+
+#include "moc_audiodecodethread.cpp"
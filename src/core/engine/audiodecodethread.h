@@ -0,0 +1,75 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <core/engine/audiobuffer.h>
+#include <utils/ringbuffer.h>
+
+#include <QObject>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace Fooyin {
+class AudioDecoder;
+
+/*!
+ * Decodes on a dedicated thread into a ring buffer of PCM data, topping it up
+ * as the renderer drains it.
+ */
+class AudioDecodeThread : public QObject
+{
+    Q_OBJECT
+
+public:
+    AudioDecodeThread(AudioDecoder* decoder, RingBuffer<std::byte>* buffer, QObject* parent = nullptr);
+    ~AudioDecodeThread() override;
+
+    //! Starts the decoder and begins filling the buffer
+    void start();
+    //! Returns once the thread is no longer using the decoder or buffer
+    void stop();
+
+    [[nodiscard]] bool atEnd() const;
+
+signals:
+    //! Emitted from the decode thread once the decoder has no more data
+    void finished();
+
+private:
+    void run();
+
+    AudioDecoder* m_decoder;
+    RingBuffer<std::byte>* m_buffer;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_quit{false};
+    std::atomic<bool> m_active{false};
+    std::atomic<bool> m_atEnd{false};
+
+    AudioBuffer m_pending;
+    size_t m_pendingOffset{0};
+
+    std::thread m_thread;
+};
+} // namespace Fooyin
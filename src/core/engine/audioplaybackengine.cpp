@@ -20,6 +20,7 @@
 #include "audioplaybackengine.h"
 
 #include "audioclock.h"
+#include "audiodecodethread.h"
 #include "audiorenderer.h"
 #include "engine/ffmpeg/ffmpegdecoder.h"
 
@@ -28,6 +29,7 @@
 #include <core/engine/audiodecoder.h>
 #include <core/engine/audiooutput.h>
 #include <core/track.h>
+#include <utils/ringbuffer.h>
 #include <utils/settings/settingsmanager.h>
 
 #include <QTimer>
@@ -48,38 +50,36 @@ struct AudioPlaybackEngine::Private
     PlaybackState state{StoppedState};
     uint64_t lastPosition{0};
 
-    uint64_t totalBufferTime{0};
     uint64_t bufferLength{0};
+    uint64_t startPosition{0};
 
     uint64_t duration{0};
     double volume{1.0};
 
     AudioFormat format;
 
+    // Declared in this order so the threads are joined before the decoder and buffer are destroyed
     std::unique_ptr<AudioDecoder> decoder;
-    AudioRenderer* renderer;
-
-    QTimer* bufferTimer;
+    RingBuffer<std::byte> buffer;
+    std::unique_ptr<AudioDecodeThread> decodeThread;
+    std::unique_ptr<AudioRenderer> renderer;
 
     explicit Private(AudioEngine* self_, SettingsManager* settings_)
         : self{self_}
         , settings{settings_}
         , bufferLength{static_cast<uint64_t>(settings->value<Settings::Core::BufferLength>())}
         , decoder{std::make_unique<FFmpegDecoder>()}
-        , renderer{new AudioRenderer(self)}
-        , bufferTimer{new QTimer(self)}
+        , decodeThread{std::make_unique<AudioDecodeThread>(decoder.get(), &buffer, self)}
+        , renderer{std::make_unique<AudioRenderer>(&buffer, decodeThread.get(), self)}
     {
-        bufferTimer->setInterval(15ms);
-
         settings->subscribe<Settings::Core::BufferLength>(self, [this](int length) { bufferLength = length; });
 
-        QObject::connect(renderer, &AudioRenderer::bufferProcessed, self, [this](const AudioBuffer& buffer) {
-            totalBufferTime -= buffer.duration();
-            clock.sync(buffer.startTime());
+        QObject::connect(decodeThread.get(), &AudioDecodeThread::finished, self, [this]() {
+            if(decodeThread->atEnd()) {
+                emit self->trackAboutToFinish();
+            }
         });
-        QObject::connect(renderer, &AudioRenderer::finished, self, [this]() { onRendererFinished(); });
-
-        QObject::connect(bufferTimer, &QTimer::timeout, self, [this]() { readNextBuffer(); });
+        QObject::connect(renderer.get(), &AudioRenderer::finished, self, [this]() { onRendererFinished(); });
     }
 
     QTimer* positionTimer()
@@ -93,24 +93,6 @@ struct AudioPlaybackEngine::Private
         return positionUpdateTimer;
     }
 
-    void readNextBuffer()
-    {
-        if(totalBufferTime >= bufferLength) {
-            return;
-        }
-
-        const auto buffer = decoder->readBuffer();
-        if(buffer.isValid()) {
-            totalBufferTime += buffer.duration();
-            renderer->queueBuffer(buffer);
-        }
-        else {
-            bufferTimer->stop();
-            renderer->queueBuffer({});
-            QMetaObject::invokeMethod(self, &AudioEngine::trackAboutToFinish);
-        }
-    }
-
     PlaybackState changeState(PlaybackState newState)
     {
         auto prevState = std::exchange(state, newState);
@@ -131,6 +113,10 @@ struct AudioPlaybackEngine::Private
 
     void updatePosition()
     {
+        if(status != EndOfTrack && format.sampleRate() > 0) {
+            clock.sync(startPosition + renderer->framesWritten() * 1000 / static_cast<uint64_t>(format.sampleRate()));
+        }
+
         if(std::exchange(lastPosition, clock.currentPosition()) != lastPosition) {
             emit self->positionChanged(lastPosition);
         }
@@ -140,6 +126,9 @@ struct AudioPlaybackEngine::Private
     {
         const auto prevFormat = std::exchange(format, nextFormat);
 
+        // Only called while the workers are stopped, so the buffer can safely be reallocated
+        buffer.resize(static_cast<size_t>(format.bytesForDuration(bufferLength)));
+
         if(settings->value<Settings::Core::GaplessPlayback>() && prevFormat == format
            && state != PlaybackState::PausedState) {
             return true;
@@ -155,8 +144,7 @@ struct AudioPlaybackEngine::Private
 
     void startPlayback() const
     {
-        decoder->start();
-        bufferTimer->start();
+        decodeThread->start();
         renderer->start();
     }
 
@@ -170,31 +158,24 @@ struct AudioPlaybackEngine::Private
 
     void pauseOutput(bool pause) const
     {
-        if(pause) {
-            bufferTimer->stop();
-        }
-        else {
-            bufferTimer->start();
-        }
-
         renderer->pause(pause);
     }
 
     void resetWorkers()
     {
-        bufferTimer->stop();
         clock.setPaused(true);
         renderer->reset();
-        totalBufferTime = 0;
+        decodeThread->stop();
+        buffer.clear();
     }
 
     void stopWorkers()
     {
-        bufferTimer->stop();
         clock.setPaused(true);
         renderer->stop();
+        decodeThread->stop();
         decoder->stop();
-        totalBufferTime = 0;
+        buffer.clear();
     }
 };
 
@@ -222,10 +203,11 @@ void AudioPlaybackEngine::seek(uint64_t pos)
 
     p->decoder->seek(pos);
     p->clock.sync(pos);
+    p->startPosition = pos;
 
     if(p->state == PlayingState) {
         p->clock.setPaused(false);
-        p->bufferTimer->start();
+        p->decodeThread->start();
         p->renderer->start();
     }
 }
@@ -238,6 +220,7 @@ void AudioPlaybackEngine::changeTrack(const Track& track)
 
     p->clock.setPaused(true);
     p->clock.sync();
+    p->startPosition = 0;
 
     if(!track.isValid()) {
         p->changeTrackStatus(InvalidTrack);
@@ -329,6 +312,11 @@ void AudioPlaybackEngine::setVolume(double volume)
     p->renderer->updateVolume(volume);
 }
 
+PlaybackStats AudioPlaybackEngine::playbackStats() const
+{
+    return p->renderer->stats();
+}
+
 void AudioPlaybackEngine::setAudioOutput(const OutputCreator& output)
 {
     const bool playing = (p->state == PlayingState || p->state == PausedState);
@@ -336,10 +324,6 @@ void AudioPlaybackEngine::setAudioOutput(const OutputCreator& output)
     p->clock.setPaused(playing);
     p->renderer->pause(playing);
 
-    if(playing) {
-        p->bufferTimer->stop();
-    }
-
     p->renderer->updateOutput(output);
 
     if(playing) {
@@ -363,10 +347,6 @@ void AudioPlaybackEngine::setOutputDevice(const QString& device)
     p->clock.setPaused(playing);
     p->renderer->pause(playing);
 
-    if(playing) {
-        p->bufferTimer->stop();
-    }
-
     p->renderer->updateDevice(device);
 
     if(playing) {
@@ -19,12 +19,14 @@
 
 #pragma once
 
+#include "fycore_export.h"
+
 #include <core/engine/audioengine.h>
 
 namespace Fooyin {
 class SettingsManager;
 
-class AudioPlaybackEngine : public AudioEngine
+class FYCORE_EXPORT AudioPlaybackEngine : public AudioEngine
 {
     Q_OBJECT
 
@@ -32,6 +34,8 @@ public:
     explicit AudioPlaybackEngine(SettingsManager* settings, QObject* parent = nullptr);
     ~AudioPlaybackEngine() override;
 
+    [[nodiscard]] PlaybackStats playbackStats() const override;
+
 public slots:
     void seek(uint64_t pos) override;
 
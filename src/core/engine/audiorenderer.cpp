@@ -19,40 +19,83 @@
 
 #include "audiorenderer.h"
 
+#include "audiodecodethread.h"
+
 #include <core/engine/audiobuffer.h>
 #include <core/engine/audiooutput.h>
-#include <utils/threadqueue.h>
 
 #include <QDebug>
-#include <QTimer>
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <utility>
 
+using namespace std::chrono_literals;
+
+namespace {
+// Bounds on how long the render thread sleeps between writes
+constexpr auto MinWriteWait = 1ms;
+constexpr auto MaxWriteWait = 50ms;
+} // namespace
+
 namespace Fooyin {
 struct AudioRenderer::Private
 {
     AudioRenderer* self;
 
+    RingBuffer<std::byte>* buffer;
+    const AudioDecodeThread* decodeThread;
+
+    // Guards the output and the state below against the render thread
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool quit{false};
+    bool isRunning{false};
+
     std::unique_ptr<AudioOutput> audioOutput;
     AudioFormat format;
     double volume{0.0};
     int bufferSize{0};
 
     bool bufferPrefilled{false};
-
-    ThreadQueue<AudioBuffer> bufferQueue{false};
+    bool finishedEmitted{false};
+    bool underrun{false};
+    bool outputFull{false};
+    // Set while the render thread waits on the output without holding the lock
+    bool waitingForSpace{false};
     AudioBuffer tempBuffer;
-    int totalSamplesWritten{0};
-    int currentBufferOffset{0};
 
-    bool isRunning{false};
+    std::atomic<uint64_t> framesWritten{0};
+    std::atomic<uint64_t> underruns{0};
+    std::atomic<uint64_t> shortWrites{0};
 
-    QTimer* writeTimer;
+    std::thread thread;
 
-    explicit Private(AudioRenderer* self_)
+    Private(AudioRenderer* self_, RingBuffer<std::byte>* buffer_, const AudioDecodeThread* decodeThread_)
         : self{self_}
-        , writeTimer{new QTimer(self)}
+        , buffer{buffer_}
+        , decodeThread{decodeThread_}
+        , thread{[this]() { run(); }}
+    { }
+
+    ~Private()
+    {
+        {
+            const std::scoped_lock lock{mutex};
+            quit = true;
+        }
+        cv.notify_all();
+        thread.join();
+    }
+
+    //! Locks the mutex once the output is no longer being waited on, so it can be used or replaced
+    std::unique_lock<std::mutex> lockOutput()
     {
-        QObject::connect(writeTimer, &QTimer::timeout, self, [this]() { writeNext(); });
+        std::unique_lock lock{mutex};
+        cv.wait(lock, [this]() { return !waitingForSpace; });
+        return lock;
     }
 
     bool initOutput()
@@ -63,115 +106,186 @@ struct AudioRenderer::Private
 
         audioOutput->setVolume(volume);
         bufferSize = audioOutput->bufferSize();
-        updateInterval();
+        tempBuffer = AudioBuffer{format, 0};
 
         return true;
     }
 
-    void updateInterval() const
+    [[nodiscard]] bool canWrite() const
     {
-        const auto interval = static_cast<int>(static_cast<double>(bufferSize) / format.sampleRate() * 1000 * 0.25);
-        writeTimer->setInterval(interval);
+        return isRunning && audioOutput && audioOutput->initialised();
     }
 
-    void writeNext()
+    void run()
     {
-        if(!isRunning || bufferQueue.empty() || !audioOutput->initialised()) {
-            return;
-        }
+        std::unique_lock lock{mutex};
 
-        const int samples = audioOutput->currentState().freeSamples;
+        while(!quit) {
+            if(!canWrite()) {
+                cv.wait(lock, [this]() { return quit || canWrite(); });
+                continue;
+            }
 
-        if((samples == 0 && totalSamplesWritten > 0) || (samples > 0 && renderAudio(samples) == samples)) {
-            if(!bufferPrefilled) {
-                bufferPrefilled = true;
-                audioOutput->start();
+            const auto wait = writeNext();
+
+            // Outputs which can be waited on wake us as soon as they have room. The lock is released so control
+            // calls which don't touch the output aren't held up; those which do wait in lockOutput.
+            if(outputFull && canWrite()) {
+                waitingForSpace = true;
+                lock.unlock();
+                const bool hasSpace = audioOutput->waitForSpace(wait);
+                lock.lock();
+                waitingForSpace = false;
+                cv.notify_all();
+
+                if(hasSpace) {
+                    continue;
+                }
             }
+
+            // Releases the lock while waiting, and wakes early for any control changes
+            cv.wait_for(lock, wait);
         }
     }
 
-    int writeAudioSamples(int samples)
+    void resetState()
     {
+        isRunning       = false;
+        bufferPrefilled = false;
+        finishedEmitted = false;
+        underrun        = false;
+        outputFull      = false;
+        framesWritten   = 0;
         tempBuffer.clear();
+    }
 
-        int samplesBuffered{0};
+    std::chrono::milliseconds writeNext()
+    {
+        const int frameBytes = format.bytesPerFrame();
+        if(frameBytes <= 0) {
+            return MaxWriteWait;
+        }
 
-        const int sstride = format.bytesPerFrame();
+        outputFull = false;
 
-        while(isRunning && !bufferQueue.empty() && samplesBuffered < samples) {
-            const AudioBuffer& buffer = bufferQueue.front();
+        const OutputState state = audioOutput->currentState();
 
-            if(!buffer.isValid()) {
-                // End of file
-                currentBufferOffset = 0;
-                bufferQueue.dequeue();
-                QMetaObject::invokeMethod(self, &AudioRenderer::finished);
-                return samplesBuffered;
-            }
+        const auto available  = static_cast<int>(buffer->readAvailable() / static_cast<size_t>(frameBytes));
+        const bool inputEnded = decodeThread->atEnd();
 
-            const int bytesLeft = buffer.byteCount() - currentBufferOffset;
-
-            if(bytesLeft <= 0) {
-                currentBufferOffset = 0;
-                emit self->bufferProcessed(buffer);
-                bufferQueue.dequeue();
-                continue;
+        if(available == 0 && inputEnded) {
+            if(!bufferPrefilled) {
+                // Track was shorter than the output buffer
+                bufferPrefilled = true;
+                audioOutput->start();
             }
+            isRunning = false;
+            if(!std::exchange(finishedEmitted, true)) {
+                emit self->finished();
+            }
+            return MinWriteWait;
+        }
 
-            const int sampleCount = std::min(bytesLeft / sstride, samples - samplesBuffered);
-            const int bytes       = sampleCount * sstride;
-            const auto fdata      = buffer.constData().subspan(currentBufferOffset, static_cast<size_t>(bytes));
-
-            if(!tempBuffer.isValid()) {
-                tempBuffer = {fdata, buffer.format(), buffer.startTime()};
+        if(bufferPrefilled && !inputEnded) {
+            const bool drained = state.queuedSamples == 0;
+            if(drained && !std::exchange(underrun, true)) {
+                ++underruns;
+                qDebug() << "[Engine] Output underrun with" << available << "frames still buffered";
             }
-            else {
-                tempBuffer.append(fdata);
+            else if(!drained) {
+                underrun = false;
             }
 
-            samplesBuffered += sampleCount;
-            currentBufferOffset += bytes;
+            if(state.freeSamples > available) {
+                ++shortWrites;
+            }
         }
 
-        tempBuffer.fillRemainingWithSilence();
+        const int samples = std::min(state.freeSamples, available);
+        const int written = samples > 0 ? renderAudio(samples) : 0;
+
+        // Only worth waiting on the output if it, rather than the decoder, is what we're waiting for
+        outputFull = written > 0 && written == state.freeSamples;
 
-        if(!tempBuffer.isValid()) {
-            return 0;
+        if(!bufferPrefilled && framesWritten > 0 && written == state.freeSamples) {
+            bufferPrefilled = true;
+            audioOutput->start();
         }
 
-        return samplesBuffered;
+        if(written > 0 && state.queuedSamples == 0) {
+            // Either catching up after an underrun, or an output which isn't paced by playback (e.g. writing to a
+            // file) and never has anything queued. Sleeping would only throttle the latter.
+            return std::chrono::milliseconds{0};
+        }
+
+        return writeWait(state.queuedSamples + written);
     }
 
     int renderAudio(int samples)
     {
-        if(writeAudioSamples(samples) == 0) {
-            return 0;
+        const int frameBytes = format.bytesPerFrame();
+        const double scale   = audioOutput->canHandleVolume() ? 1.0 : volume;
+
+        std::span<std::byte> area = audioOutput->mapBuffer(samples);
+        if(!area.empty()) {
+            // Read and scale directly into the driver's buffer
+            int samplesWritten{0};
+            while(!area.empty()) {
+                const size_t read = buffer->read(area.first(area.size() - (area.size() % frameBytes)));
+                AudioBuffer::adjustVolumeOfSamples(area.first(read), format, scale);
+
+                const int committed = audioOutput->commitBuffer(static_cast<int>(read) / frameBytes);
+                samplesWritten += committed;
+                if(committed <= 0 || samplesWritten >= samples) {
+                    break;
+                }
+                area = audioOutput->mapBuffer(samples - samplesWritten);
+            }
+
+            framesWritten += static_cast<uint64_t>(samplesWritten);
+            return samplesWritten;
         }
 
+        const auto bytes = static_cast<size_t>(samples * frameBytes);
+
+        tempBuffer.resize(bytes);
+        buffer->read({tempBuffer.data(), bytes});
+
         if(!audioOutput->canHandleVolume()) {
             tempBuffer.adjustVolumeOfSamples(volume);
         }
 
-        if(!tempBuffer.isValid()) {
-            return 0;
-        }
-
         const int samplesWritten = audioOutput->write(tempBuffer);
-        totalSamplesWritten += samplesWritten;
+        framesWritten += static_cast<uint64_t>(samplesWritten);
 
         return samplesWritten;
     }
+
+    [[nodiscard]] std::chrono::milliseconds writeWait(int samplesQueued) const
+    {
+        if(format.sampleRate() <= 0) {
+            return MaxWriteWait;
+        }
+
+        // Wake once the output has played down to half of its buffer
+        const int samplesToPlay = samplesQueued - (bufferSize / 2);
+        const auto wait = std::chrono::milliseconds{static_cast<int64_t>(samplesToPlay) * 1000 / format.sampleRate()};
+
+        return std::clamp<std::chrono::milliseconds>(wait, MinWriteWait, MaxWriteWait);
+    }
 };
 
-AudioRenderer::AudioRenderer(QObject* parent)
+AudioRenderer::AudioRenderer(RingBuffer<std::byte>* buffer, const AudioDecodeThread* decodeThread, QObject* parent)
     : QObject{parent}
-    , p{std::make_unique<Private>(this)}
+    , p{std::make_unique<Private>(this, buffer, decodeThread)}
 {
     setObjectName(QStringLiteral("Renderer"));
 }
 
 AudioRenderer::~AudioRenderer()
 {
+    const auto lock = p->lockOutput();
+
     if(p->audioOutput && p->audioOutput->initialised()) {
         p->audioOutput->uninit();
     }
@@ -179,6 +293,8 @@ AudioRenderer::~AudioRenderer()
 
 bool AudioRenderer::init(const AudioFormat& format)
 {
+    const auto lock = p->lockOutput();
+
     p->format = format;
 
     if(!p->audioOutput) {
@@ -194,54 +310,60 @@ bool AudioRenderer::init(const AudioFormat& format)
 
 void AudioRenderer::start()
 {
-    if(std::exchange(p->isRunning, true)) {
-        return;
+    {
+        const std::scoped_lock lock{p->mutex};
+        if(std::exchange(p->isRunning, true)) {
+            return;
+        }
     }
-
-    p->writeTimer->start();
+    p->cv.notify_all();
 }
 
 void AudioRenderer::stop()
 {
-    p->isRunning = false;
-    p->writeTimer->stop();
-
-    p->bufferPrefilled     = false;
-    p->totalSamplesWritten = 0;
-    p->currentBufferOffset = 0;
-    p->bufferQueue.clear();
-    p->tempBuffer.reset();
+    const std::scoped_lock lock{p->mutex};
+    p->resetState();
 }
 
 void AudioRenderer::reset()
 {
+    const auto lock = p->lockOutput();
+
     if(p->audioOutput && p->audioOutput->initialised()) {
         p->audioOutput->reset();
     }
 
-    p->bufferPrefilled     = false;
-    p->totalSamplesWritten = 0;
-    p->currentBufferOffset = 0;
-    p->bufferQueue.clear();
-    p->tempBuffer.reset();
+    p->resetState();
 }
 
 void AudioRenderer::pause(bool paused)
 {
-    if(p->audioOutput && p->audioOutput->initialised()) {
-        p->audioOutput->setPaused(paused);
+    {
+        const auto lock = p->lockOutput();
+
+        if(p->audioOutput && p->audioOutput->initialised()) {
+            p->audioOutput->setPaused(paused);
+        }
+
+        p->isRunning = !paused;
     }
+    p->cv.notify_all();
+}
 
-    p->isRunning = !paused;
+uint64_t AudioRenderer::framesWritten() const
+{
+    return p->framesWritten;
 }
 
-void AudioRenderer::queueBuffer(const AudioBuffer& buffer)
+PlaybackStats AudioRenderer::stats() const
 {
-    p->bufferQueue.enqueue(buffer);
+    return {.underruns = p->underruns, .shortWrites = p->shortWrites};
 }
 
 void AudioRenderer::updateOutput(const OutputCreator& output)
 {
+    const auto lock = p->lockOutput();
+
     auto newOutput = output();
     if(newOutput == p->audioOutput) {
         return;
@@ -257,6 +379,8 @@ void AudioRenderer::updateOutput(const OutputCreator& output)
 
 void AudioRenderer::updateDevice(const QString& device)
 {
+    const auto lock = p->lockOutput();
+
     if(!p->audioOutput) {
         return;
     }
@@ -274,6 +398,8 @@ void AudioRenderer::updateDevice(const QString& device)
 
 void AudioRenderer::updateVolume(double volume)
 {
+    const auto lock = p->lockOutput();
+
     p->volume = volume;
 
     if(p->audioOutput && p->audioOutput->canHandleVolume()) {
@@ -19,36 +19,47 @@
 
 #pragma once
 
+#include <core/engine/audioengine.h>
 #include <core/engine/audiooutput.h>
+#include <utils/ringbuffer.h>
 
 #include <QObject>
 
 namespace Fooyin {
-class AudioBuffer;
+class AudioDecodeThread;
 class AudioFormat;
 
+/*!
+ * Writes PCM data from the decode ring buffer to the audio output on a dedicated thread.
+ * Rather than polling on a fixed interval, the thread sleeps until the output is expected
+ * to have drained enough to accept another write.
+ */
 class AudioRenderer : public QObject
 {
     Q_OBJECT
 
 public:
-    explicit AudioRenderer(QObject* parent = nullptr);
+    AudioRenderer(RingBuffer<std::byte>* buffer, const AudioDecodeThread* decodeThread, QObject* parent = nullptr);
     ~AudioRenderer() override;
 
     bool init(const AudioFormat& format);
     void start();
+    //! Stops rendering; once this returns the ring buffer is no longer being read
     void stop();
+    //! As @fn stop, also resetting the output
     void reset();
     void pause(bool paused);
 
-    void queueBuffer(const AudioBuffer& buffer);
+    //! Number of frames written to the output since the last stop or reset
+    [[nodiscard]] uint64_t framesWritten() const;
+    [[nodiscard]] PlaybackStats stats() const;
 
     void updateOutput(const OutputCreator& output);
     void updateDevice(const QString& device);
     void updateVolume(double volume);
 
 signals:
-    void bufferProcessed(const AudioBuffer& buffer);
+    //! Emitted from the render thread once all decoded data has been written
     void finished();
 
 private:
@@ -227,6 +227,11 @@ std::unique_ptr<AudioDecoder> EngineHandler::createDecoder()
 {
     return std::make_unique<FFmpegDecoder>();
 }
+
+PlaybackStats EngineHandler::playbackStats() const
+{
+    return p->engine->playbackStats();
+}
 } // namespace Fooyin
 
 #include "moc_enginehandler.cpp"
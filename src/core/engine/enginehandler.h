@@ -46,6 +46,8 @@ public:
 
     std::unique_ptr<AudioDecoder> createDecoder() override;
 
+    [[nodiscard]] PlaybackStats playbackStats() const override;
+
 private:
     struct Private;
     std::unique_ptr<Private> p;
@@ -51,6 +51,8 @@ CoreSettings::CoreSettings(SettingsManager* settingsManager)
     m_settings->createSetting<Internal::MonitorLibraries>(true, QStringLiteral("Library/MonitorLibraries"));
     m_settings->createTempSetting<Internal::MuteVolume>(m_settings->value<OutputVolume>());
     m_settings->createSetting<Internal::DisabledPlugins>(QStringList{}, QStringLiteral("Plugins/Disabled"));
+    m_settings->createSetting<Internal::MonitorDelay>(200, QStringLiteral("Library/MonitorDelay"));
+    m_settings->createSetting<Internal::MonitorPollInterval>(900, QStringLiteral("Library/MonitorPollInterval"));
 
     m_settings->set<FirstRun>(!QFileInfo::exists(Core::settingsPath()));
 }
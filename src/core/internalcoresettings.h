@@ -31,14 +31,16 @@ Q_NAMESPACE_EXPORT(FYCORE_EXPORT)
 
 enum CoreInternalSettings : uint32_t
 {
-    MonitorLibraries = 0 | Settings::Bool,
-    MuteVolume       = 1 | Settings::Double,
-    DisabledPlugins  = 2 | Settings::StringList,
+    MonitorLibraries    = 0 | Settings::Bool,
+    MuteVolume          = 1 | Settings::Double,
+    DisabledPlugins     = 2 | Settings::StringList,
+    MonitorDelay        = 3 | Settings::Int,
+    MonitorPollInterval = 4 | Settings::Int,
 };
 Q_ENUM_NS(CoreInternalSettings)
 } // namespace Settings::Core::Internal
 
-class CoreSettings
+class FYCORE_EXPORT CoreSettings
 {
 public:
     explicit CoreSettings(SettingsManager* settingsManager);
@@ -0,0 +1,276 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "libraryindex.h"
+
+#include <core/library/trackstore.h>
+
+#include <QCollator>
+
+#include <map>
+#include <unordered_map>
+
+namespace {
+struct OrderKey
+{
+    QCollatorSortKey sortKey;
+    // Keeps tracks with equal sort fields in insertion order
+    uint64_t seq;
+};
+
+struct OrderCompare
+{
+    bool operator()(const OrderKey& lhs, const OrderKey& rhs) const
+    {
+        const int cmp = lhs.sortKey.compare(rhs.sortKey);
+        if(cmp != 0) {
+            return cmp < 0;
+        }
+        return lhs.seq < rhs.seq;
+    }
+};
+
+using OrderedTracks = std::map<OrderKey, Fooyin::Track, OrderCompare>;
+// Ordered by path so all tracks within a directory are adjacent
+using TrackPaths = std::multimap<QString, OrderedTracks::iterator>;
+
+using TrackHashes = std::unordered_multimap<QString, int>;
+
+struct IndexEntry
+{
+    OrderedTracks::iterator track;
+    TrackPaths::iterator path;
+    TrackHashes::iterator hash;
+};
+} // namespace
+
+namespace Fooyin {
+struct LibraryIndex::Private
+{
+    QCollator collator;
+    OrderedTracks tracks;
+    TrackPaths paths;
+    TrackHashes hashes;
+    std::unordered_map<int, IndexEntry> ids;
+    TrackStore store;
+    uint64_t nextSeq{0};
+
+    mutable TrackList sortedTracks;
+    mutable bool sortedValid{false};
+
+    Private()
+    {
+        collator.setNumericMode(true);
+    }
+
+    void insert(const Track& track)
+    {
+        uint64_t seq = nextSeq;
+
+        if(track.isInDatabase()) {
+            if(const auto it = ids.find(track.id()); it != ids.cend()) {
+                Track& existing = it->second.track->second;
+                if(existing.sort() == track.sort() && existing.filepath() == track.filepath()
+                   && existing.hash() == track.hash()) {
+                    // Nothing the index is keyed on changed (e.g. only playback statistics), so update in place
+                    existing = track;
+                    store.insert(track);
+                    sortedValid = false;
+                    return;
+                }
+                // Keep the original position amongst tracks with the same sort field
+                seq = it->second.track->first.seq;
+                erase(it);
+            }
+        }
+
+        if(seq == nextSeq) {
+            ++nextSeq;
+        }
+
+        // Hinting at the end makes inserting already sorted tracks amortised constant time
+        const auto trackIt = tracks.emplace_hint(tracks.cend(), OrderKey{collator.sortKey(track.sort()), seq}, track);
+        const auto pathIt  = paths.emplace(track.filepath(), trackIt);
+        if(track.isInDatabase()) {
+            const auto hashIt = hashes.emplace(track.hash(), track.id());
+            ids.emplace(track.id(), IndexEntry{trackIt, pathIt, hashIt});
+            store.insert(track);
+        }
+
+        sortedValid = false;
+    }
+
+    void erase(std::unordered_map<int, IndexEntry>::const_iterator it)
+    {
+        paths.erase(it->second.path);
+        hashes.erase(it->second.hash);
+        tracks.erase(it->second.track);
+        store.remove(it->first);
+        ids.erase(it);
+    }
+};
+
+LibraryIndex::LibraryIndex()
+    : p{std::make_unique<Private>()}
+{ }
+
+LibraryIndex::~LibraryIndex() = default;
+
+LibraryIndex::LibraryIndex(LibraryIndex&& other) noexcept            = default;
+LibraryIndex& LibraryIndex::operator=(LibraryIndex&& other) noexcept = default;
+
+bool LibraryIndex::empty() const
+{
+    return p->tracks.empty();
+}
+
+size_t LibraryIndex::size() const
+{
+    return p->tracks.size();
+}
+
+bool LibraryIndex::contains(int id) const
+{
+    return p->ids.contains(id);
+}
+
+TrackList LibraryIndex::tracks() const
+{
+    if(!p->sortedValid) {
+        p->sortedTracks.clear();
+        p->sortedTracks.reserve(p->tracks.size());
+
+        for(const auto& [_, track] : p->tracks) {
+            p->sortedTracks.push_back(track);
+        }
+
+        p->sortedValid = true;
+    }
+
+    return p->sortedTracks;
+}
+
+const TrackStore& LibraryIndex::store() const
+{
+    return p->store;
+}
+
+TrackList LibraryIndex::tracksForIds(const TrackIds& ids) const
+{
+    TrackList tracks;
+    tracks.reserve(ids.size());
+
+    for(const int id : ids) {
+        if(const auto it = p->ids.find(id); it != p->ids.cend()) {
+            tracks.push_back(it->second.track->second);
+        }
+    }
+
+    return tracks;
+}
+
+TrackList LibraryIndex::tracksWithHash(const QString& hash) const
+{
+    TrackList tracks;
+
+    const auto [first, last] = p->hashes.equal_range(hash);
+    for(auto it = first; it != last; ++it) {
+        if(const auto idIt = p->ids.find(it->second); idIt != p->ids.cend()) {
+            tracks.push_back(idIt->second.track->second);
+        }
+    }
+
+    return tracks;
+}
+
+TrackList LibraryIndex::tracksInDirectory(const QString& dir) const
+{
+    if(dir.isEmpty()) {
+        return {};
+    }
+
+    // Trailing separator so /music/a doesn't match /music/ab
+    const QString prefix = dir.endsWith(u'/') ? dir : dir + u'/';
+
+    TrackList tracks;
+
+    for(auto it = p->paths.lower_bound(prefix); it != p->paths.cend() && it->first.startsWith(prefix); ++it) {
+        tracks.push_back(it->second->second);
+    }
+
+    return tracks;
+}
+
+TrackList LibraryIndex::tracksForPaths(const QStringList& filepaths) const
+{
+    TrackList tracks;
+
+    for(const QString& filepath : filepaths) {
+        const auto [first, last] = p->paths.equal_range(filepath);
+        for(auto it = first; it != last; ++it) {
+            tracks.push_back(it->second->second);
+        }
+    }
+
+    return tracks;
+}
+
+void LibraryIndex::reset(const TrackList& tracks)
+{
+    clear();
+    insert(tracks);
+}
+
+void LibraryIndex::insert(const Track& track)
+{
+    p->insert(track);
+}
+
+void LibraryIndex::insert(const TrackList& tracks)
+{
+    for(const Track& track : tracks) {
+        p->insert(track);
+    }
+}
+
+bool LibraryIndex::remove(int id)
+{
+    const auto it = p->ids.find(id);
+    if(it == p->ids.cend()) {
+        return false;
+    }
+
+    p->erase(it);
+    p->sortedValid = false;
+
+    return true;
+}
+
+void LibraryIndex::clear()
+{
+    p->tracks.clear();
+    p->paths.clear();
+    p->hashes.clear();
+    p->ids.clear();
+    p->store.clear();
+    p->sortedTracks.clear();
+    p->sortedValid = false;
+    p->nextSeq     = 0;
+}
+} // namespace Fooyin
@@ -0,0 +1,75 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fycore_export.h"
+
+#include <core/track.h>
+
+namespace Fooyin {
+class TrackStore;
+
+/*!
+ * Keeps the library's tracks ordered by their sort field, with lookups by track id, hash and path.
+ * Sort keys are calculated once on insertion, so adding, updating or removing a track
+ * costs O(log N) rather than a full re-sort, and updating one without changing its sort field,
+ * path or hash replaces it in place.
+ * Tracks must already have their sort field calculated.
+ */
+class FYCORE_EXPORT LibraryIndex
+{
+public:
+    LibraryIndex();
+    ~LibraryIndex();
+
+    LibraryIndex(LibraryIndex&& other) noexcept;
+    LibraryIndex& operator=(LibraryIndex&& other) noexcept;
+
+    [[nodiscard]] bool empty() const;
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] bool contains(int id) const;
+
+    //! Returns all tracks in sort order
+    [[nodiscard]] TrackList tracks() const;
+    //! Returns the columns of all tracks in the database, kept up to date as the index changes
+    [[nodiscard]] const TrackStore& store() const;
+    //! Returns the tracks for @p ids in the order given, skipping any not in the index
+    [[nodiscard]] TrackList tracksForIds(const TrackIds& ids) const;
+    //! Returns the tracks in the database with a hash of @p hash
+    [[nodiscard]] TrackList tracksWithHash(const QString& hash) const;
+    //! Returns the tracks located anywhere below @p dir, ordered by path
+    [[nodiscard]] TrackList tracksInDirectory(const QString& dir) const;
+    //! Returns the tracks located at any of @p filepaths
+    [[nodiscard]] TrackList tracksForPaths(const QStringList& filepaths) const;
+
+    //! Replaces the contents of the index with @p tracks
+    void reset(const TrackList& tracks);
+    //! Inserts @p track, replacing any existing track with the same id
+    void insert(const Track& track);
+    void insert(const TrackList& tracks);
+    //! Removes the track with @p id, returning true if it was found
+    bool remove(int id);
+    void clear();
+
+private:
+    struct Private;
+    std::unique_ptr<Private> p;
+};
+} // namespace Fooyin
@@ -23,19 +23,31 @@
 #include "database/trackdatabase.h"
 #include "internalcoresettings.h"
 #include "library/libraryinfo.h"
-#include "librarywatcher.h"
 #include "tagging/tagreader.h"
 
 #include <core/track.h>
-#include <utils/fileutils.h>
+#include <utils/fileenumerator.h>
 #include <utils/settings/settingsmanager.h>
 
 #include <QDir>
-#include <QFileSystemWatcher>
+#include <QFile>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent>
 
+#include <optional>
 #include <ranges>
+#include <unordered_set>
+#include <utility>
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif
 
 constexpr auto BatchSize = 250;
+// Walking separate subtrees in parallel mostly helps with network filesystems
+constexpr auto EnumeratorThreads = 4;
 
 namespace {
 Fooyin::Track matchMissingTrack(const Fooyin::TrackFieldMap& missingFiles, const Fooyin::TrackFieldMap& missingHashes,
@@ -54,9 +66,100 @@ Fooyin::Track matchMissingTrack(const Fooyin::TrackFieldMap& missingFiles, const
 
     return {};
 };
+
+// A single statx call, without going through QFileInfo and QDateTime
+std::optional<Fooyin::FileStat> statFile(const QString& filepath)
+{
+#ifdef Q_OS_LINUX
+    struct statx info{};
+    if(::statx(AT_FDCWD, QFile::encodeName(filepath).constData(), 0, STATX_INO | STATX_SIZE | STATX_MTIME, &info)
+       != 0) {
+        return {};
+    }
+
+    return Fooyin::FileStat{.inode      = info.stx_ino,
+                            .size       = info.stx_size,
+                            .modifiedNs = (info.stx_mtime.tv_sec * 1000000000LL) + info.stx_mtime.tv_nsec};
+#else
+    const QFileInfo info{filepath};
+    if(!info.exists()) {
+        return {};
+    }
+
+    return Fooyin::FileStat{.inode      = 0,
+                            .size       = static_cast<uint64_t>(info.size()),
+                            .modifiedNs = info.lastModified().toMSecsSinceEpoch() * 1000000};
+#endif
+}
+
+bool isTrackFile(const QStringList& extensions, const QString& filepath)
+{
+    return !filepath.isEmpty() && QDir::match(extensions, QFileInfo{filepath}.fileName());
+}
+
+// Changes to individual files which can be tracks, which are applied without rescanning their directories
+Fooyin::FileEvents changedFiles(const Fooyin::FileEvents& events)
+{
+    const QStringList extensions = Fooyin::Track::supportedFileExtensions();
+
+    Fooyin::FileEvents files;
+    std::ranges::copy_if(events, std::back_inserter(files), [&extensions](const Fooyin::FileEvent& event) {
+        return !event.isDir && (isTrackFile(extensions, event.path) || isTrackFile(extensions, event.oldPath));
+    });
+    return files;
+}
+
+// Directories to rescan for @p events, as anything could have been added or removed below them
+QStringList changedDirectories(const Fooyin::FileEvents& events)
+{
+    QStringList dirs;
+    const auto addDir = [&dirs](const QString& dir) {
+        if(!dir.isEmpty() && !dirs.contains(dir)) {
+            dirs.append(dir);
+        }
+    };
+
+    for(const Fooyin::FileEvent& event : events) {
+        if(event.isDir) {
+            addDir(event.path);
+            addDir(event.oldPath);
+        }
+    }
+
+    return dirs;
+}
+
+// Drops any directories which are contained within another, so files aren't enumerated twice
+QStringList outermostDirs(QStringList dirs)
+{
+    dirs.sort();
+    dirs.removeDuplicates();
+
+    QStringList outermost;
+    for(const QString& dir : dirs) {
+        if(outermost.empty() || !dir.startsWith(outermost.back() + u'/')) {
+            outermost.append(dir);
+        }
+    }
+    return outermost;
+}
+
+bool isWithinDirs(const QStringList& dirs, const QString& filepath)
+{
+    return std::ranges::any_of(dirs, [&filepath](const QString& dir) { return filepath.startsWith(dir + u'/'); });
+}
 } // namespace
 
 namespace Fooyin {
+struct PendingTrack
+{
+    Track track;
+    bool isNew{false};
+    bool metadataRead{false};
+    std::optional<FileStat> stat;
+};
+using PendingTracks = std::vector<PendingTrack>;
+
 struct LibraryScanner::Private
 {
     LibraryScanner* self;
@@ -75,33 +178,39 @@ struct LibraryScanner::Private
 
     std::unordered_map<int, LibraryWatcher> watchers;
 
+    QThreadPool readPool;
+
     Private(LibraryScanner* self_, DbConnectionPoolPtr dbPool_, SettingsManager* settings_)
         : self{self_}
         , dbPool{std::move(dbPool_)}
         , settings{settings_}
-    { }
+    {
+        readPool.setMaxThreadCount(QThread::idealThreadCount());
+    }
 
     void addWatcher(const Fooyin::LibraryInfo& library)
     {
-        auto watchPaths = [this, library](const QString& path) {
-            QStringList dirs = Utils::File::getAllSubdirectories(path);
-            dirs.append(path);
-            watchers[library.id].addPaths(dirs);
-        };
-
-        watchPaths(library.path);
-
-        QObject::connect(&watchers.at(library.id), &LibraryWatcher::libraryDirChanged, self,
-                         [this, watchPaths, library](const QString& dir) {
-                             watchPaths(dir);
-                             emit self->directoryChanged(library, dir);
-                         });
+        LibraryWatcher& watcher = watchers[library.id];
+        watcher.setDelay(std::chrono::milliseconds{settings->value<Settings::Core::Internal::MonitorDelay>()});
+        watcher.setPollInterval(std::chrono::seconds{settings->value<Settings::Core::Internal::MonitorPollInterval>()});
+        watcher.addPath(library.path);
+
+        QObject::connect(&watcher, &LibraryWatcher::filesChanged, self, [this, library](const FileEvents& events) {
+            const QStringList dirs = changedDirectories(events);
+            const FileEvents files = changedFiles(events);
+            if(!dirs.empty() || !files.empty()) {
+                emit self->libraryChanged(library, dirs, files);
+            }
+        });
+        QObject::connect(&watcher, &LibraryWatcher::watching, self,
+                         [this, library]() { emit self->libraryWatched(library); });
     }
 
     void reportProgress()
     {
+        // The total can grow while files are still being found, so never report going backwards
         const int progress = static_cast<int>((tracksProcessed / totalTracks) * 100);
-        if(currentProgress != progress) {
+        if(progress > currentProgress) {
             currentProgress = progress;
             emit self->progressChanged(currentProgress);
         }
@@ -116,113 +225,324 @@ struct LibraryScanner::Private
         trackDatabase.storeTracks(tracks);
     }
 
-    bool getAndSaveAllTracks(const QString& path, const TrackList& tracks)
+    void readTracks(PendingTracks& tracks)
     {
-        const QDir dir{path};
+        // Each call to readMetaData opens its own TagLib stream, so reads are independent
+        QtConcurrent::blockingMap(&readPool, tracks, [this](PendingTrack& pending) {
+            if(self->mayRun()) {
+                pending.metadataRead = Tagging::readMetaData(pending.track);
+            }
+        });
+    }
+
+    bool getAndSaveAllTracks(const QStringList& paths, const FileEvents& files, const TrackList& tracks)
+    {
+        const QDir libraryDir{currentLibrary.path};
+        const QStringList dirs       = outermostDirs(paths);
+        const QStringList extensions = Track::supportedFileExtensions();
+
+        ScanStats stats;
 
         TrackList tracksToStore;
         TrackList tracksToUpdate;
+        // New files which may turn out to be moved tracks once the walk is complete
+        TrackList possiblyMoved;
+
+        struct KnownFile
+        {
+            const Track* track;
+            std::optional<FileStat> stat;
+            bool found{false};
+            // Already updated to the path the watcher saw it moved to
+            bool moved{false};
+        };
 
-        TrackFieldMap trackPaths;
-        TrackFieldMap missingFiles;
-        TrackFieldMap missingHashes;
+        auto setTrackProps = [this, &libraryDir](Track& track) {
+            track.setLibraryId(currentLibrary.id);
+            track.setRelativePath(libraryDir.relativeFilePath(track.filepath()));
+            track.setIsEnabled(true);
+        };
 
+        const auto removeTrack = [&tracksToUpdate, &stats](Track& track) {
+            if(track.isInLibrary() || track.isEnabled()) {
+                track.setLibraryId(-1);
+                track.setIsEnabled(false);
+                tracksToUpdate.push_back(track);
+                ++stats.removed;
+            }
+        };
+
+        // Only the tracks being scanned, rather than every track in the database
+        TrackIds trackIds;
+        trackIds.reserve(tracks.size());
         for(const Track& track : tracks) {
-            trackPaths.emplace(track.filepath(), track);
+            if(track.isInDatabase()) {
+                trackIds.push_back(track.id());
+            }
+        }
+        const FileStatMap cachedStats = trackDatabase.fileStats(trackIds);
+
+        std::unordered_map<QString, KnownFile> knownFiles;
+        std::unordered_set<QString> knownFilenames;
+        std::unordered_set<QString> knownHashes;
+
+        knownFiles.reserve(tracks.size());
+        for(const Track& track : tracks) {
+            const auto statIt = cachedStats.find(track.id());
+            knownFiles.emplace(track.filepath(),
+                               KnownFile{.track = &track,
+                                         .stat  = statIt != cachedStats.cend() ? std::optional{statIt->second}
+                                                                               : std::nullopt});
+            knownFilenames.emplace(track.filename());
+            knownHashes.emplace(track.hash());
+        }
+
+        // Files outside of the directories being walked which need checking individually.
+        // Removed files need nothing more, as their tracks are found missing below.
+        QStringList filesToCheck;
+        const auto checkFile = [&](const QString& filepath) {
+            if(isTrackFile(extensions, filepath) && !isWithinDirs(dirs, filepath) && !filesToCheck.contains(filepath)) {
+                filesToCheck.append(filepath);
+            }
+        };
+
+        // Tracks whose files were overwritten by a move
+        TrackList replacedTracks;
+        // Reserved so the pointers held in knownFiles stay valid
+        TrackList movedTracks;
+        movedTracks.reserve(files.size());
 
-            if(!QFileInfo::exists(track.filepath())) {
-                missingFiles.emplace(track.filename(), track);
-                missingHashes.emplace(track.hash(), track);
+        for(const FileEvent& event : files) {
+            if(event.type != FileEvent::Type::Moved) {
+                if(event.type != FileEvent::Type::Removed) {
+                    checkFile(event.path);
+                }
+                continue;
             }
+
+            // Moves seen by the watcher keep the track's id, statistics and cached attributes
+            const FileEvent& move = event;
+            const bool isTrack    = isTrackFile(extensions, move.path);
+            const auto knownIt    = knownFiles.find(move.oldPath);
+
+            if(knownIt == knownFiles.end() || !isTrack) {
+                // Tracks renamed to something which isn't a track are found missing below
+                checkFile(move.path);
+                continue;
+            }
+
+            Track& movedTrack = movedTracks.emplace_back(*knownIt->second.track);
+            movedTrack.setFilePath(move.path);
+            setTrackProps(movedTrack);
+
+            const std::optional<FileStat> stat = knownIt->second.stat;
+            knownFiles.erase(knownIt);
+
+            if(const auto replacedIt = knownFiles.find(move.path); replacedIt != knownFiles.end()) {
+                replacedTracks.push_back(*replacedIt->second.track);
+                knownFiles.erase(replacedIt);
+            }
+
+            knownFiles.emplace(move.path, KnownFile{.track = &movedTrack, .stat = stat, .found = false, .moved = true});
         }
 
-        const QStringList files = Utils::File::getFilesInDir(dir, Track::supportedFileExtensions());
+        // Attributes of files which were read or confirmed unchanged, to be cached once stored
+        FileStatMap statsToStore;
+        std::unordered_map<QString, FileStat> readStats;
+
+        const auto cacheStats = [&statsToStore, &readStats](const TrackList& storedTracks) {
+            for(const Track& track : storedTracks) {
+                if(const auto statIt = readStats.find(track.filepath()); statIt != readStats.cend()) {
+                    statsToStore.insert_or_assign(track.id(), statIt->second);
+                }
+            }
+        };
 
         tracksProcessed = 0;
-        totalTracks     = static_cast<double>(files.size());
+        totalTracks     = 0;
         currentProgress = -1;
 
-        for(const auto& filepath : files) {
+        PendingTracks pendingTracks;
+
+        const auto readPendingTracks = [&]() {
+            readTracks(pendingTracks);
+
             if(!self->mayRun()) {
                 return false;
             }
 
-            ++tracksProcessed;
+            for(PendingTrack& pending : pendingTracks) {
+                ++tracksProcessed;
 
-            const QFileInfo info{filepath};
-            const QDateTime lastModifiedTime{info.lastModified()};
-            uint64_t lastModified{0};
+                if(pending.metadataRead) {
+                    Track& track = pending.track;
 
-            if(lastModifiedTime.isValid()) {
-                lastModified = static_cast<uint64_t>(lastModifiedTime.toMSecsSinceEpoch());
-            }
+                    if(pending.stat) {
+                        readStats.insert_or_assign(track.filepath(), *pending.stat);
+                    }
 
-            auto setTrackProps = [this, &filepath, &dir](Track& track) {
-                track.setFilePath(filepath);
-                track.setLibraryId(currentLibrary.id);
-                track.setRelativePath(dir.relativeFilePath(filepath));
-                track.setIsEnabled(true);
-            };
-
-            if(trackPaths.contains(filepath)) {
-                const Track& libraryTrack = trackPaths.at(filepath);
-
-                if(!libraryTrack.isEnabled() || libraryTrack.libraryId() != currentLibrary.id
-                   || libraryTrack.modifiedTime() != lastModified) {
-                    Track changedTrack{libraryTrack};
-                    if(Tagging::readMetaData(changedTrack)) {
-                        setTrackProps(changedTrack);
-
-                        tracksToUpdate.push_back(changedTrack);
-                        missingHashes.erase(changedTrack.hash());
-                        missingFiles.erase(changedTrack.filename());
+                    if(!pending.isNew) {
+                        setTrackProps(track);
+                        tracksToUpdate.push_back(track);
+                        ++stats.reread;
+                    }
+                    else if(knownFilenames.contains(track.filename()) || knownHashes.contains(track.hash())) {
+                        possiblyMoved.push_back(track);
+                    }
+                    else {
+                        setTrackProps(track);
+                        tracksToStore.push_back(track);
+                        ++stats.added;
+
+                        if(tracksToStore.size() >= BatchSize) {
+                            storeTracks(tracksToStore);
+                            cacheStats(tracksToStore);
+                            emit self->scanUpdate({.addedTracks = tracksToStore, .updatedTracks = {}});
+                            tracksToStore.clear();
+                        }
                     }
                 }
+
+                reportProgress();
             }
-            else {
-                Track track{filepath};
 
-                if(Tagging::readMetaData(track)) {
-                    Track refoundTrack = matchMissingTrack(missingFiles, missingHashes, track);
+            pendingTracks.clear();
 
-                    if(refoundTrack.isInLibrary() || refoundTrack.isInDatabase()) {
-                        missingHashes.erase(refoundTrack.hash());
-                        missingFiles.erase(refoundTrack.filename());
+            return true;
+        };
+
+        const auto processFile = [&](const QString& filepath) {
+            const std::optional<FileStat> stat = statFile(filepath);
+
+            if(const auto knownIt = knownFiles.find(filepath); knownIt != knownFiles.end()) {
+                KnownFile& known          = knownIt->second;
+                const Track& libraryTrack = *known.track;
+                known.found               = true;
 
-                        setTrackProps(refoundTrack);
-                        tracksToUpdate.push_back(refoundTrack);
+                // Tracks read before attributes were cached fall back to comparing the modified time
+                const bool unchanged
+                    = stat && libraryTrack.isEnabled() && libraryTrack.libraryId() == currentLibrary.id
+                   && (known.stat ? *known.stat == *stat
+                                  : std::cmp_equal(libraryTrack.modifiedTime(), stat->modifiedNs / 1000000));
+
+                if(unchanged) {
+                    if(!known.stat) {
+                        statsToStore.emplace(libraryTrack.id(), *stat);
+                    }
+                    if(known.moved) {
+                        tracksToUpdate.push_back(libraryTrack);
+                        ++stats.moved;
                     }
                     else {
-                        setTrackProps(track);
-                        tracksToStore.push_back(track);
+                        ++stats.skipped;
                     }
+                    ++tracksProcessed;
+                    reportProgress();
+                }
+                else {
+                    pendingTracks.emplace_back(libraryTrack, false, false, stat);
+                }
+            }
+            else if(stat) {
+                pendingTracks.emplace_back(Track{filepath}, true, false, stat);
+            }
+            else {
+                // Removed again before it could be scanned
+                ++tracksProcessed;
+                reportProgress();
+            }
 
-                    if(tracksToStore.size() >= BatchSize) {
-                        storeTracks(tracksToStore);
-                        emit self->scanUpdate({.addedTracks = tracksToStore, .updatedTracks = {}});
-                        tracksToStore.clear();
-                    }
+            return pendingTracks.size() < BatchSize || readPendingTracks();
+        };
+
+        totalTracks += static_cast<double>(filesToCheck.size());
+
+        for(const QString& filepath : filesToCheck) {
+            if(!self->mayRun() || !processFile(filepath)) {
+                return false;
+            }
+        }
+
+        // Tags are read as files are found rather than after the whole tree has been walked
+        FileEnumerator enumerator{dirs, extensions, EnumeratorThreads};
+
+        QStringList foundFiles;
+        while(!(foundFiles = enumerator.takeFiles(BatchSize)).empty()) {
+            totalTracks += static_cast<double>(foundFiles.size());
+
+            for(const auto& filepath : foundFiles) {
+                if(!self->mayRun() || !processFile(filepath)) {
+                    return false;
                 }
             }
+        }
 
-            reportProgress();
+        if(!readPendingTracks()) {
+            return false;
         }
 
-        for(auto& track : missingFiles | std::views::values) {
-            if(track.isInLibrary() || track.isEnabled()) {
-                track.setLibraryId(-1);
-                track.setIsEnabled(false);
-                tracksToUpdate.push_back(track);
+        // Only tracks not found above need to be checked on disk
+        TrackFieldMap missingFiles;
+        TrackFieldMap missingHashes;
+
+        for(const auto& [filepath, known] : knownFiles) {
+            if(known.found) {
+                continue;
+            }
+            if(!QFileInfo::exists(filepath)) {
+                missingFiles.emplace(known.track->filename(), *known.track);
+                missingHashes.emplace(known.track->hash(), *known.track);
+            }
+            else if(known.moved) {
+                // Moved outside of the directories walked, so is unchanged other than its path
+                tracksToUpdate.push_back(*known.track);
+                ++stats.moved;
             }
         }
 
+        for(Track& track : possiblyMoved) {
+            Track refoundTrack = matchMissingTrack(missingFiles, missingHashes, track);
+
+            if(refoundTrack.isInLibrary() || refoundTrack.isInDatabase()) {
+                missingHashes.erase(refoundTrack.hash());
+                missingFiles.erase(refoundTrack.filename());
+
+                refoundTrack.setFilePath(track.filepath());
+                setTrackProps(refoundTrack);
+                tracksToUpdate.push_back(refoundTrack);
+                ++stats.reread;
+            }
+            else {
+                setTrackProps(track);
+                tracksToStore.push_back(track);
+                ++stats.added;
+            }
+        }
+
+        for(auto& track : missingFiles | std::views::values) {
+            removeTrack(track);
+        }
+        for(Track& track : replacedTracks) {
+            removeTrack(track);
+        }
+
         storeTracks(tracksToStore);
         storeTracks(tracksToUpdate);
 
+        cacheStats(tracksToStore);
+        cacheStats(tracksToUpdate);
+        if(self->mayRun()) {
+            trackDatabase.storeFileStats(statsToStore);
+        }
+
         if(!tracksToStore.empty() || !tracksToUpdate.empty()) {
             emit self->scanUpdate({tracksToStore, tracksToUpdate});
         }
 
+        qInfo() << "[Library] Scanned" << currentLibrary.path << "-" << stats.skipped << "unchanged," << stats.reread
+                << "re-read," << stats.added << "added," << stats.moved << "moved," << stats.removed << "removed";
+        emit self->scanCompleted(stats);
+
         return true;
     }
 
@@ -286,7 +606,7 @@ void LibraryScanner::scanLibrary(const LibraryInfo& library, const TrackList& tr
         if(p->settings->value<Settings::Core::Internal::MonitorLibraries>() && !p->watchers.contains(library.id)) {
             p->addWatcher(library);
         }
-        p->getAndSaveAllTracks(library.path, tracks);
+        p->getAndSaveAllTracks({library.path}, {}, tracks);
     }
 
     if(state() == Paused) {
@@ -301,7 +621,8 @@ void LibraryScanner::scanLibrary(const LibraryInfo& library, const TrackList& tr
     }
 }
 
-void LibraryScanner::scanLibraryDirectory(const LibraryInfo& library, const QString& dir, const TrackList& tracks)
+void LibraryScanner::scanLibraryChanges(const LibraryInfo& library, const QStringList& dirs, const FileEvents& files,
+                                        const TrackList& tracks)
 {
     setState(Running);
 
@@ -309,7 +630,7 @@ void LibraryScanner::scanLibraryDirectory(const LibraryInfo& library, const QStr
 
     p->changeLibraryStatus(LibraryInfo::Status::Scanning);
 
-    p->getAndSaveAllTracks(dir, tracks);
+    p->getAndSaveAllTracks(dirs, files, tracks);
 
     if(state() == Paused) {
         p->changeLibraryStatus(LibraryInfo::Status::Pending);
@@ -329,6 +650,7 @@ void LibraryScanner::scanTracks(const TrackList& libraryTracks, const TrackList&
 
     TrackList tracksScanned;
     TrackList tracksToStore;
+    PendingTracks tracksToRead;
 
     TrackFieldMap trackMap;
     std::ranges::transform(libraryTracks, std::inserter(trackMap, trackMap.end()),
@@ -351,15 +673,28 @@ void LibraryScanner::scanTracks(const TrackList& libraryTracks, const TrackList&
             return;
         }
 
-        Track track{pendingTrack};
+        if(trackMap.contains(pendingTrack.filepath())) {
+            tracksScanned.push_back(trackMap.at(pendingTrack.filepath()));
+            ++p->tracksProcessed;
+            p->reportProgress();
+        }
+        else {
+            tracksToRead.emplace_back(pendingTrack, true);
+        }
+    }
 
+    p->readTracks(tracksToRead);
+
+    if(!mayRun()) {
+        handleFinished();
+        return;
+    }
+
+    for(const PendingTrack& pending : tracksToRead) {
         ++p->tracksProcessed;
 
-        if(trackMap.contains(track.filepath())) {
-            tracksScanned.push_back(trackMap.at(track.filepath()));
-        }
-        else if(Tagging::readMetaData(track)) {
-            tracksToStore.push_back(track);
+        if(pending.metadataRead) {
+            tracksToStore.push_back(pending.track);
         }
 
         p->reportProgress();
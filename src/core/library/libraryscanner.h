@@ -19,7 +19,10 @@
 
 #pragma once
 
+#include "fycore_export.h"
+
 #include "library/libraryinfo.h"
+#include "library/librarywatcher.h"
 
 #include <core/trackfwd.h>
 #include <utils/database/dbconnectionpool.h>
@@ -35,7 +38,16 @@ struct ScanResult
     TrackList updatedTracks;
 };
 
-class LibraryScanner : public Worker
+struct ScanStats
+{
+    int skipped{0};
+    int reread{0};
+    int added{0};
+    int removed{0};
+    int moved{0};
+};
+
+class FYCORE_EXPORT LibraryScanner : public Worker
 {
     Q_OBJECT
 
@@ -50,13 +62,19 @@ signals:
     void progressChanged(int percent);
     void statusChanged(const LibraryInfo& library);
     void scanUpdate(const ScanResult& result);
+    void scanCompleted(const ScanStats& stats);
     void scannedTracks(const TrackList& tracks);
-    void directoryChanged(const LibraryInfo& library, const QString& dir);
+    //! Reported by a library's watcher, with @p files holding changes to individual files
+    void libraryChanged(const LibraryInfo& library, const QStringList& dirs, const FileEvents& files);
+    //! Emitted once all of @p library is being watched for changes
+    void libraryWatched(const LibraryInfo& library);
 
 public slots:
     void setupWatchers(const LibraryInfoMap& libraries, bool enabled);
     void scanLibrary(const LibraryInfo& library, const TrackList& tracks);
-    void scanLibraryDirectory(const LibraryInfo& library, const QString& dir, const TrackList& tracks);
+    //! Rescans @p dirs and applies @p files, where @p tracks should be the library tracks affected by either
+    void scanLibraryChanges(const LibraryInfo& library, const QStringList& dirs, const FileEvents& files,
+                            const TrackList& tracks);
     void scanTracks(const TrackList& libraryTracks, const TrackList& tracks);
 
 private:
@@ -0,0 +1,272 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "librarysnapshot.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+#include <QThread>
+#include <QtConcurrent>
+
+#include <algorithm>
+
+namespace {
+constexpr quint32 SnapshotMagic   = 0x46594C53; // "FYLS"
+constexpr quint32 SnapshotVersion = 1;
+// Below this the records are decoded on the calling thread
+constexpr size_t ParallelReadThreshold = 10000;
+
+struct ReadChunk
+{
+    size_t begin{0};
+    size_t end{0};
+    bool ok{false};
+};
+
+void writeTrack(QDataStream& stream, const Fooyin::Track& track)
+{
+    stream << static_cast<qint32>(track.id()) << track.filepath() << track.relativePath() << track.title()
+           << static_cast<qint32>(track.trackNumber()) << static_cast<qint32>(track.trackTotal()) << track.artists()
+           << track.albumArtists() << track.album() << static_cast<qint32>(track.discNumber())
+           << static_cast<qint32>(track.discTotal()) << track.date() << track.composer() << track.performer()
+           << track.genres() << track.comment() << static_cast<quint64>(track.duration())
+           << static_cast<quint64>(track.fileSize()) << static_cast<qint32>(track.bitrate())
+           << static_cast<qint32>(track.sampleRate()) << track.serialiseExtrasTags()
+           << static_cast<qint32>(track.type()) << static_cast<quint64>(track.modifiedTime())
+           << static_cast<qint32>(track.libraryId()) << track.hash() << static_cast<quint64>(track.addedTime())
+           << static_cast<quint64>(track.firstPlayed()) << static_cast<quint64>(track.lastPlayed())
+           << static_cast<qint32>(track.playCount()) << track.isEnabled() << track.sort();
+}
+
+Fooyin::Track readTrack(QDataStream& stream)
+{
+    qint32 id{0}, trackNumber{0}, trackTotal{0}, discNumber{0}, discTotal{0}, bitrate{0}, sampleRate{0}, type{0},
+        libraryId{0}, playCount{0};
+    quint64 duration{0}, fileSize{0}, modifiedTime{0}, addedTime{0}, firstPlayed{0}, lastPlayed{0};
+    QString filepath, relativePath, title, album, date, composer, performer, comment, hash, sort;
+    QStringList artists, albumArtists, genres;
+    QByteArray extraTags;
+    bool enabled{true};
+
+    stream >> id >> filepath >> relativePath >> title >> trackNumber >> trackTotal >> artists >> albumArtists >> album
+        >> discNumber >> discTotal >> date >> composer >> performer >> genres >> comment >> duration >> fileSize
+        >> bitrate >> sampleRate >> extraTags >> type >> modifiedTime >> libraryId >> hash >> addedTime >> firstPlayed
+        >> lastPlayed >> playCount >> enabled >> sort;
+
+    Fooyin::Track track;
+
+    track.setId(id);
+    track.setFilePath(filepath);
+    track.setRelativePath(relativePath);
+    track.setTitle(title);
+    track.setTrackNumber(trackNumber);
+    track.setTrackTotal(trackTotal);
+    track.setArtists(artists);
+    track.setAlbumArtists(albumArtists);
+    track.setAlbum(album);
+    track.setDiscNumber(discNumber);
+    track.setDiscTotal(discTotal);
+    track.setDate(date);
+    track.setComposer(composer);
+    track.setPerformer(performer);
+    track.setGenres(genres);
+    track.setComment(comment);
+    track.setDuration(duration);
+    track.setFileSize(fileSize);
+    track.setBitrate(bitrate);
+    track.setSampleRate(sampleRate);
+    track.storeExtraTags(extraTags);
+    track.setType(static_cast<Fooyin::Track::Type>(type));
+    track.setModifiedTime(modifiedTime);
+    track.setLibraryId(libraryId);
+    // Set after the metadata so the setters above don't regenerate it
+    track.setHash(hash);
+    track.setAddedTime(addedTime);
+    track.setFirstPlayed(firstPlayed);
+    track.setLastPlayed(lastPlayed);
+    track.setPlayCount(playCount);
+    track.setIsEnabled(enabled);
+    track.setSort(sort);
+
+    return track;
+}
+
+void readChunk(const QByteArray& data, const std::vector<quint64>& offsets, Fooyin::TrackList& tracks,
+               ReadChunk& chunk)
+{
+    QDataStream stream{data};
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    // Records are contiguous, so only the start of each chunk needs looking up
+    if(!stream.device()->seek(static_cast<qint64>(offsets.at(chunk.begin)))) {
+        return;
+    }
+
+    for(size_t i{chunk.begin}; i < chunk.end; ++i) {
+        tracks[i] = readTrack(stream);
+        if(stream.status() != QDataStream::Ok) {
+            return;
+        }
+    }
+
+    chunk.ok = true;
+}
+} // namespace
+
+namespace Fooyin {
+LibrarySnapshot::LibrarySnapshot(QString filepath)
+    : m_filepath{std::move(filepath)}
+{ }
+
+QString LibrarySnapshot::filepath() const
+{
+    return m_filepath;
+}
+
+bool LibrarySnapshot::write(uint64_t generation, const QString& sort, const TrackList& tracks) const
+{
+    QSaveFile file{m_filepath};
+    if(!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "[Library] Failed to open snapshot" << m_filepath << ":" << file.errorString();
+        return false;
+    }
+
+    QDataStream stream{&file};
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    stream << SnapshotMagic << SnapshotVersion << static_cast<quint64>(generation) << sort
+           << static_cast<quint64>(tracks.size());
+
+    std::vector<quint64> offsets;
+    offsets.reserve(tracks.size());
+
+    for(const Track& track : tracks) {
+        offsets.push_back(static_cast<quint64>(file.pos()));
+        writeTrack(stream, track);
+    }
+
+    // The offset table follows the records, with its position stored in the last 8 bytes
+    const auto tableOffset = static_cast<quint64>(file.pos());
+    for(const quint64 offset : offsets) {
+        stream << offset;
+    }
+    stream << tableOffset;
+
+    if(stream.status() != QDataStream::Ok) {
+        qWarning() << "[Library] Failed to write snapshot" << m_filepath;
+        file.cancelWriting();
+        return false;
+    }
+
+    return file.commit();
+}
+
+std::optional<LibrarySnapshot::Contents> LibrarySnapshot::read(uint64_t generation) const
+{
+    QFile file{m_filepath};
+    if(!file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+
+    const qint64 size = file.size();
+    if(size < static_cast<qint64>(sizeof(quint64))) {
+        return {};
+    }
+
+    // The mapping is released when the file is closed
+    const uchar* map = file.map(0, size);
+    if(!map) {
+        return {};
+    }
+
+    const QByteArray data = QByteArray::fromRawData(reinterpret_cast<const char*>(map), size);
+
+    QDataStream stream{data};
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic{0};
+    quint32 version{0};
+    quint64 snapshotGeneration{0};
+
+    stream >> magic >> version >> snapshotGeneration;
+
+    if(stream.status() != QDataStream::Ok || magic != SnapshotMagic || version != SnapshotVersion
+       || snapshotGeneration != generation) {
+        return {};
+    }
+
+    Contents contents;
+    contents.generation = snapshotGeneration;
+
+    quint64 count{0};
+    stream >> contents.sort >> count;
+
+    quint64 tableOffset{0};
+    stream.device()->seek(size - static_cast<qint64>(sizeof(quint64)));
+    stream >> tableOffset;
+
+    if(stream.status() != QDataStream::Ok || count >= static_cast<quint64>(size) / sizeof(quint64)
+       || tableOffset + ((count + 1) * sizeof(quint64)) != static_cast<quint64>(size)) {
+        qWarning() << "[Library] Ignoring malformed snapshot" << m_filepath;
+        return {};
+    }
+
+    if(count == 0) {
+        return contents;
+    }
+
+    std::vector<quint64> offsets(count);
+    stream.device()->seek(static_cast<qint64>(tableOffset));
+    for(quint64& offset : offsets) {
+        stream >> offset;
+    }
+
+    contents.tracks.resize(count);
+
+    std::vector<ReadChunk> chunks;
+    const size_t chunkCount = count >= ParallelReadThreshold ? std::max(1, QThread::idealThreadCount()) : 1;
+    const size_t chunkSize  = (count + chunkCount - 1) / chunkCount;
+
+    for(size_t begin{0}; begin < count; begin += chunkSize) {
+        chunks.push_back({.begin = begin, .end = std::min<size_t>(begin + chunkSize, count)});
+    }
+
+    if(chunks.size() == 1) {
+        readChunk(data, offsets, contents.tracks, chunks.front());
+    }
+    else {
+        QtConcurrent::blockingMap(chunks, [&data, &offsets, &contents](ReadChunk& chunk) {
+            readChunk(data, offsets, contents.tracks, chunk);
+        });
+    }
+
+    if(!std::ranges::all_of(chunks, &ReadChunk::ok)) {
+        qWarning() << "[Library] Ignoring malformed snapshot" << m_filepath;
+        return {};
+    }
+
+    return contents;
+}
+
+void LibrarySnapshot::remove() const
+{
+    QFile::remove(m_filepath);
+}
+} // namespace Fooyin
@@ -0,0 +1,64 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fycore_export.h"
+
+#include <core/track.h>
+
+#include <optional>
+
+namespace Fooyin {
+/*!
+ * A binary copy of the sorted library, written on shutdown so the next start can skip
+ * reading every track from the database and evaluating the sort script again.
+ *
+ * The file holds a header, the tracks themselves and then a table of record offsets,
+ * with the table's position stored in the last 8 bytes. It's read through a memory map,
+ * with the offset table letting the records be decoded in parallel. A snapshot is only
+ * used if its generation matches the database's (see TrackDatabase::generation).
+ *
+ * Tracks are stored with their sort strings rather than collation keys, as QCollatorSortKey
+ * can't be serialised. The keys are calculated again when the tracks are added to the index.
+ */
+class FYCORE_EXPORT LibrarySnapshot
+{
+public:
+    struct Contents
+    {
+        uint64_t generation{0};
+        QString sort;
+        TrackList tracks;
+    };
+
+    explicit LibrarySnapshot(QString filepath);
+
+    [[nodiscard]] QString filepath() const;
+
+    //! Writes @p tracks, which must already be sorted by @p sort
+    bool write(uint64_t generation, const QString& sort, const TrackList& tracks) const;
+    //! Reads the snapshot if it exists and was written at @p generation
+    [[nodiscard]] std::optional<Contents> read(uint64_t generation) const;
+    void remove() const;
+
+private:
+    QString m_filepath;
+};
+} // namespace Fooyin
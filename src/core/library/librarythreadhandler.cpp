@@ -29,6 +29,7 @@
 #include <QThread>
 
 #include <deque>
+#include <set>
 
 namespace {
 int nextRequestId()
@@ -44,7 +45,8 @@ struct LibraryScanRequest
     int id;
     ScanRequest::Type type;
     LibraryInfo library;
-    QString dir;
+    QStringList dirs;
+    FileEvents files;
     TrackList tracks;
 };
 
@@ -57,11 +59,14 @@ struct LibraryThreadHandler::Private
     SettingsManager* settings;
 
     QThread thread;
+    // Separate from the scanner so metadata writes and scans don't wait on each other
+    QThread databaseThread;
     LibraryScanner scanner;
     TrackDatabaseManager trackDatabaseManager;
 
     std::deque<LibraryScanRequest> scanRequests;
     int currentRequestId{-1};
+    std::set<int> pendingTrackWrites;
 
     Private(LibraryThreadHandler* self_, DbConnectionPoolPtr dbPool_, MusicLibrary* library_,
             SettingsManager* settings_)
@@ -73,7 +78,7 @@ struct LibraryThreadHandler::Private
         , trackDatabaseManager{dbPool}
     {
         scanner.moveToThread(&thread);
-        trackDatabaseManager.moveToThread(&thread);
+        trackDatabaseManager.moveToThread(&databaseThread);
 
         QObject::connect(library, &MusicLibrary::tracksScanned, self, [this]() {
             if(!scanRequests.empty()) {
@@ -82,6 +87,7 @@ struct LibraryThreadHandler::Private
         });
 
         thread.start();
+        databaseThread.start();
     }
 
     void scanLibrary(const LibraryScanRequest& request)
@@ -96,10 +102,27 @@ struct LibraryThreadHandler::Private
                                   [this, request]() { scanner.scanTracks(library->tracks(), request.tracks); });
     }
 
-    void scanDirectory(const LibraryScanRequest& request)
+    void scanChanges(const LibraryScanRequest& request)
     {
-        QMetaObject::invokeMethod(&scanner, [this, request]() {
-            scanner.scanLibraryDirectory(request.library, request.dir, library->tracks());
+        // Only tracks within the changed directories or at the changed files can have been affected
+        TrackList tracks;
+        for(const QString& dir : request.dirs) {
+            const TrackList dirTracks = library->tracksInDirectory(dir);
+            tracks.insert(tracks.end(), dirTracks.cbegin(), dirTracks.cend());
+        }
+
+        QStringList filepaths;
+        for(const FileEvent& event : request.files) {
+            filepaths.append(event.path);
+            if(!event.oldPath.isEmpty()) {
+                filepaths.append(event.oldPath);
+            }
+        }
+        const TrackList fileTracks = library->tracksForPaths(filepaths);
+        tracks.insert(tracks.end(), fileTracks.cbegin(), fileTracks.cend());
+
+        QMetaObject::invokeMethod(&scanner, [this, request, tracks]() {
+            scanner.scanLibraryChanges(request.library, request.dirs, request.files, tracks);
         });
     }
 
@@ -111,7 +134,7 @@ struct LibraryThreadHandler::Private
                                 cancelScanRequest(id);
                             }};
 
-        scanRequests.emplace_back(id, ScanRequest::Library, libraryInfo, QStringLiteral(""), TrackList{});
+        scanRequests.emplace_back(id, ScanRequest::Library, libraryInfo, QStringList{}, FileEvents{}, TrackList{});
 
         if(scanRequests.size() == 1) {
             execNextRequest();
@@ -128,7 +151,7 @@ struct LibraryThreadHandler::Private
                                 cancelScanRequest(id);
                             }};
 
-        scanRequests.emplace_front(id, ScanRequest::Tracks, LibraryInfo{}, QStringLiteral(""), tracks);
+        scanRequests.emplace_front(id, ScanRequest::Tracks, LibraryInfo{}, QStringList{}, FileEvents{}, tracks);
 
         // Track scans take precedence
         const auto currRequest = currentRequest();
@@ -143,15 +166,36 @@ struct LibraryThreadHandler::Private
         return request;
     }
 
-    ScanRequest addDirectoryScanRequest(const LibraryInfo& libraryInfo, const QString& dir)
+    ScanRequest addChangesScanRequest(const LibraryInfo& libraryInfo, const QStringList& dirs, const FileEvents& files)
     {
+        // Fold into a queued scan of the same library rather than walking the same directories twice
+        const auto pendingIt = std::ranges::find_if(scanRequests, [this, &libraryInfo](const auto& request) {
+            return request.id != currentRequestId && request.type == ScanRequest::Library
+                && request.library.id == libraryInfo.id;
+        });
+        if(pendingIt != scanRequests.end()) {
+            // A full scan will pick up the changes anyway
+            if(!pendingIt->dirs.empty() || !pendingIt->files.empty()) {
+                for(const QString& dir : dirs) {
+                    if(!pendingIt->dirs.contains(dir)) {
+                        pendingIt->dirs.append(dir);
+                    }
+                }
+                pendingIt->files.insert(pendingIt->files.end(), files.cbegin(), files.cend());
+            }
+            const int id = pendingIt->id;
+            return {.type = ScanRequest::Library, .id = id, .cancel = [this, id]() {
+                        cancelScanRequest(id);
+                    }};
+        }
+
         const int id = nextRequestId();
 
         ScanRequest request{.type = ScanRequest::Library, .id = id, .cancel = [this, id]() {
                                 cancelScanRequest(id);
                             }};
 
-        scanRequests.emplace_back(id, ScanRequest::Library, libraryInfo, dir, TrackList{});
+        scanRequests.emplace_back(id, ScanRequest::Library, libraryInfo, dirs, files, TrackList{});
 
         if(scanRequests.size() == 1) {
             execNextRequest();
@@ -184,11 +228,11 @@ struct LibraryThreadHandler::Private
                 scanTracks(request);
                 break;
             case(ScanRequest::Library):
-                if(request.dir.isEmpty()) {
+                if(request.dirs.empty() && request.files.empty()) {
                     scanLibrary(request);
                 }
                 else {
-                    scanDirectory(request);
+                    scanChanges(request);
                 }
                 break;
         }
@@ -231,6 +275,17 @@ LibraryThreadHandler::LibraryThreadHandler(DbConnectionPoolPtr dbPool, MusicLibr
                      &LibraryThreadHandler::gotTracks);
     QObject::connect(&p->trackDatabaseManager, &TrackDatabaseManager::updatedTracks, this,
                      &LibraryThreadHandler::tracksUpdated);
+    QObject::connect(&p->trackDatabaseManager, &TrackDatabaseManager::tracksVerified, this,
+                     &LibraryThreadHandler::tracksVerified);
+    QObject::connect(&p->trackDatabaseManager, &TrackDatabaseManager::gotSnapshot, this,
+                     &LibraryThreadHandler::gotSnapshot);
+    QObject::connect(&p->trackDatabaseManager, &TrackDatabaseManager::writeProgress, this,
+                     &LibraryThreadHandler::writeProgress);
+    QObject::connect(&p->trackDatabaseManager, &TrackDatabaseManager::writeFailed, this,
+                     &LibraryThreadHandler::writeFailed);
+    // Emitted after the request's last updatedTracks, so the library has been sent every result by now
+    QObject::connect(&p->trackDatabaseManager, &TrackDatabaseManager::writeFinished, this,
+                     [this](int id) { p->pendingTrackWrites.erase(id); });
     QObject::connect(&p->scanner, &Worker::finished, this, [this]() { p->finishScanRequest(); });
     QObject::connect(&p->scanner, &LibraryScanner::progressChanged, this,
                      [this](int percent) { emit progressChanged(p->currentRequestId, percent); });
@@ -238,9 +293,10 @@ LibraryThreadHandler::LibraryThreadHandler(DbConnectionPoolPtr dbPool, MusicLibr
                      [this](const TrackList& tracks) { emit scannedTracks(p->currentRequestId, tracks); });
     QObject::connect(&p->scanner, &LibraryScanner::statusChanged, this, &LibraryThreadHandler::statusChanged);
     QObject::connect(&p->scanner, &LibraryScanner::scanUpdate, this, &LibraryThreadHandler::scanUpdate);
-    QObject::connect(
-        &p->scanner, &LibraryScanner::directoryChanged, this,
-        [this](const LibraryInfo& libraryInfo, const QString& dir) { p->addDirectoryScanRequest(libraryInfo, dir); });
+    QObject::connect(&p->scanner, &LibraryScanner::libraryChanged, this,
+                     [this](const LibraryInfo& libraryInfo, const QStringList& dirs, const FileEvents& files) {
+                         p->addChangesScanRequest(libraryInfo, dirs, files);
+                     });
 
     QMetaObject::invokeMethod(&p->scanner, &Worker::initialiseThread);
     QMetaObject::invokeMethod(&p->trackDatabaseManager, &Worker::initialiseThread);
@@ -248,11 +304,19 @@ LibraryThreadHandler::LibraryThreadHandler(DbConnectionPoolPtr dbPool, MusicLibr
 
 LibraryThreadHandler::~LibraryThreadHandler()
 {
+    if(!p->pendingTrackWrites.empty()) {
+        // Don't lose edits that haven't reached their files yet
+        QMetaObject::invokeMethod(&p->trackDatabaseManager, &TrackDatabaseManager::finishWrites,
+                                  Qt::BlockingQueuedConnection);
+    }
+
     p->scanner.stopThread();
     p->trackDatabaseManager.stopThread();
 
     p->thread.quit();
     p->thread.wait();
+    p->databaseThread.quit();
+    p->databaseThread.wait();
 }
 
 void LibraryThreadHandler::getAllTracks()
@@ -260,6 +324,12 @@ void LibraryThreadHandler::getAllTracks()
     QMetaObject::invokeMethod(&p->trackDatabaseManager, &TrackDatabaseManager::getAllTracks);
 }
 
+void LibraryThreadHandler::verifyTracks(const TrackList& tracks)
+{
+    QMetaObject::invokeMethod(&p->trackDatabaseManager,
+                              [this, tracks]() { p->trackDatabaseManager.verifyTracks(tracks); });
+}
+
 void LibraryThreadHandler::setupWatchers(const LibraryInfoMap& libraries, bool enabled)
 {
     QMetaObject::invokeMethod(&p->scanner,
@@ -291,10 +361,20 @@ void LibraryThreadHandler::libraryRemoved(int id)
     }
 }
 
-void LibraryThreadHandler::saveUpdatedTracks(const TrackList& tracks)
+WriteRequest LibraryThreadHandler::saveUpdatedTracks(const TrackList& tracks)
 {
+    const int id = nextRequestId();
+
+    p->pendingTrackWrites.emplace(id);
+
     QMetaObject::invokeMethod(&p->trackDatabaseManager,
-                              [this, tracks]() { p->trackDatabaseManager.updateTracks(tracks); });
+                              [this, id, tracks]() { p->trackDatabaseManager.updateTracks(id, tracks); });
+
+    return {.id = id, .cancel = [this, id]() {
+                if(p->pendingTrackWrites.contains(id)) {
+                    p->trackDatabaseManager.cancelWrite(id);
+                }
+            }};
 }
 
 void LibraryThreadHandler::saveUpdatedTrackStats(const TrackList& track)
@@ -307,6 +387,18 @@ void LibraryThreadHandler::cleanupTracks()
 {
     QMetaObject::invokeMethod(&p->trackDatabaseManager, &TrackDatabaseManager::cleanupTracks);
 }
+
+void LibraryThreadHandler::saveSnapshot(const TrackList& tracks, const QString& sort)
+{
+    if(!p->scanRequests.empty() || !p->pendingTrackWrites.empty()) {
+        // The database may hold changes the library hasn't seen yet
+        return;
+    }
+
+    QMetaObject::invokeMethod(
+        &p->trackDatabaseManager, [this, tracks, sort]() { p->trackDatabaseManager.saveSnapshot(tracks, sort); },
+        Qt::BlockingQueuedConnection);
+}
 } // namespace Fooyin
 
 #include "moc_librarythreadhandler.cpp"
@@ -21,7 +21,7 @@
 
 #include "library/libraryinfo.h"
 
-#include <core/trackfwd.h>
+#include <core/track.h>
 #include <utils/database/dbconnectionpool.h>
 
 #include <QObject>
@@ -31,6 +31,7 @@ class SettingsManager;
 class MusicLibrary;
 struct ScanResult;
 struct ScanRequest;
+struct WriteRequest;
 
 class LibraryThreadHandler : public QObject
 {
@@ -42,15 +43,18 @@ public:
     ~LibraryThreadHandler() override;
 
     void getAllTracks();
+    void verifyTracks(const TrackList& tracks);
 
     void setupWatchers(const LibraryInfoMap& libraries, bool enabled);
 
     ScanRequest scanLibrary(const LibraryInfo& library);
     ScanRequest scanTracks(const TrackList& tracks);
 
-    void saveUpdatedTracks(const TrackList& tracks);
+    WriteRequest saveUpdatedTracks(const TrackList& tracks);
     void saveUpdatedTrackStats(const TrackList& track);
     void cleanupTracks();
+    // Blocks until written; skipped while scans or track writes are still to reach the library
+    void saveSnapshot(const TrackList& tracks, const QString& sort);
 
     void libraryRemoved(int id);
 
@@ -60,8 +64,12 @@ signals:
     void statusChanged(const LibraryInfo& library);
     void scanUpdate(const ScanResult& result);
     void tracksUpdated(const TrackList& tracks);
+    void tracksVerified(const TrackIds& enabled, const TrackIds& disabled);
+    void writeProgress(int id, int processed, int total);
+    void writeFailed(int id, const TrackList& tracks);
 
     void gotTracks(const TrackList& result);
+    void gotSnapshot(const TrackList& result, const QString& sort);
 
 private:
     struct Private;
@@ -19,33 +19,710 @@
 
 #include "librarywatcher.h"
 
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
 #include <QTimer>
 
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <ranges>
+#include <thread>
+#include <unordered_map>
+
+#ifdef Q_OS_LINUX
+#include <dirent.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <sys/statfs.h>
+#include <unistd.h>
+#endif
+
 using namespace std::chrono_literals;
 
-constexpr auto Interval = 15ms;
+namespace {
+constexpr auto DefaultDelay        = 200ms;
+// Every walk stats the whole tree, which is slow on the network mounts that need polling
+constexpr auto DefaultPollInterval = 15min;
+
+using EventCallback = std::function<void(Fooyin::FileEvents)>;
+//! Called with the root of a tree once every directory within it is being monitored
+using ReadyCallback = std::function<void(const QString& root)>;
+
+bool isUnder(const QString& path, const QString& dir)
+{
+    return path == dir || (path.startsWith(dir) && path.at(dir.size()) == u'/');
+}
+
+/*!
+ * Walks each tree on an interval, comparing modification times and sizes against the
+ * previous walk. Moves are reported as a removal and a creation.
+ */
+class PollingMonitor
+{
+public:
+    PollingMonitor(EventCallback callback, ReadyCallback ready, std::chrono::seconds interval)
+        : m_callback{std::move(callback)}
+        , m_ready{std::move(ready)}
+        , m_interval{interval}
+        , m_thread{[this]() { run(); }}
+    { }
+
+    ~PollingMonitor()
+    {
+        {
+            const std::scoped_lock lock{m_mutex};
+            m_quit = true;
+        }
+        m_cv.notify_all();
+        m_thread.join();
+    }
+
+    void addPath(const QString& path)
+    {
+        {
+            const std::scoped_lock lock{m_mutex};
+            m_newRoots.push_back(path);
+        }
+        m_cv.notify_all();
+    }
+
+    void setInterval(std::chrono::seconds interval)
+    {
+        {
+            const std::scoped_lock lock{m_mutex};
+            m_interval = interval;
+        }
+        m_cv.notify_all();
+    }
+
+private:
+    struct Entry
+    {
+        int64_t modified{0};
+        int64_t size{0};
+        bool isDir{false};
+    };
+    using Entries = std::unordered_map<QString, Entry>;
+
+    void run()
+    {
+        std::vector<std::pair<QString, Entries>> roots;
+        auto lastPoll = std::chrono::steady_clock::now();
+
+        std::unique_lock lock{m_mutex};
+
+        while(!m_quit) {
+            const auto interval = m_interval;
+            m_cv.wait_until(lock, lastPoll + interval, [this, interval]() {
+                return m_quit || !m_newRoots.empty() || m_interval != interval;
+            });
+            if(m_quit) {
+                break;
+            }
+
+            const auto newRoots = std::exchange(m_newRoots, {});
+            const bool poll     = std::chrono::steady_clock::now() >= lastPoll + m_interval;
+            lock.unlock();
+
+            // The first walk of a tree only establishes what's there
+            for(const QString& root : newRoots) {
+                roots.emplace_back(root, walk(root));
+                m_ready(root);
+            }
+
+            if(poll) {
+                for(auto& [root, entries] : roots) {
+                    Entries current = walk(root);
+                    Fooyin::FileEvents events = compare(entries, current);
+                    entries                   = std::move(current);
+
+                    if(!events.empty()) {
+                        m_callback(std::move(events));
+                    }
+                }
+                lastPoll = std::chrono::steady_clock::now();
+            }
+
+            lock.lock();
+        }
+    }
+
+    [[nodiscard]] Entries walk(const QString& root) const
+    {
+        Entries entries;
+
+        // Follows symlinks, as the scanner does
+        QDirIterator it{root, QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden,
+                        QDirIterator::Subdirectories | QDirIterator::FollowSymlinks};
+        while(!m_quit && it.hasNext()) {
+            it.next();
+            const QFileInfo info = it.fileInfo();
+            entries.emplace(info.filePath(), Entry{.modified = info.lastModified().toMSecsSinceEpoch(),
+                                                   .size     = info.size(),
+                                                   .isDir    = info.isDir()});
+        }
+
+        return entries;
+    }
+
+    static Fooyin::FileEvents compare(const Entries& previous, const Entries& current)
+    {
+        using Type = Fooyin::FileEvent::Type;
+
+        Fooyin::FileEvents events;
+
+        for(const auto& [path, entry] : current) {
+            const auto prevIt = previous.find(path);
+            if(prevIt == previous.cend()) {
+                events.emplace_back(Type::Created, path, QString{}, entry.isDir);
+            }
+            else if(!entry.isDir && (entry.modified != prevIt->second.modified || entry.size != prevIt->second.size)) {
+                events.emplace_back(Type::Modified, path, QString{}, false);
+            }
+        }
+
+        for(const auto& [path, entry] : previous) {
+            if(!current.contains(path)) {
+                events.emplace_back(Type::Removed, path, QString{}, entry.isDir);
+            }
+        }
+
+        return events;
+    }
+
+    EventCallback m_callback;
+    ReadyCallback m_ready;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::atomic<bool> m_quit{false};
+    std::vector<QString> m_newRoots;
+    std::chrono::seconds m_interval;
+
+    std::thread m_thread;
+};
+
+#ifdef Q_OS_LINUX
+// Adding watches is interleaved with handling events so large trees don't delay them
+constexpr auto WatchBatchSize = 256;
+constexpr uint32_t WatchMask  = IN_CREATE | IN_DELETE | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR
+                             | IN_EXCL_UNLINK;
+
+// Filesystems whose changes may be made elsewhere, where inotify won't see them
+bool isRemoteFilesystem(const QString& path)
+{
+    constexpr std::array RemoteTypes{
+        0x6969L,     // NFS
+        0x517BL,     // SMB
+        0xFF534D42L, // CIFS
+        0xFE534D42L, // SMB2
+        0x65735546L, // FUSE
+        0x01021997L, // 9P
+        0x00C36400L, // Ceph
+        0x5346414FL, // AFS
+    };
+
+    struct statfs info{};
+    if(::statfs(QFile::encodeName(path).constData(), &info) != 0) {
+        return false;
+    }
+
+    return std::ranges::find(RemoteTypes, static_cast<long>(info.f_type)) != RemoteTypes.cend();
+}
+
+class InotifyMonitor
+{
+public:
+    //! Called with the root of a tree which can no longer be watched
+    using FallbackCallback = std::function<void(const QString& root)>;
+
+    InotifyMonitor(EventCallback callback, ReadyCallback ready, FallbackCallback fallback)
+        : m_callback{std::move(callback)}
+        , m_ready{std::move(ready)}
+        , m_fallback{std::move(fallback)}
+        , m_fd{::inotify_init1(IN_NONBLOCK | IN_CLOEXEC)}
+        , m_wakeFd{::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)}
+    {
+        if(isValid()) {
+            m_thread = std::thread{[this]() { run(); }};
+        }
+    }
+
+    ~InotifyMonitor()
+    {
+        if(m_thread.joinable()) {
+            m_quit = true;
+            wake();
+            m_thread.join();
+        }
+
+        if(m_fd >= 0) {
+            ::close(m_fd);
+        }
+        if(m_wakeFd >= 0) {
+            ::close(m_wakeFd);
+        }
+    }
+
+    [[nodiscard]] bool isValid() const
+    {
+        return m_fd >= 0 && m_wakeFd >= 0;
+    }
+
+    void addPath(const QString& path)
+    {
+        {
+            const std::scoped_lock lock{m_mutex};
+            m_newRoots.push_back(path);
+        }
+        wake();
+    }
+
+private:
+    void wake() const
+    {
+        const uint64_t value{1};
+        [[maybe_unused]] const auto written = ::write(m_wakeFd, &value, sizeof(value));
+    }
+
+    void run()
+    {
+        std::array fds{pollfd{.fd = m_fd, .events = POLLIN, .revents = 0},
+                       pollfd{.fd = m_wakeFd, .events = POLLIN, .revents = 0}};
+
+        while(!m_quit) {
+            const int timeout = m_pendingDirs.empty() ? -1 : 0;
+            if(::poll(fds.data(), fds.size(), timeout) < 0 && errno != EINTR) {
+                qWarning() << "[Library] Stopped monitoring for changes:" << std::strerror(errno);
+                return;
+            }
+
+            if(fds[1].revents & POLLIN) {
+                uint64_t value{0};
+                [[maybe_unused]] const auto bytesRead = ::read(m_wakeFd, &value, sizeof(value));
+
+                const std::scoped_lock lock{m_mutex};
+                for(const QString& root : std::exchange(m_newRoots, {})) {
+                    m_roots.push_back(root);
+                    m_settingUp.push_back(root);
+                    m_pendingDirs.push_back(root);
+                }
+            }
+
+            if(fds[0].revents & POLLIN) {
+                Fooyin::FileEvents events = readEvents();
+                if(!events.empty()) {
+                    m_callback(std::move(events));
+                }
+            }
+
+            addWatches();
+
+            if(m_pendingDirs.empty()) {
+                for(const QString& root : std::exchange(m_settingUp, {})) {
+                    m_ready(root);
+                }
+            }
+        }
+    }
+
+    Fooyin::FileEvents readEvents()
+    {
+        using Type = Fooyin::FileEvent::Type;
+
+        Fooyin::FileEvents events;
+        // Events for the first half of a move, by cookie
+        std::unordered_map<uint32_t, size_t> moves;
+
+        alignas(inotify_event) std::array<char, 16384> buffer;
+
+        ssize_t length{0};
+        while((length = ::read(m_fd, buffer.data(), buffer.size())) > 0) {
+            for(const char* ptr = buffer.data(); ptr < buffer.data() + length;) {
+                const auto* event = reinterpret_cast<const inotify_event*>(ptr);
+                ptr += sizeof(inotify_event) + event->len;
+
+                if(event->mask & IN_Q_OVERFLOW) {
+                    // Changes were lost, so have everything rechecked
+                    for(const QString& root : m_roots) {
+                        events.emplace_back(Type::Modified, root, QString{}, true);
+                    }
+                    continue;
+                }
+
+                const auto watchIt = m_watches.find(event->wd);
+                if(watchIt == m_watches.cend()) {
+                    continue;
+                }
+
+                if(event->mask & IN_IGNORED) {
+                    m_watchDescriptors.erase(watchIt->second);
+                    m_watches.erase(watchIt);
+                    continue;
+                }
+
+                if(event->len == 0) {
+                    continue;
+                }
+
+                const QString path = watchIt->second + u'/' + QFile::decodeName(event->name);
+                const bool isDir   = event->mask & IN_ISDIR;
+
+                if(event->mask & IN_CREATE) {
+                    events.emplace_back(Type::Created, path, QString{}, isDir);
+                    if(isDir) {
+                        m_pendingDirs.push_back(path);
+                    }
+                }
+                else if(event->mask & IN_CLOSE_WRITE) {
+                    events.emplace_back(Type::Modified, path, QString{}, isDir);
+                }
+                else if(event->mask & IN_DELETE) {
+                    events.emplace_back(Type::Removed, path, QString{}, isDir);
+                }
+                else if(event->mask & IN_MOVED_FROM) {
+                    // Becomes a move if the other half arrives
+                    moves.emplace(event->cookie, events.size());
+                    events.emplace_back(Type::Removed, path, QString{}, isDir);
+                }
+                else if(event->mask & IN_MOVED_TO) {
+                    if(const auto moveIt = moves.find(event->cookie); moveIt != moves.cend()) {
+                        Fooyin::FileEvent& moved = events.at(moveIt->second);
+                        moved.type               = Type::Moved;
+                        moved.oldPath            = std::exchange(moved.path, path);
+                        if(isDir) {
+                            renameWatches(moved.oldPath, path);
+                        }
+                        moves.erase(moveIt);
+                    }
+                    else {
+                        events.emplace_back(Type::Created, path, QString{}, isDir);
+                        if(isDir) {
+                            m_pendingDirs.push_back(path);
+                        }
+                    }
+                }
+            }
+        }
+
+        // Anything left was moved out of the watched trees
+        for(const size_t index : moves | std::views::values) {
+            const Fooyin::FileEvent& event = events.at(index);
+            if(event.isDir) {
+                removeWatches(event.path);
+            }
+        }
+
+        return events;
+    }
+
+    void addWatches()
+    {
+        for(int i{0}; i < WatchBatchSize && !m_pendingDirs.empty(); ++i) {
+            const QString dir = m_pendingDirs.front();
+            m_pendingDirs.pop_front();
+
+            const QByteArray encodedDir = QFile::encodeName(dir);
+
+            const int wd = ::inotify_add_watch(m_fd, encodedDir.constData(), WatchMask);
+            if(wd < 0) {
+                if(errno == ENOSPC) {
+                    fallBack(dir);
+                }
+                // Otherwise the directory has gone or can't be read
+                continue;
+            }
+
+            if(m_watches.contains(wd)) {
+                // Already watched through another path (i.e. a symlink loop)
+                continue;
+            }
+
+            m_watches.emplace(wd, dir);
+            m_watchDescriptors.emplace(dir, wd);
+
+            queueSubdirs(dir, encodedDir);
+        }
+    }
+
+    void queueSubdirs(const QString& dir, const QByteArray& encodedDir)
+    {
+        DIR* handle = ::opendir(encodedDir.constData());
+        if(!handle) {
+            return;
+        }
+
+        while(const dirent* entry = ::readdir(handle)) {
+            const std::string_view name{entry->d_name};
+            if(name == "." || name == "..") {
+                continue;
+            }
+
+            bool isDir = entry->d_type == DT_DIR;
+            if(entry->d_type == DT_LNK || entry->d_type == DT_UNKNOWN) {
+                // Follows symlinks, as the scanner does
+                struct stat info{};
+                const QByteArray entryPath = encodedDir + '/' + entry->d_name;
+                isDir = ::stat(entryPath.constData(), &info) == 0 && S_ISDIR(info.st_mode);
+            }
+
+            if(isDir) {
+                m_pendingDirs.push_back(dir + u'/' + QFile::decodeName(entry->d_name));
+            }
+        }
+
+        ::closedir(handle);
+    }
+
+    void fallBack(const QString& dir)
+    {
+        const auto rootIt = std::ranges::find_if(m_roots, [&dir](const QString& root) { return isUnder(dir, root); });
+        if(rootIt == m_roots.cend()) {
+            return;
+        }
+
+        const QString root = *rootIt;
+        m_roots.erase(rootIt);
+        // Reported as ready by the polling monitor instead
+        std::erase(m_settingUp, root);
+
+        qWarning() << "[Library] Reached the inotify watch limit while monitoring" << root
+                   << "; polling for changes instead";
+
+        removeWatches(root);
+        std::erase_if(m_pendingDirs, [&root](const QString& pendingDir) { return isUnder(pendingDir, root); });
+
+        m_fallback(root);
+    }
+
+    void removeWatches(const QString& dir)
+    {
+        std::erase_if(m_watches, [this, &dir](const auto& watch) {
+            if(!isUnder(watch.second, dir)) {
+                return false;
+            }
+            ::inotify_rm_watch(m_fd, watch.first);
+            m_watchDescriptors.erase(watch.second);
+            return true;
+        });
+    }
+
+    void renameWatches(const QString& from, const QString& to)
+    {
+        for(auto& [wd, path] : m_watches) {
+            if(isUnder(path, from)) {
+                m_watchDescriptors.erase(path);
+                path = to + path.sliced(from.size());
+                m_watchDescriptors.emplace(path, wd);
+            }
+        }
+    }
+
+    EventCallback m_callback;
+    ReadyCallback m_ready;
+    FallbackCallback m_fallback;
+
+    int m_fd;
+    int m_wakeFd;
+
+    std::mutex m_mutex;
+    std::vector<QString> m_newRoots;
+    std::atomic<bool> m_quit{false};
+
+    // Only used from the monitor thread
+    std::vector<QString> m_roots;
+    // Roots which haven't been reported as ready yet
+    std::vector<QString> m_settingUp;
+    std::deque<QString> m_pendingDirs;
+    std::unordered_map<int, QString> m_watches;
+    std::unordered_map<QString, int> m_watchDescriptors;
+
+    std::thread m_thread;
+};
+#endif
+} // namespace
 
 namespace Fooyin {
-LibraryWatcher::LibraryWatcher(QObject* parent)
-    : QFileSystemWatcher{parent}
-    , m_timer{new QTimer(this)}
+struct LibraryWatcher::Private
 {
-    m_timer->setSingleShot(true);
-    m_timer->setInterval(Interval);
+    LibraryWatcher* self;
+
+    QTimer* timer;
+
+    FileEvents pendingEvents;
+    // Index into pendingEvents of the latest event for each path
+    std::unordered_map<QString, size_t> pendingPaths;
 
-    QObject::connect(this, &QFileSystemWatcher::directoryChanged, this, [this](const QString& path) {
-        if(!m_dir.isEmpty() && path != m_dir) {
-            m_timer->stop();
-            emit libraryDirChanged(m_dir);
+    std::chrono::seconds pollInterval{DefaultPollInterval};
+    bool pollOnly{false};
+    std::unique_ptr<PollingMonitor> polling;
+#ifdef Q_OS_LINUX
+    std::unique_ptr<InotifyMonitor> inotify;
+#endif
+
+    explicit Private(LibraryWatcher* self_)
+        : self{self_}
+        , timer{new QTimer(self)}
+    {
+        timer->setSingleShot(true);
+        timer->setInterval(DefaultDelay);
+
+        QObject::connect(timer, &QTimer::timeout, self, [this]() { flushEvents(); });
+    }
+
+    EventCallback eventCallback()
+    {
+        return [this](FileEvents events) {
+            QMetaObject::invokeMethod(self, [this, events = std::move(events)]() { queueEvents(events); });
+        };
+    }
+
+    ReadyCallback readyCallback()
+    {
+        return [this](const QString& root) {
+            QMetaObject::invokeMethod(self, [this, root]() { emit self->watching(root); });
+        };
+    }
+
+    PollingMonitor* pollingMonitor()
+    {
+        if(!polling) {
+            polling = std::make_unique<PollingMonitor>(eventCallback(), readyCallback(), pollInterval);
+        }
+        return polling.get();
+    }
+
+#ifdef Q_OS_LINUX
+    InotifyMonitor* inotifyMonitor()
+    {
+        if(!inotify) {
+            inotify = std::make_unique<InotifyMonitor>(eventCallback(), readyCallback(), [this](const QString& root) {
+                QMetaObject::invokeMethod(self, [this, root]() { pollingMonitor()->addPath(root); });
+            });
+        }
+        return inotify->isValid() ? inotify.get() : nullptr;
+    }
+#endif
+
+    void addPath(const QString& path)
+    {
+#ifdef Q_OS_LINUX
+        if(!pollOnly && !isRemoteFilesystem(path)) {
+            if(auto* monitor = inotifyMonitor()) {
+                monitor->addPath(path);
+                return;
+            }
+        }
+#endif
+        pollingMonitor()->addPath(path);
+    }
+
+    void queueEvents(const FileEvents& events)
+    {
+        for(const FileEvent& event : events) {
+            addEvent(event);
+        }
+
+        // Not restarted, so a steady stream of changes is still reported every interval
+        if(!timer->isActive()) {
+            timer->start();
+        }
+    }
+
+    void addEvent(const FileEvent& event)
+    {
+        using Type = FileEvent::Type;
+
+        if(event.type == Type::Moved) {
+            pendingPaths.erase(event.oldPath);
+            pendingPaths.erase(event.path);
+            pendingEvents.push_back(event);
+            return;
+        }
+
+        if(const auto pathIt = pendingPaths.find(event.path); pathIt != pendingPaths.cend()) {
+            FileEvent& pending = pendingEvents.at(pathIt->second);
+
+            switch(pending.type) {
+                case(Type::Created):
+                    if(event.type == Type::Removed) {
+                        // Came and went, so drop it
+                        pending.path.clear();
+                        pendingPaths.erase(pathIt);
+                    }
+                    return;
+                case(Type::Removed):
+                    pending.type = event.type == Type::Created ? Type::Modified : event.type;
+                    return;
+                case(Type::Modified):
+                    pending.type = event.type == Type::Removed ? Type::Removed : Type::Modified;
+                    return;
+                case(Type::Moved):
+                    break;
+            }
         }
-        m_dir = path;
-        m_timer->start();
-    });
 
-    QObject::connect(m_timer, &QTimer::timeout, this, [this]() {
-        emit libraryDirChanged(m_dir);
-        m_dir.clear();
-    });
+        pendingPaths.emplace(event.path, pendingEvents.size());
+        pendingEvents.push_back(event);
+    }
+
+    void flushEvents()
+    {
+        FileEvents events;
+        std::ranges::copy_if(pendingEvents, std::back_inserter(events),
+                             [](const FileEvent& event) { return !event.path.isEmpty(); });
+
+        pendingEvents.clear();
+        pendingPaths.clear();
+
+        if(!events.empty()) {
+            emit self->filesChanged(events);
+        }
+    }
+};
+
+LibraryWatcher::LibraryWatcher(QObject* parent)
+    : QObject{parent}
+    , p{std::make_unique<Private>(this)}
+{ }
+
+LibraryWatcher::~LibraryWatcher() = default;
+
+void LibraryWatcher::addPath(const QString& path)
+{
+    const QString cleanPath = QDir::cleanPath(path);
+    if(!cleanPath.isEmpty()) {
+        p->addPath(cleanPath);
+    }
+}
+
+void LibraryWatcher::setDelay(std::chrono::milliseconds delay)
+{
+    p->timer->setInterval(delay);
+}
+
+void LibraryWatcher::setPollInterval(std::chrono::seconds interval)
+{
+    p->pollInterval = interval;
+    if(p->polling) {
+        p->polling->setInterval(interval);
+    }
+}
+
+void LibraryWatcher::setPollOnly(bool enabled)
+{
+    p->pollOnly = enabled;
 }
 } // namespace Fooyin
 
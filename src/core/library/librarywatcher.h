@@ -19,23 +19,64 @@
 
 #pragma once
 
-#include <QFileSystemWatcher>
+#include <QObject>
+#include <QString>
 
-class QTimer;
+#include <chrono>
+#include <memory>
+#include <vector>
 
 namespace Fooyin {
-class LibraryWatcher : public QFileSystemWatcher
+struct FileEvent
+{
+    enum class Type : uint8_t
+    {
+        Created,
+        Modified,
+        Removed,
+        Moved,
+    };
+
+    Type type;
+    QString path;
+    //! The previous path of a moved file or directory
+    QString oldPath;
+    bool isDir{false};
+};
+using FileEvents = std::vector<FileEvent>;
+
+/*!
+ * Monitors directory trees for changes to the files within them.
+ *
+ * On Linux, inotify is used directly, with watches added incrementally on a background
+ * thread. Network and FUSE mounts, trees which exceed the inotify watch limit and other
+ * platforms are polled instead.
+ */
+class LibraryWatcher : public QObject
 {
     Q_OBJECT
 
 public:
     explicit LibraryWatcher(QObject* parent = nullptr);
+    ~LibraryWatcher() override;
+
+    //! Starts watching @p path and every directory below it
+    void addPath(const QString& path);
+    //! Sets how long changes are collected before being reported
+    void setDelay(std::chrono::milliseconds delay);
+    //! Sets how often trees which can't be watched directly are walked for changes
+    void setPollInterval(std::chrono::seconds interval);
+    //! Polls paths added from now on even if they could be watched directly
+    void setPollOnly(bool enabled);
 
 signals:
-    void libraryDirChanged(const QString& path);
+    //! Changes seen within the delay, with successive events for the same path combined
+    void filesChanged(const FileEvents& events);
+    //! Emitted once @p path and every directory below it is being watched; earlier changes may be missed
+    void watching(const QString& path);
 
 private:
-    QTimer* m_timer;
-    QString m_dir;
+    struct Private;
+    std::unique_ptr<Private> p;
 };
 } // namespace Fooyin
@@ -19,17 +19,49 @@
 
 #include "trackdatabasemanager.h"
 
+#include "corepaths.h"
 #include "database/trackdatabase.h"
 #include "tagging/tagwriter.h"
 
 #include <core/track.h>
 #include <utils/database/dbconnectionhandler.h>
 
+#include <QDebug>
+#include <QFileInfo>
+#include <QThread>
+#include <QtConcurrent>
+
+#include <algorithm>
+
+namespace {
+constexpr size_t VerifyBatchSize = 1000;
+// Tracks per database transaction, and per progress report
+constexpr size_t WriteBatchSize = 200;
+// More writers than this just contend for the disk
+constexpr int MaxWriteThreads = 4;
+
+enum class WriteResult : uint8_t
+{
+    Skipped = 0,
+    Written,
+    Failed,
+};
+
+struct PendingWrite
+{
+    const Fooyin::Track* track;
+    WriteResult result{WriteResult::Skipped};
+};
+} // namespace
+
 namespace Fooyin {
 TrackDatabaseManager::TrackDatabaseManager(DbConnectionPoolPtr dbPool, QObject* parent)
     : Worker{parent}
     , m_dbPool{std::move(dbPool)}
-{ }
+    , m_snapshot{Core::librarySnapshotPath()}
+{
+    m_writePool.setMaxThreadCount(std::clamp(QThread::idealThreadCount(), 1, MaxWriteThreads));
+}
 
 void TrackDatabaseManager::initialiseThread()
 {
@@ -40,22 +72,54 @@ void TrackDatabaseManager::initialiseThread()
 
 void TrackDatabaseManager::getAllTracks()
 {
+    const uint64_t generation = m_trackDatabase.generation();
+    if(generation > 0) {
+        if(const auto snapshot = m_snapshot.read(generation)) {
+            m_snapshotGeneration = snapshot->generation;
+            m_snapshotSort       = snapshot->sort;
+            emit gotSnapshot(snapshot->tracks, snapshot->sort);
+            return;
+        }
+    }
+
     const TrackList tracks = m_trackDatabase.getAllTracks();
     emit gotTracks(tracks);
 }
 
-void TrackDatabaseManager::updateTracks(const TrackList& tracks)
+void TrackDatabaseManager::verifyTracks(const TrackList& tracks)
 {
-    TrackList tracksUpdated;
-
+    // Only the id, path and flag are kept, as the tracks may change while they're being checked
+    m_tracksToVerify.clear();
+    m_tracksToVerify.reserve(tracks.size());
     for(const Track& track : tracks) {
-        if(Tagging::writeMetaData(track) && m_trackDatabase.updateTrack(track)) {
-            tracksUpdated.emplace_back(track);
+        if(track.isInDatabase()) {
+            m_tracksToVerify.push_back({track.id(), track.filepath(), track.isEnabled()});
         }
     }
+    m_verifyPos = 0;
+
+    verifyNextBatch(++m_verifyGeneration);
+}
+
+void TrackDatabaseManager::cancelWrite(int id)
+{
+    const std::scoped_lock lock{m_cancelMutex};
+    m_cancelledWrites.emplace(id);
+}
+
+void TrackDatabaseManager::updateTracks(int id, const TrackList& tracks)
+{
+    m_writeRequests.emplace_back(id, tracks);
+
+    if(m_writeRequests.size() == 1) {
+        writeNextBatch();
+    }
+}
 
-    if(!tracksUpdated.empty()) {
-        emit updatedTracks(tracksUpdated);
+void TrackDatabaseManager::finishWrites()
+{
+    while(!m_writeRequests.empty()) {
+        writeNextBatch();
     }
 }
 
@@ -68,6 +132,136 @@ void TrackDatabaseManager::cleanupTracks()
 {
     m_trackDatabase.cleanupTracks();
 }
+
+void TrackDatabaseManager::saveSnapshot(const TrackList& tracks, const QString& sort)
+{
+    const uint64_t generation = m_trackDatabase.generation();
+    if(generation > 0 && generation == m_snapshotGeneration && sort == m_snapshotSort) {
+        // Nothing has been written since the snapshot was loaded
+        return;
+    }
+
+    if(generation == 0 || !m_snapshot.write(generation, sort, tracks)) {
+        m_snapshot.remove();
+        return;
+    }
+
+    m_snapshotGeneration = generation;
+    m_snapshotSort       = sort;
+}
+
+void TrackDatabaseManager::writeNextBatch()
+{
+    if(m_writeRequests.empty()) {
+        return;
+    }
+
+    WriteRequest& request = m_writeRequests.front();
+    const size_t total    = request.tracks.size();
+    const size_t end      = std::min(request.pos + WriteBatchSize, total);
+
+    std::vector<PendingWrite> writes;
+    writes.reserve(end - request.pos);
+    for(size_t i{request.pos}; i < end; ++i) {
+        writes.push_back({&request.tracks.at(i)});
+    }
+
+    // Each file is written through its own TagLib stream, so writes are independent
+    const int id = request.id;
+    QtConcurrent::blockingMap(&m_writePool, writes, [this, id](PendingWrite& write) {
+        if(!writeCancelled(id)) {
+            write.result = Tagging::writeMetaData(*write.track) ? WriteResult::Written : WriteResult::Failed;
+        }
+    });
+
+    TrackList written;
+    TrackList failed;
+    for(const PendingWrite& write : writes) {
+        if(write.result == WriteResult::Written) {
+            written.push_back(*write.track);
+        }
+        else if(write.result == WriteResult::Failed) {
+            failed.push_back(*write.track);
+        }
+    }
+
+    // One transaction per batch rather than per track
+    if(!m_trackDatabase.updateTracks(written)) {
+        qWarning() << "[Library] Failed to update" << written.size() << "tracks in the database";
+        failed.insert(failed.end(), written.cbegin(), written.cend());
+        written.clear();
+    }
+
+    if(!written.empty()) {
+        emit updatedTracks(written);
+    }
+    if(!failed.empty()) {
+        emit writeFailed(id, failed);
+    }
+
+    request.pos = end;
+
+    const bool cancelled = writeCancelled(id);
+    emit writeProgress(id, static_cast<int>(request.pos), static_cast<int>(total));
+
+    if(cancelled || request.pos >= total) {
+        if(cancelled) {
+            qInfo() << "[Library] Metadata write cancelled after" << request.pos << "of" << total << "tracks";
+        }
+
+        m_writeRequests.pop_front();
+        {
+            const std::scoped_lock lock{m_cancelMutex};
+            m_cancelledWrites.erase(id);
+        }
+        emit writeFinished(id);
+    }
+
+    if(!m_writeRequests.empty()) {
+        // Requeue between batches so reads and stat updates on this thread aren't held up
+        QMetaObject::invokeMethod(this, &TrackDatabaseManager::writeNextBatch, Qt::QueuedConnection);
+    }
+}
+
+bool TrackDatabaseManager::writeCancelled(int id)
+{
+    const std::scoped_lock lock{m_cancelMutex};
+    return m_cancelledWrites.contains(id);
+}
+
+void TrackDatabaseManager::verifyNextBatch(uint64_t generation)
+{
+    if(generation != m_verifyGeneration) {
+        // Superseded by a later call to verifyTracks
+        return;
+    }
+
+    const size_t end = std::min(m_verifyPos + VerifyBatchSize, m_tracksToVerify.size());
+
+    TrackIds enabledTracks;
+    TrackIds disabledTracks;
+
+    for(; m_verifyPos < end; ++m_verifyPos) {
+        const VerifyEntry& entry = m_tracksToVerify.at(m_verifyPos);
+        const bool exists        = QFileInfo::exists(entry.filepath);
+        if(exists != entry.enabled) {
+            (exists ? enabledTracks : disabledTracks).push_back(entry.id);
+        }
+    }
+
+    if(!enabledTracks.empty() || !disabledTracks.empty()) {
+        emit tracksVerified(enabledTracks, disabledTracks);
+    }
+
+    if(m_verifyPos < m_tracksToVerify.size()) {
+        // Requeue rather than loop so other requests on this thread aren't held up by large libraries
+        QMetaObject::invokeMethod(this, [this, generation]() { verifyNextBatch(generation); }, Qt::QueuedConnection);
+    }
+    else {
+        m_tracksToVerify.clear();
+        m_verifyPos = 0;
+    }
+}
 } // namespace Fooyin
 
 #include "moc_trackdatabasemanager.cpp"
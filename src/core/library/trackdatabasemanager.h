@@ -20,10 +20,17 @@
 #pragma once
 
 #include "database/trackdatabase.h"
+#include "library/librarysnapshot.h"
 
 #include <utils/database/dbconnectionhandler.h>
 #include <utils/worker.h>
 
+#include <QThreadPool>
+
+#include <deque>
+#include <mutex>
+#include <set>
+
 namespace Fooyin {
 class Database;
 
@@ -36,19 +43,68 @@ public:
 
     void initialiseThread() override;
 
+    //! Stops write request @p id after the files currently being written; safe to call from any thread
+    void cancelWrite(int id);
+
 signals:
     void gotTracks(const TrackList& tracks);
+    // Tracks from the snapshot are already sorted by @p sort
+    void gotSnapshot(const TrackList& tracks, const QString& sort);
     void updatedTracks(const TrackList& tracks);
+    //! Tracks found by verifyTracks whose files have reappeared (@p enabled) or gone missing (@p disabled)
+    void tracksVerified(const TrackIds& enabled, const TrackIds& disabled);
+
+    //! Emitted after each batch of write request @p id; @p processed includes failed tracks
+    void writeProgress(int id, int processed, int total);
+    //! Tracks from write request @p id whose files or database rows couldn't be updated
+    void writeFailed(int id, const TrackList& tracks);
+    //! Emitted after the last updatedTracks or writeFailed for request @p id
+    void writeFinished(int id);
 
 public slots:
     void getAllTracks();
-    void updateTracks(const TrackList& tracks);
+    // Checks the files of @p tracks exist in batches, cancelling any earlier pass still running
+    void verifyTracks(const TrackList& tracks);
+    // Writes metadata to files and the database in batches, queued behind any earlier requests
+    void updateTracks(int id, const TrackList& tracks);
+    // Completes all queued write requests before returning
+    void finishWrites();
     void updateTrackStats(const TrackList& track);
     void cleanupTracks();
+    void saveSnapshot(const TrackList& tracks, const QString& sort);
 
 private:
+    struct WriteRequest
+    {
+        int id;
+        TrackList tracks;
+        size_t pos{0};
+    };
+
+    struct VerifyEntry
+    {
+        int id;
+        QString filepath;
+        bool enabled;
+    };
+
+    void verifyNextBatch(uint64_t generation);
+    void writeNextBatch();
+    [[nodiscard]] bool writeCancelled(int id);
+
     DbConnectionPoolPtr m_dbPool;
     std::unique_ptr<DbConnectionHandler> m_dbHandler;
     TrackDatabase m_trackDatabase;
+    LibrarySnapshot m_snapshot;
+    uint64_t m_snapshotGeneration{0};
+    QString m_snapshotSort;
+    std::vector<VerifyEntry> m_tracksToVerify;
+    size_t m_verifyPos{0};
+    uint64_t m_verifyGeneration{0};
+
+    QThreadPool m_writePool;
+    std::deque<WriteRequest> m_writeRequests;
+    std::mutex m_cancelMutex;
+    std::set<int> m_cancelledWrites;
 };
 } // namespace Fooyin
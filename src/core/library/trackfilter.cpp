@@ -19,30 +19,17 @@
 
 #include <core/library/trackfilter.h>
 
+#include <core/library/trackquery.h>
 #include <core/track.h>
-#include <utils/helpers.h>
 
-namespace {
-bool containsSearch(const QString& text, const QString& search)
-{
-    return text.contains(search, Qt::CaseInsensitive);
-}
-
-// TODO: Support user-defined tags
-bool matchSearch(const Fooyin::Track& track, const QString& search)
+namespace Fooyin::Filter {
+TrackList filterTracks(const TrackList& tracks, const QString& search)
 {
-    if(search.isEmpty()) {
-        return true;
-    }
-
-    return containsSearch(track.artist(), search) || containsSearch(track.title(), search)
-        || containsSearch(track.album(), search) || containsSearch(track.albumArtist(), search);
+    return TrackQuery{search}.filter(tracks);
 }
-} // namespace
 
-namespace Fooyin::Filter {
-TrackList filterTracks(const TrackList& tracks, const QString& search)
+bool narrowsSearch(const QString& previous, const QString& search)
 {
-    return Fooyin::Utils::filter(tracks, [search](const Fooyin::Track& track) { return matchSearch(track, search); });
+    return TrackQuery{search}.narrows(TrackQuery{previous});
 }
 } // namespace Fooyin::Filter
@@ -0,0 +1,883 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <core/library/trackquery.h>
+
+#include <core/constants.h>
+#include <core/track.h>
+
+#include <QDateTime>
+#include <QRegularExpression>
+#include <QStringMatcher>
+#include <QThread>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <unordered_map>
+
+namespace {
+// Below this, splitting the evaluation across threads costs more than it saves
+constexpr size_t ParallelFilterThreshold = 10000;
+
+constexpr int64_t MinValue = std::numeric_limits<int64_t>::min();
+constexpr int64_t MaxValue = std::numeric_limits<int64_t>::max();
+
+constexpr int64_t MsPerHour = 3600000;
+constexpr int64_t MsPerDay  = 24 * MsPerHour;
+
+using Fooyin::Track;
+
+enum class Op : uint8_t
+{
+    Contains = 0,
+    Equals,
+    NotEquals,
+    Less,
+    LessEqual,
+    Greater,
+    GreaterEqual,
+};
+
+enum class FieldType : uint8_t
+{
+    Text = 0,
+    List,
+    Number,
+    Date,
+};
+
+using TextAccessor   = QString (Track::*)() const;
+using ListAccessor   = QStringList (Track::*)() const;
+using NumberAccessor = int64_t (*)(const Track&);
+
+struct Field
+{
+    FieldType type{FieldType::Text};
+    TextAccessor text{nullptr};
+    ListAccessor list{nullptr};
+    NumberAccessor number{nullptr};
+};
+
+template <auto Getter>
+int64_t numberValue(const Track& track)
+{
+    return static_cast<int64_t>((track.*Getter)());
+}
+
+int64_t durationSecs(const Track& track)
+{
+    return static_cast<int64_t>(track.duration() / 1000);
+}
+
+Field textField(TextAccessor accessor)
+{
+    return {.type = FieldType::Text, .text = accessor};
+}
+
+Field listField(ListAccessor accessor)
+{
+    return {.type = FieldType::List, .list = accessor};
+}
+
+Field numberField(NumberAccessor accessor)
+{
+    return {.type = FieldType::Number, .number = accessor};
+}
+
+Field dateField(NumberAccessor accessor)
+{
+    return {.type = FieldType::Date, .number = accessor};
+}
+
+const std::unordered_map<QString, Field>& builtinFields()
+{
+    using namespace Fooyin::Constants;
+
+    static const std::unordered_map<QString, Field> fields{
+        {QString::fromLatin1(MetaData::Title), textField(&Track::title)},
+        {QString::fromLatin1(MetaData::Artist), listField(&Track::artists)},
+        {QString::fromLatin1(MetaData::UniqueArtist), listField(&Track::uniqueArtists)},
+        {QString::fromLatin1(MetaData::Album), textField(&Track::album)},
+        {QString::fromLatin1(MetaData::AlbumArtist), listField(&Track::albumArtists)},
+        {QString::fromLatin1(MetaData::Track), numberField(numberValue<&Track::trackNumber>)},
+        {QString::fromLatin1(MetaData::TrackTotal), numberField(numberValue<&Track::trackTotal>)},
+        {QString::fromLatin1(MetaData::Disc), numberField(numberValue<&Track::discNumber>)},
+        {QString::fromLatin1(MetaData::DiscTotal), numberField(numberValue<&Track::discTotal>)},
+        {QString::fromLatin1(MetaData::Genre), listField(&Track::genres)},
+        {QString::fromLatin1(MetaData::Composer), textField(&Track::composer)},
+        {QString::fromLatin1(MetaData::Performer), textField(&Track::performer)},
+        {QString::fromLatin1(MetaData::Duration), numberField(durationSecs)},
+        {QString::fromLatin1(MetaData::Comment), textField(&Track::comment)},
+        {QString::fromLatin1(MetaData::Date), textField(&Track::date)},
+        {QString::fromLatin1(MetaData::Year), numberField(numberValue<&Track::year>)},
+        {QString::fromLatin1(MetaData::FileSize), numberField(numberValue<&Track::fileSize>)},
+        {QString::fromLatin1(MetaData::Bitrate), numberField(numberValue<&Track::bitrate>)},
+        {QString::fromLatin1(MetaData::SampleRate), numberField(numberValue<&Track::sampleRate>)},
+        {QString::fromLatin1(MetaData::PlayCount), numberField(numberValue<&Track::playCount>)},
+        {QString::fromLatin1(MetaData::Codec), textField(&Track::typeString)},
+        {QString::fromLatin1(MetaData::AddedTime), dateField(numberValue<&Track::addedTime>)},
+        {QString::fromLatin1(MetaData::ModifiedTime), dateField(numberValue<&Track::modifiedTime>)},
+        {QStringLiteral("firstplayed"), dateField(numberValue<&Track::firstPlayed>)},
+        {QStringLiteral("lastplayed"), dateField(numberValue<&Track::lastPlayed>)},
+        {QString::fromLatin1(MetaData::FilePath), textField(&Track::filepath)},
+        {QString::fromLatin1(MetaData::RelativePath), textField(&Track::relativePath)},
+        {QString::fromLatin1(MetaData::FileName), textField(&Track::filename)},
+        {QString::fromLatin1(MetaData::Extension), textField(&Track::extension)},
+        {QString::fromLatin1(MetaData::Path), textField(&Track::path)},
+    };
+
+    return fields;
+}
+
+enum class NodeType : uint8_t
+{
+    And = 0,
+    Or,
+    Not,
+    // A word or phrase searched for in the default fields
+    Text,
+    Field,
+    Tag,
+};
+
+struct Node
+{
+    NodeType type{NodeType::Text};
+    std::vector<Node> children;
+
+    Field field;
+    QString tag;
+    Op op{Op::Contains};
+    QString value;
+    QStringMatcher matcher;
+    // Inclusive bounds for numbers and dates
+    int64_t min{MinValue};
+    int64_t max{MaxValue};
+};
+
+Node textNode(const QString& text)
+{
+    Node node;
+    node.type    = NodeType::Text;
+    node.value   = text;
+    node.matcher = QStringMatcher{text, Qt::CaseInsensitive};
+    return node;
+}
+
+bool matchText(const Node& node, const QString& text)
+{
+    switch(node.op) {
+        case(Op::Contains):
+            return node.matcher.indexIn(text) >= 0;
+        case(Op::Equals):
+            return text.compare(node.value, Qt::CaseInsensitive) == 0;
+        case(Op::NotEquals):
+            return text.compare(node.value, Qt::CaseInsensitive) != 0;
+        default:
+            return false;
+    }
+}
+
+bool matchList(const Node& node, const QStringList& values)
+{
+    if(values.empty()) {
+        return matchText(node, {});
+    }
+    if(node.op == Op::NotEquals) {
+        return std::ranges::all_of(values, [&node](const QString& value) { return matchText(node, value); });
+    }
+    return std::ranges::any_of(values, [&node](const QString& value) { return matchText(node, value); });
+}
+
+bool matchRange(const Node& node, int64_t value)
+{
+    const bool inRange = value >= node.min && value <= node.max;
+    return node.op == Op::NotEquals ? !inRange : inRange;
+}
+
+bool containsAny(const Node& node, const QStringList& values)
+{
+    return std::ranges::any_of(values, [&node](const QString& value) { return node.matcher.indexIn(value) >= 0; });
+}
+
+bool evaluate(const Node& node, const Track& track)
+{
+    switch(node.type) {
+        case(NodeType::And):
+            return std::ranges::all_of(node.children, [&track](const Node& child) { return evaluate(child, track); });
+        case(NodeType::Or):
+            return std::ranges::any_of(node.children, [&track](const Node& child) { return evaluate(child, track); });
+        case(NodeType::Not):
+            return !evaluate(node.children.front(), track);
+        case(NodeType::Text):
+            return node.matcher.indexIn(track.title()) >= 0 || node.matcher.indexIn(track.album()) >= 0
+                || containsAny(node, track.artists()) || containsAny(node, track.albumArtists());
+        case(NodeType::Tag):
+            return matchList(node, track.extraTag(node.tag));
+        case(NodeType::Field):
+            switch(node.field.type) {
+                case(FieldType::Text):
+                    return matchText(node, (track.*node.field.text)());
+                case(FieldType::List):
+                    return matchList(node, (track.*node.field.list)());
+                case(FieldType::Number):
+                    return matchRange(node, node.field.number(track));
+                case(FieldType::Date): {
+                    const int64_t time = node.field.number(track);
+                    return time > 0 && matchRange(node, time);
+                }
+            }
+    }
+    return false;
+}
+
+// Inclusive range covered by a single value
+struct Interval
+{
+    int64_t min;
+    int64_t max;
+};
+
+std::optional<Interval> parseNumber(const QString& value, bool isDuration)
+{
+    if(isDuration && value.contains(u':')) {
+        // [h:]m:ss
+        int64_t secs{0};
+        const QStringList parts = value.split(u':');
+        if(parts.size() > 3) {
+            return {};
+        }
+        for(const QString& part : parts) {
+            bool ok{false};
+            const int64_t num = part.toLongLong(&ok);
+            if(!ok || num < 0) {
+                return {};
+            }
+            secs = (secs * 60) + num;
+        }
+        return Interval{secs, secs};
+    }
+
+    bool ok{false};
+    const int64_t num = value.toLongLong(&ok);
+    if(!ok) {
+        return {};
+    }
+    return Interval{num, num};
+}
+
+std::optional<Interval> parseDate(const QString& value, int64_t now)
+{
+    static const QRegularExpression relative{QStringLiteral("^(\\d+)([hdwy])$")};
+
+    if(const auto match = relative.match(value.toLower()); match.hasMatch()) {
+        const int64_t count = match.captured(1).toLongLong();
+        const QChar unit    = match.captured(2).front();
+
+        int64_t unitMs{MsPerDay};
+        if(unit == u'h') {
+            unitMs = MsPerHour;
+        }
+        else if(unit == u'w') {
+            unitMs = 7 * MsPerDay;
+        }
+        else if(unit == u'y') {
+            unitMs = 365 * MsPerDay;
+        }
+
+        const int64_t time = now - (count * unitMs);
+        return Interval{time, time};
+    }
+
+    const auto interval = [](const QDateTime& start, const QDateTime& end) -> std::optional<Interval> {
+        if(!start.isValid() || !end.isValid()) {
+            return {};
+        }
+        return Interval{start.toMSecsSinceEpoch(), end.toMSecsSinceEpoch() - 1};
+    };
+
+    if(value.compare(QLatin1String{"today"}, Qt::CaseInsensitive) == 0) {
+        const QDate today = QDateTime::fromMSecsSinceEpoch(now).date();
+        return interval(today.startOfDay(), today.addDays(1).startOfDay());
+    }
+
+    // Each date covers the whole of the period it gives
+    if(value.contains(u'T')) {
+        if(const QDateTime minute = QDateTime::fromString(value, QStringLiteral("yyyy-MM-dd'T'HH:mm"));
+           minute.isValid()) {
+            return interval(minute, minute.addSecs(60));
+        }
+        if(const QDateTime second = QDateTime::fromString(value, Qt::ISODate); second.isValid()) {
+            return interval(second, second.addSecs(1));
+        }
+    }
+    else if(const QDate year = QDate::fromString(value, QStringLiteral("yyyy")); year.isValid()) {
+        return interval(year.startOfDay(), year.addYears(1).startOfDay());
+    }
+    else if(const QDate month = QDate::fromString(value, QStringLiteral("yyyy-MM")); month.isValid()) {
+        return interval(month.startOfDay(), month.addMonths(1).startOfDay());
+    }
+    else if(const QDate day = QDate::fromString(value, Qt::ISODate); day.isValid()) {
+        return interval(day.startOfDay(), day.addDays(1).startOfDay());
+    }
+
+    return {};
+}
+
+enum class TokenType : uint8_t
+{
+    Word = 0,
+    Phrase,
+    LeftParen,
+    RightParen,
+    End,
+};
+
+struct Token
+{
+    TokenType type;
+    QString value;
+    int position;
+};
+
+std::vector<Token> tokenise(const QString& input)
+{
+    std::vector<Token> tokens;
+
+    const int length = static_cast<int>(input.size());
+    int pos{0};
+
+    while(pos < length) {
+        const QChar ch = input.at(pos);
+
+        if(ch.isSpace()) {
+            ++pos;
+        }
+        else if(ch == u'(') {
+            tokens.push_back({TokenType::LeftParen, {}, pos++});
+        }
+        else if(ch == u')') {
+            tokens.push_back({TokenType::RightParen, {}, pos++});
+        }
+        else if(ch == u'"') {
+            // An unterminated phrase runs to the end, so it still matches while being typed
+            const int start = pos++;
+            const int end   = static_cast<int>(input.indexOf(u'"', pos));
+            const int close = end < 0 ? length : end;
+            tokens.push_back({TokenType::Phrase, input.mid(pos, close - pos), start});
+            pos = close + 1;
+        }
+        else {
+            const int start = pos;
+            while(pos < length && !input.at(pos).isSpace() && input.at(pos) != u'(' && input.at(pos) != u')'
+                  && input.at(pos) != u'"') {
+                ++pos;
+            }
+            tokens.push_back({TokenType::Word, input.mid(start, pos - start), start});
+        }
+    }
+
+    tokens.push_back({TokenType::End, {}, length});
+    return tokens;
+}
+
+struct Predicate
+{
+    QString field;
+    Op op;
+    QString value;
+};
+
+// Splits "field<op>value" or "%tag%<op>value", returning nothing if the word is just text.
+// Only built-in fields are recognised without the %'s, so words such as "Wars:" are searched for as they are.
+std::optional<Predicate> splitPredicate(const QString& word)
+{
+    if(word.isEmpty()) {
+        return {};
+    }
+
+    QString field;
+    qsizetype i{0};
+
+    if(word.front() == u'%') {
+        const qsizetype end = word.indexOf(u'%', 1);
+        if(end <= 1) {
+            return {};
+        }
+        field = word.mid(1, end - 1).toLower();
+        i     = end + 1;
+    }
+    else if(word.front().isLetter()) {
+        while(i < word.size() && (word.at(i).isLetterOrNumber() || word.at(i) == u'_')) {
+            ++i;
+        }
+        field = word.left(i).toLower();
+        if(!builtinFields().contains(field)) {
+            return {};
+        }
+    }
+    else {
+        return {};
+    }
+
+    if(i >= word.size()) {
+        return {};
+    }
+
+    const QChar ch   = word.at(i);
+    const QChar next = i + 1 < word.size() ? word.at(i + 1) : QChar{};
+
+    if(ch == u':') {
+        return Predicate{field, Op::Contains, word.mid(i + 1)};
+    }
+    if(ch == u'=') {
+        return Predicate{field, Op::Equals, word.mid(i + 1)};
+    }
+    if(ch == u'!' && next == u'=') {
+        return Predicate{field, Op::NotEquals, word.mid(i + 2)};
+    }
+    if(ch == u'<') {
+        return next == u'=' ? Predicate{field, Op::LessEqual, word.mid(i + 2)}
+                            : Predicate{field, Op::Less, word.mid(i + 1)};
+    }
+    if(ch == u'>') {
+        return next == u'=' ? Predicate{field, Op::GreaterEqual, word.mid(i + 2)}
+                            : Predicate{field, Op::Greater, word.mid(i + 1)};
+    }
+
+    return {};
+}
+
+class QueryParser
+{
+public:
+    QueryParser(const QString& input, int64_t now)
+        : m_tokens{tokenise(input)}
+        , m_now{now}
+    { }
+
+    std::optional<Node> parse()
+    {
+        if(peek().type == TokenType::End) {
+            return {};
+        }
+
+        Node root = parseOr();
+        if(!m_error && peek().type != TokenType::End) {
+            // Only an unmatched ')' stops the top level early
+            fail(QStringLiteral("Unexpected ')'"));
+        }
+        return root;
+    }
+
+    [[nodiscard]] std::optional<QueryError> error() const
+    {
+        return m_error;
+    }
+
+private:
+    [[nodiscard]] const Token& peek() const
+    {
+        return m_tokens.at(m_pos);
+    }
+
+    const Token& next()
+    {
+        const Token& token = m_tokens.at(m_pos);
+        if(token.type != TokenType::End) {
+            ++m_pos;
+        }
+        return token;
+    }
+
+    [[nodiscard]] bool isKeyword(const char* keyword) const
+    {
+        return peek().type == TokenType::Word && peek().value == QLatin1String{keyword};
+    }
+
+    void fail(const QString& message)
+    {
+        failAt(peek().position, message);
+    }
+
+    void failAt(int position, const QString& message)
+    {
+        if(!m_error) {
+            m_error = QueryError{.position = position, .message = message};
+        }
+    }
+
+    static Node combine(NodeType type, std::vector<Node> children)
+    {
+        if(children.size() == 1) {
+            return std::move(children.front());
+        }
+        Node node;
+        node.type     = type;
+        node.children = std::move(children);
+        return node;
+    }
+
+    Node parseOr()
+    {
+        std::vector<Node> children;
+        children.push_back(parseAnd());
+
+        while(!m_error && isKeyword("OR")) {
+            next();
+            children.push_back(parseAnd());
+        }
+
+        return combine(NodeType::Or, std::move(children));
+    }
+
+    Node parseAnd()
+    {
+        std::vector<Node> children;
+        children.push_back(parseNot());
+
+        while(!m_error) {
+            const TokenType type = peek().type;
+            if(type == TokenType::End || type == TokenType::RightParen || isKeyword("OR")) {
+                break;
+            }
+            if(isKeyword("AND")) {
+                next();
+            }
+            children.push_back(parseNot());
+        }
+
+        return combine(NodeType::And, std::move(children));
+    }
+
+    Node parseNot()
+    {
+        if(isKeyword("NOT")) {
+            next();
+            Node node;
+            node.type = NodeType::Not;
+            node.children.push_back(parseNot());
+            return node;
+        }
+        return parsePrimary();
+    }
+
+    Node parsePrimary()
+    {
+        const Token& token = peek();
+
+        switch(token.type) {
+            case(TokenType::LeftParen): {
+                next();
+                Node node = parseOr();
+                if(!m_error && peek().type != TokenType::RightParen) {
+                    fail(QStringLiteral("Expected ')'"));
+                }
+                next();
+                return node;
+            }
+            case(TokenType::RightParen):
+                fail(QStringLiteral("Unexpected ')'"));
+                return {};
+            case(TokenType::End):
+                fail(QStringLiteral("Expected a search term"));
+                return {};
+            case(TokenType::Phrase):
+                return textNode(next().value);
+            case(TokenType::Word):
+                break;
+        }
+
+        if(isKeyword("AND") || isKeyword("OR")) {
+            fail(QStringLiteral("Unexpected '%1'").arg(token.value));
+            return {};
+        }
+
+        const Token& word = next();
+        if(auto predicate = splitPredicate(word.value)) {
+            if(predicate->value.isEmpty()) {
+                // field:"quoted value" or field: value
+                const TokenType type = peek().type;
+                if(type != TokenType::Word && type != TokenType::Phrase) {
+                    fail(QStringLiteral("Expected a value for '%1'").arg(predicate->field));
+                    return {};
+                }
+                predicate->value = next().value;
+            }
+            return parsePredicate(*predicate, word.position);
+        }
+
+        return textNode(word.value);
+    }
+
+    Node parsePredicate(const Predicate& predicate, int position)
+    {
+        Node node;
+        node.op = predicate.op;
+
+        const auto& fields = builtinFields();
+        if(const auto it = fields.find(predicate.field); it != fields.cend()) {
+            node.type  = NodeType::Field;
+            node.field = it->second;
+        }
+        else {
+            node.type = NodeType::Tag;
+            node.tag  = predicate.field.toUpper();
+        }
+
+        const bool isText = node.type == NodeType::Tag || node.field.type == FieldType::Text
+                         || node.field.type == FieldType::List;
+
+        if(isText) {
+            if(node.op != Op::Contains && node.op != Op::Equals && node.op != Op::NotEquals) {
+                failAt(position, QStringLiteral("'%1' can only be matched with ':', '=' or '!='").arg(predicate.field));
+                return {};
+            }
+            node.value   = predicate.value;
+            node.matcher = QStringMatcher{predicate.value, Qt::CaseInsensitive};
+            return node;
+        }
+
+        const bool isDate     = node.field.type == FieldType::Date;
+        const bool isDuration = predicate.field == QLatin1String{Fooyin::Constants::MetaData::Duration};
+
+        const auto parseValue = [this, isDate, isDuration](const QString& value) {
+            return isDate ? parseDate(value, m_now) : parseNumber(value, isDuration);
+        };
+        const auto invalidValue = [this, position, isDate](const QString& value) {
+            failAt(position, isDate ? QStringLiteral("'%1' is not a valid date").arg(value)
+                                    : QStringLiteral("'%1' is not a valid number").arg(value));
+        };
+
+        if(const qsizetype rangePos = predicate.value.indexOf(QLatin1String{".."}); rangePos >= 0) {
+            if(node.op != Op::Contains && node.op != Op::Equals) {
+                failAt(position, QStringLiteral("Ranges can only be matched with ':' or '='"));
+                return {};
+            }
+
+            const QString lower = predicate.value.left(rangePos);
+            const QString upper = predicate.value.mid(rangePos + 2);
+            if(lower.isEmpty() && upper.isEmpty()) {
+                invalidValue(predicate.value);
+                return {};
+            }
+
+            if(!lower.isEmpty()) {
+                const auto interval = parseValue(lower);
+                if(!interval) {
+                    invalidValue(lower);
+                    return {};
+                }
+                node.min = interval->min;
+            }
+            if(!upper.isEmpty()) {
+                const auto interval = parseValue(upper);
+                if(!interval) {
+                    invalidValue(upper);
+                    return {};
+                }
+                node.max = interval->max;
+            }
+            return node;
+        }
+
+        const auto interval = parseValue(predicate.value);
+        if(!interval) {
+            invalidValue(predicate.value);
+            return {};
+        }
+
+        switch(node.op) {
+            case(Op::Contains):
+            case(Op::Equals):
+            case(Op::NotEquals):
+                node.min = interval->min;
+                node.max = interval->max;
+                break;
+            case(Op::Less):
+                node.max = interval->min - 1;
+                break;
+            case(Op::LessEqual):
+                node.max = interval->max;
+                break;
+            case(Op::Greater):
+                node.min = interval->max + 1;
+                break;
+            case(Op::GreaterEqual):
+                node.min = interval->min;
+                break;
+        }
+        // Only NotEquals needs the op from here on
+        if(node.op != Op::NotEquals) {
+            node.op = Op::Equals;
+        }
+
+        return node;
+    }
+
+    std::vector<Token> m_tokens;
+    size_t m_pos{0};
+    int64_t m_now;
+    std::optional<QueryError> m_error;
+};
+
+struct FilterChunk
+{
+    size_t begin{0};
+    size_t end{0};
+    Fooyin::TrackList matches;
+};
+} // namespace
+
+namespace Fooyin {
+struct TrackQuery::Private
+{
+    QString query;
+    std::optional<Node> root;
+    std::optional<QueryError> error;
+    // Set if the query is only words and phrases joined by AND
+    std::optional<QStringList> terms;
+
+    explicit Private(QString query_)
+        : query{std::move(query_)}
+    {
+        QueryParser parser{query, QDateTime::currentMSecsSinceEpoch()};
+        root  = parser.parse();
+        error = parser.error();
+
+        if(error) {
+            // Fall back to a plain search for the whole query
+            root = textNode(query.trimmed());
+        }
+
+        if(!root) {
+            terms = QStringList{};
+        }
+        else if(root->type == NodeType::Text) {
+            terms = QStringList{root->value};
+        }
+        else if(root->type == NodeType::And
+                && std::ranges::all_of(root->children,
+                                       [](const Node& child) { return child.type == NodeType::Text; })) {
+            terms = QStringList{};
+            for(const Node& child : root->children) {
+                terms->push_back(child.value);
+            }
+        }
+    }
+};
+
+TrackQuery::TrackQuery()
+    : TrackQuery{QString{}}
+{ }
+
+TrackQuery::TrackQuery(const QString& query)
+    : p{std::make_shared<Private>(query)}
+{ }
+
+TrackQuery::~TrackQuery() = default;
+
+TrackQuery::TrackQuery(const TrackQuery& other)                = default;
+TrackQuery& TrackQuery::operator=(const TrackQuery& other)     = default;
+TrackQuery::TrackQuery(TrackQuery&& other) noexcept            = default;
+TrackQuery& TrackQuery::operator=(TrackQuery&& other) noexcept = default;
+
+QString TrackQuery::query() const
+{
+    return p->query;
+}
+
+bool TrackQuery::isEmpty() const
+{
+    return !p->root;
+}
+
+bool TrackQuery::isValid() const
+{
+    return !p->error;
+}
+
+QueryError TrackQuery::error() const
+{
+    return p->error.value_or(QueryError{});
+}
+
+bool TrackQuery::narrows(const TrackQuery& other) const
+{
+    if(other.isEmpty()) {
+        return true;
+    }
+    if(!p->terms || !other.p->terms) {
+        return false;
+    }
+
+    // Any track containing one of our terms also contains every term within it
+    return std::ranges::all_of(*other.p->terms, [this](const QString& otherTerm) {
+        return std::ranges::any_of(
+            *p->terms, [&otherTerm](const QString& term) { return term.contains(otherTerm, Qt::CaseInsensitive); });
+    });
+}
+
+bool TrackQuery::matches(const Track& track) const
+{
+    return !p->root || evaluate(*p->root, track);
+}
+
+TrackList TrackQuery::filter(const TrackList& tracks) const
+{
+    if(isEmpty()) {
+        return tracks;
+    }
+
+    const size_t count = tracks.size();
+    if(count < ParallelFilterThreshold) {
+        TrackList matches;
+        std::ranges::copy_if(tracks, std::back_inserter(matches),
+                             [this](const Track& track) { return evaluate(*p->root, track); });
+        return matches;
+    }
+
+    // Several chunks per thread so an uneven spread of matches doesn't leave threads idle
+    const size_t threads   = std::max(1, QThread::idealThreadCount());
+    const size_t numChunks = threads * 4;
+    const size_t chunkSize = (count + numChunks - 1) / numChunks;
+
+    std::vector<FilterChunk> chunks;
+    for(size_t begin{0}; begin < count; begin += chunkSize) {
+        chunks.push_back({.begin = begin, .end = std::min(begin + chunkSize, count), .matches = {}});
+    }
+
+    const Node& root = *p->root;
+    QtConcurrent::blockingMap(chunks, [&tracks, &root](FilterChunk& chunk) {
+        for(size_t i{chunk.begin}; i < chunk.end; ++i) {
+            if(evaluate(root, tracks.at(i))) {
+                chunk.matches.push_back(tracks.at(i));
+            }
+        }
+    });
+
+    TrackList matches;
+    for(FilterChunk& chunk : chunks) {
+        std::ranges::move(chunk.matches, std::back_inserter(matches));
+    }
+    return matches;
+}
+} // namespace Fooyin
@@ -22,16 +22,91 @@
 #include <core/scripting/scriptparser.h>
 #include <core/track.h>
 
-#include <ranges>
-
 #include <QCollator>
+#include <QThread>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <ranges>
 
 namespace {
-Fooyin::ParsedScript parseScript(const QString& sort)
+// Below this, splitting the sort across threads costs more than it saves
+constexpr size_t ParallelSortThreshold = 10000;
+
+Fooyin::ScriptParser& sortParser()
 {
+    // Shared so compiled sort scripts are evaluated against the registry they were compiled with
     static Fooyin::ScriptParser parser;
+    return parser;
+}
+
+Fooyin::ParsedScript parseScript(const QString& sort)
+{
+    return sortParser().parse(sort);
+}
+
+struct SortEntry
+{
+    QCollatorSortKey key;
+    size_t index;
+};
+using SortEntries = std::vector<SortEntry>;
+
+struct SortChunk
+{
+    size_t begin{0};
+    size_t end{0};
+    SortEntries entries;
+};
+
+auto compareEntries(Qt::SortOrder order)
+{
+    return [order](const SortEntry& lhs, const SortEntry& rhs) {
+        const int cmp = lhs.key.compare(rhs.key);
+        return order == Qt::AscendingOrder ? cmp < 0 : cmp > 0;
+    };
+}
+
+void sortChunk(const Fooyin::TrackList& tracks, SortChunk& chunk, Qt::SortOrder order)
+{
+    // QCollator isn't thread-safe, so each chunk uses its own
+    QCollator collator;
+    collator.setNumericMode(true);
 
-    return parser.parse(sort);
+    chunk.entries.reserve(chunk.end - chunk.begin);
+    for(size_t i{chunk.begin}; i < chunk.end; ++i) {
+        chunk.entries.push_back({collator.sortKey(tracks.at(i).sort()), i});
+    }
+
+    std::ranges::stable_sort(chunk.entries, compareEntries(order));
+}
+
+SortEntries mergeChunks(std::vector<SortChunk>& chunks, Qt::SortOrder order)
+{
+    while(chunks.size() > 1) {
+        std::vector<SortChunk> merged;
+        merged.reserve((chunks.size() + 1) / 2);
+
+        for(size_t i{0}; i < chunks.size(); i += 2) {
+            if(i + 1 == chunks.size()) {
+                merged.push_back(std::move(chunks.at(i)));
+                continue;
+            }
+
+            SortChunk& first  = chunks.at(i);
+            SortChunk& second = chunks.at(i + 1);
+
+            SortChunk chunk;
+            chunk.entries.reserve(first.entries.size() + second.entries.size());
+            std::ranges::merge(first.entries, second.entries, std::back_inserter(chunk.entries),
+                               compareEntries(order));
+            merged.push_back(std::move(chunk));
+        }
+
+        chunks = std::move(merged);
+    }
+
+    return chunks.empty() ? SortEntries{} : std::move(chunks.front().entries);
 }
 } // namespace
 
@@ -43,7 +118,7 @@ TrackList calcSortFields(const QString& sort, const TrackList& tracks)
 
 TrackList calcSortFields(const ParsedScript& sortScript, const TrackList& tracks)
 {
-    static ScriptParser parser;
+    ScriptParser& parser = sortParser();
 
     TrackList calcTracks{tracks};
     for(Track& track : calcTracks) {
@@ -54,22 +129,37 @@ TrackList calcSortFields(const ParsedScript& sortScript, const TrackList& tracks
 
 TrackList sortTracks(const TrackList& tracks, Qt::SortOrder order)
 {
-    TrackList sortedTracks{tracks};
+    const size_t count = tracks.size();
+    if(count < 2) {
+        return tracks;
+    }
 
-    QCollator collator;
-    collator.setNumericMode(true);
+    // Collation sort keys are calculated once per track, after which comparisons are a plain memcmp.
+    // Large lists are split into chunks which are keyed and sorted in parallel, then merged.
+    const size_t threads   = std::max(1, QThread::idealThreadCount());
+    const size_t numChunks = count < ParallelSortThreshold ? 1 : threads;
+    const size_t chunkSize = (count + numChunks - 1) / numChunks;
 
-    std::ranges::sort(sortedTracks, [order, collator](const Track& lhs, const Track& rhs) {
-        const auto cmp = collator.compare(lhs.sort(), rhs.sort());
+    std::vector<SortChunk> chunks;
+    for(size_t begin{0}; begin < count; begin += chunkSize) {
+        chunks.push_back({.begin = begin, .end = std::min(begin + chunkSize, count), .entries = {}});
+    }
+
+    if(chunks.size() == 1) {
+        sortChunk(tracks, chunks.front(), order);
+    }
+    else {
+        QtConcurrent::blockingMap(chunks, [&tracks, order](SortChunk& chunk) { sortChunk(tracks, chunk, order); });
+    }
+
+    const SortEntries entries = mergeChunks(chunks, order);
+
+    TrackList sortedTracks;
+    sortedTracks.reserve(count);
+    for(const SortEntry& entry : entries) {
+        sortedTracks.push_back(tracks.at(entry.index));
+    }
 
-        if(cmp == 0) {
-            return false;
-        }
-        if(order == Qt::AscendingOrder) {
-            return cmp < 0;
-        }
-        return cmp > 0;
-    });
     return sortedTracks;
 }
 
@@ -0,0 +1,228 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <core/library/trackstore.h>
+
+namespace {
+template <typename T>
+std::vector<size_t> matchingRows(std::span<const T> column, const T& value)
+{
+    std::vector<size_t> rows;
+
+    const size_t count = column.size();
+    for(size_t row{0}; row < count; ++row) {
+        if(column[row] == value) {
+            rows.push_back(row);
+        }
+    }
+
+    return rows;
+}
+
+template <typename T>
+void removeRow(std::vector<T>& column, size_t row)
+{
+    if(row + 1 < column.size()) {
+        column[row] = std::move(column.back());
+    }
+    column.pop_back();
+}
+} // namespace
+
+namespace Fooyin {
+bool TrackStore::empty() const
+{
+    return m_tracks.empty();
+}
+
+size_t TrackStore::size() const
+{
+    return m_tracks.size();
+}
+
+bool TrackStore::contains(int id) const
+{
+    return m_rows.contains(id);
+}
+
+const Track& TrackStore::track(size_t row) const
+{
+    return m_tracks.at(row);
+}
+
+std::optional<size_t> TrackStore::rowForId(int id) const
+{
+    if(const auto it = m_rows.find(id); it != m_rows.cend()) {
+        return it->second;
+    }
+    return {};
+}
+
+std::span<const int> TrackStore::ids() const
+{
+    return m_ids;
+}
+
+std::span<const int> TrackStore::libraryIds() const
+{
+    return m_libraryIds;
+}
+
+std::span<const uint64_t> TrackStore::durations() const
+{
+    return m_durations;
+}
+
+std::span<const int> TrackStore::years() const
+{
+    return m_years;
+}
+
+std::span<const size_t> TrackStore::hashKeys() const
+{
+    return m_hashKeys;
+}
+
+std::span<const TrackStore::StringId> TrackStore::artistIds() const
+{
+    return m_artistIds;
+}
+
+std::span<const TrackStore::StringId> TrackStore::albumArtistIds() const
+{
+    return m_albumArtistIds;
+}
+
+std::span<const TrackStore::StringId> TrackStore::albumIds() const
+{
+    return m_albumIds;
+}
+
+std::span<const TrackStore::StringId> TrackStore::genreIds() const
+{
+    return m_genreIds;
+}
+
+std::vector<size_t> TrackStore::rowsWithHash(const QString& hash) const
+{
+    std::vector<size_t> rows = matchingRows(hashKeys(), qHash(hash));
+    // Rule out any tracks whose hashes only collide
+    std::erase_if(rows, [this, &hash](size_t row) { return m_tracks.at(row).hash() != hash; });
+    return rows;
+}
+
+std::vector<size_t> TrackStore::rowsInLibrary(int libraryId) const
+{
+    return matchingRows(libraryIds(), libraryId);
+}
+
+void TrackStore::insert(const Track& track)
+{
+    if(const auto it = m_rows.find(track.id()); it != m_rows.cend()) {
+        setRow(it->second, track);
+        return;
+    }
+
+    const size_t row   = m_tracks.size();
+    const size_t count = row + 1;
+
+    m_tracks.resize(count);
+    m_ids.resize(count);
+    m_libraryIds.resize(count);
+    m_durations.resize(count);
+    m_years.resize(count);
+    m_hashKeys.resize(count);
+    m_artistIds.resize(count);
+    m_albumArtistIds.resize(count);
+    m_albumIds.resize(count);
+    m_genreIds.resize(count);
+
+    setRow(row, track);
+    m_rows.emplace(track.id(), row);
+}
+
+bool TrackStore::remove(int id)
+{
+    const auto it = m_rows.find(id);
+    if(it == m_rows.cend()) {
+        return false;
+    }
+
+    const size_t row = it->second;
+    m_rows.erase(it);
+
+    removeRow(m_tracks, row);
+    removeRow(m_ids, row);
+    removeRow(m_libraryIds, row);
+    removeRow(m_durations, row);
+    removeRow(m_years, row);
+    removeRow(m_hashKeys, row);
+    removeRow(m_artistIds, row);
+    removeRow(m_albumArtistIds, row);
+    removeRow(m_albumIds, row);
+    removeRow(m_genreIds, row);
+
+    if(row < m_ids.size()) {
+        // The last row was moved into the gap
+        m_rows[m_ids[row]] = row;
+    }
+
+    return true;
+}
+
+void TrackStore::clear()
+{
+    m_tracks.clear();
+    m_rows.clear();
+    m_ids.clear();
+    m_libraryIds.clear();
+    m_durations.clear();
+    m_years.clear();
+    m_hashKeys.clear();
+    m_artistIds.clear();
+    m_albumArtistIds.clear();
+    m_albumIds.clear();
+    m_genreIds.clear();
+}
+
+TrackStore::StringId TrackStore::stringId(const QString& str)
+{
+    return str.isEmpty() ? 0 : reinterpret_cast<StringId>(str.constData());
+}
+
+TrackStore::StringId TrackStore::stringId(const QStringList& list)
+{
+    return list.isEmpty() ? 0 : reinterpret_cast<StringId>(list.constData());
+}
+
+void TrackStore::setRow(size_t row, const Track& track)
+{
+    m_tracks[row]         = track;
+    m_ids[row]            = track.id();
+    m_libraryIds[row]     = track.libraryId();
+    m_durations[row]      = track.duration();
+    m_years[row]          = track.year();
+    m_hashKeys[row]       = qHash(track.hash());
+    m_artistIds[row]      = stringId(track.artists());
+    m_albumArtistIds[row] = stringId(track.albumArtists());
+    m_albumIds[row]       = stringId(track.album());
+    m_genreIds[row]       = stringId(track.genres());
+}
+} // namespace Fooyin
@@ -20,12 +20,15 @@
 #include "unifiedmusiclibrary.h"
 
 #include "internalcoresettings.h"
+#include "library/libraryindex.h"
 #include "library/libraryinfo.h"
 #include "library/librarymanager.h"
 #include "librarythreadhandler.h"
 
+#include <core/constants.h>
 #include <core/coresettings.h>
 #include <core/library/tracksort.h>
+#include <core/library/trackstore.h>
 #include <utils/async.h>
 #include <utils/helpers.h>
 #include <utils/settings/settingsmanager.h>
@@ -44,9 +47,9 @@ QCoro::Task<Fooyin::TrackList> recalSortTracks(QString sort, Fooyin::TrackList t
         [&sort, &tracks]() { return Fooyin::Sorting::calcSortTracks(sort, tracks); });
 }
 
-QCoro::Task<Fooyin::TrackList> resortTracks(Fooyin::TrackList tracks)
+bool sortUsesStats(const QString& sort)
 {
-    co_return co_await Fooyin::Utils::asyncExec([&tracks]() { return Fooyin::Sorting::sortTracks(tracks); });
+    return sort.contains(QLatin1String{Fooyin::Constants::MetaData::PlayCount}, Qt::CaseInsensitive);
 }
 } // namespace
 
@@ -61,9 +64,14 @@ struct UnifiedMusicLibrary::Private
 
     LibraryThreadHandler threadHandler;
 
-    TrackList tracks;
+    LibraryIndex index;
     std::unordered_map<QString, Track> pendingStatUpdates;
 
+    // Used to decide whether the in-memory tracks can be snapshotted on shutdown
+    bool loaded{false};
+    bool unsyncedWrites{false};
+    int pendingChanges{0};
+
     Private(UnifiedMusicLibrary* self_, LibraryManager* libraryManager_, DbConnectionPoolPtr dbPool_,
             SettingsManager* settings_)
         : self{self_}
@@ -73,40 +81,103 @@ struct UnifiedMusicLibrary::Private
         , threadHandler{dbPool, self, settings}
     { }
 
+    QCoro::Task<void> rebuildIndex(QString sort, TrackList tracks)
+    {
+        // The index orders the tracks itself, so only the sort fields need calculating
+        LibraryIndex newIndex;
+        co_await Utils::asyncExec(
+            [&newIndex, &sort, &tracks]() { newIndex.reset(Sorting::calcSortFields(sort, tracks)); });
+        index = std::move(newIndex);
+    }
+
     QCoro::Task<void> loadTracks(TrackList trackToLoad)
     {
-        TrackList sortedTracks
-            = co_await recalSortTracks(settings->value<Settings::Core::LibrarySortScript>(), trackToLoad);
-        tracks = std::move(sortedTracks);
-        emit self->tracksLoaded(tracks);
+        ++pendingChanges;
+        co_await rebuildIndex(settings->value<Settings::Core::LibrarySortScript>(), trackToLoad);
+        --pendingChanges;
+
+        loaded = true;
+        emit self->tracksLoaded(index.tracks());
+    }
+
+    QCoro::Task<void> loadSnapshot(TrackList snapshotTracks, QString sort)
+    {
+        if(sort != settings->value<Settings::Core::LibrarySortScript>()) {
+            co_await loadTracks(snapshotTracks);
+            co_return;
+        }
+
+        ++pendingChanges;
+        // Already sorted with their sort fields calculated, so only the index needs filling
+        LibraryIndex newIndex;
+        co_await Utils::asyncExec([&newIndex, &snapshotTracks]() { newIndex.reset(snapshotTracks); });
+        index = std::move(newIndex);
+        --pendingChanges;
+
+        loaded = true;
+        emit self->tracksLoaded(index.tracks());
     }
 
     QCoro::Task<void> addTracks(TrackList newTracks)
     {
+        ++pendingChanges;
         const TrackList sortedTracks
             = co_await recalSortTracks(settings->value<Settings::Core::LibrarySortScript>(), newTracks);
+        --pendingChanges;
 
-        std::ranges::copy(sortedTracks, std::back_inserter(tracks));
-        tracks = co_await resortTracks(tracks);
+        index.insert(sortedTracks);
 
         emit self->tracksAdded(sortedTracks);
     }
 
     QCoro::Task<void> updateTracks(TrackList tracksToUpdate)
     {
+        ++pendingChanges;
         tracksToUpdate = co_await recalSortTracks(settings->value<Settings::Core::LibrarySortScript>(), tracksToUpdate);
+        --pendingChanges;
 
-        std::ranges::for_each(tracksToUpdate, [this](const Track& track) {
-            std::ranges::replace_if(
-                tracks, [track](const Track& libraryTrack) { return libraryTrack.id() == track.id(); }, track);
-        });
+        index.insert(tracksToUpdate);
 
-        tracks         = co_await resortTracks(tracks);
-        tracksToUpdate = co_await resortTracks(tracksToUpdate);
+        emit self->tracksUpdated(tracksToUpdate);
+    }
+
+    void updateTrackStats(const TrackList& tracksToUpdate)
+    {
+        if(sortUsesStats(settings->value<Settings::Core::LibrarySortScript>())) {
+            updateTracks(tracksToUpdate);
+            return;
+        }
+
+        // Taken from the index, so their sort fields are still current
+        index.insert(tracksToUpdate);
 
         emit self->tracksUpdated(tracksToUpdate);
     }
 
+    void tracksVerified(const TrackIds& enabled, const TrackIds& disabled)
+    {
+        // Applied to the current tracks so edits made while the files were checked are kept
+        TrackList verifiedTracks;
+
+        const auto setEnabled = [this, &verifiedTracks](const TrackIds& ids, bool isEnabled) {
+            TrackList tracks = index.tracksForIds(ids);
+            for(Track& track : tracks) {
+                track.setIsEnabled(isEnabled);
+                verifiedTracks.push_back(track);
+            }
+        };
+        setEnabled(enabled, true);
+        setEnabled(disabled, false);
+
+        if(verifiedTracks.empty()) {
+            return;
+        }
+
+        index.insert(verifiedTracks);
+
+        emit self->tracksUpdated(verifiedTracks);
+    }
+
     QCoro::Task<void> handleScanResult(ScanResult result)
     {
         if(!result.addedTracks.empty()) {
@@ -119,7 +190,9 @@ struct UnifiedMusicLibrary::Private
 
     QCoro::Task<void> scannedTracks(int id, TrackList tracksScanned)
     {
+        ++pendingChanges;
         tracksScanned = co_await recalSortTracks(settings->value<Settings::Core::LibrarySortScript>(), tracksScanned);
+        --pendingChanges;
 
         addTracks(tracksScanned);
 
@@ -132,24 +205,28 @@ struct UnifiedMusicLibrary::Private
             return;
         }
 
-        TrackList newTracks;
         TrackList removedTracks;
         TrackList updatedTracks;
 
-        for(auto& track : tracks) {
-            if(track.libraryId() == id) {
-                if(tracksRemoved.contains(track.id())) {
-                    removedTracks.push_back(track);
-                    continue;
-                }
-                track.setLibraryId(-1);
-                updatedTracks.push_back(track);
-                newTracks.push_back(track);
+        // Copy out the matching rows first, as removing from the index moves rows around
+        TrackList libraryTracks;
+        const TrackStore& store = index.store();
+        for(const size_t row : store.rowsInLibrary(id)) {
+            libraryTracks.push_back(store.track(row));
+        }
+
+        for(const Track& track : libraryTracks) {
+            if(tracksRemoved.contains(track.id())) {
+                index.remove(track.id());
+                removedTracks.push_back(track);
+                continue;
             }
-            newTracks.push_back(track);
+            Track updatedTrack{track};
+            updatedTrack.setLibraryId(-1);
+            updatedTracks.push_back(updatedTrack);
         }
 
-        tracks = newTracks;
+        index.insert(updatedTracks);
 
         threadHandler.libraryRemoved(id);
 
@@ -164,10 +241,11 @@ struct UnifiedMusicLibrary::Private
 
     QCoro::Task<void> changeSort(QString sort)
     {
-        TrackList sortedTracks = co_await recalSortTracks(sort, tracks);
-        tracks                 = std::move(sortedTracks);
+        ++pendingChanges;
+        co_await rebuildIndex(sort, index.tracks());
+        --pendingChanges;
 
-        emit self->tracksSorted(tracks);
+        emit self->tracksSorted(index.tracks());
     }
 };
 
@@ -181,6 +259,9 @@ UnifiedMusicLibrary::UnifiedMusicLibrary(LibraryManager* libraryManager, DbConne
             [this](int id, const std::set<int>& tracksRemoved) { p->removeLibrary(id, tracksRemoved); });
 
     connect(&p->threadHandler, &LibraryThreadHandler::progressChanged, this, &UnifiedMusicLibrary::scanProgress);
+    connect(&p->threadHandler, &LibraryThreadHandler::writeProgress, this,
+            &UnifiedMusicLibrary::metadataWriteProgress);
+    connect(&p->threadHandler, &LibraryThreadHandler::writeFailed, this, &UnifiedMusicLibrary::metadataWriteFailed);
 
     connect(&p->threadHandler, &LibraryThreadHandler::statusChanged, this,
             [this](const LibraryInfo& library) { p->libraryStatusChanged(library); });
@@ -190,8 +271,12 @@ UnifiedMusicLibrary::UnifiedMusicLibrary(LibraryManager* libraryManager, DbConne
             [this](int id, const TrackList& tracks) { p->scannedTracks(id, tracks); });
     connect(&p->threadHandler, &LibraryThreadHandler::tracksUpdated, this,
             [this](const TrackList& tracks) { p->updateTracks(tracks); });
+    connect(&p->threadHandler, &LibraryThreadHandler::tracksVerified, this,
+            [this](const TrackIds& enabled, const TrackIds& disabled) { p->tracksVerified(enabled, disabled); });
     connect(&p->threadHandler, &LibraryThreadHandler::gotTracks, this,
             [this](const TrackList& tracks) { p->loadTracks(tracks); });
+    connect(&p->threadHandler, &LibraryThreadHandler::gotSnapshot, this,
+            [this](const TrackList& tracks, const QString& sort) { p->loadSnapshot(tracks, sort); });
 
     p->settings->subscribe<Settings::Core::LibrarySortScript>(this,
                                                               [this](const QString& sort) { p->changeSort(sort); });
@@ -199,6 +284,8 @@ UnifiedMusicLibrary::UnifiedMusicLibrary(LibraryManager* libraryManager, DbConne
     connect(
         this, &MusicLibrary::tracksLoaded, this,
         [this]() {
+            // Tracks are loaded without checking their files, so flag missing ones once the library is usable
+            p->threadHandler.verifyTracks(p->index.tracks());
             p->threadHandler.setupWatchers(p->libraryManager->allLibraries(),
                                            p->settings->value<Settings::Core::Internal::MonitorLibraries>());
             if(p->settings->value<Settings::Core::AutoRefresh>()) {
@@ -220,6 +307,10 @@ UnifiedMusicLibrary::~UnifiedMusicLibrary()
         }
         p->threadHandler.saveUpdatedTrackStats(tracksToUpdate);
     }
+
+    if(p->loaded && !p->unsyncedWrites && p->pendingChanges == 0) {
+        p->threadHandler.saveSnapshot(p->index.tracks(), p->settings->value<Settings::Core::LibrarySortScript>());
+    }
 }
 
 void UnifiedMusicLibrary::loadAllTracks()
@@ -252,37 +343,43 @@ bool UnifiedMusicLibrary::hasLibrary() const
 
 bool UnifiedMusicLibrary::isEmpty() const
 {
-    return p->tracks.empty();
+    return p->index.empty();
 }
 
 TrackList UnifiedMusicLibrary::tracks() const
 {
-    return p->tracks;
+    return p->index.tracks();
+}
+
+const TrackStore& UnifiedMusicLibrary::trackStore() const
+{
+    return p->index.store();
 }
 
 TrackList UnifiedMusicLibrary::tracksForIds(const TrackIds& ids) const
 {
-    TrackList tracks;
-    tracks.reserve(ids.size());
-
-    for(const int id : ids) {
-        auto trackIt
-            = std::ranges::find_if(std::as_const(p->tracks), [id](const Track& track) { return track.id() == id; });
-        if(trackIt != p->tracks.cend()) {
-            tracks.push_back(*trackIt);
-        }
-    }
+    return p->index.tracksForIds(ids);
+}
 
-    return tracks;
+TrackList UnifiedMusicLibrary::tracksInDirectory(const QString& dir) const
+{
+    return p->index.tracksInDirectory(dir);
 }
 
-void UnifiedMusicLibrary::updateTrackMetadata(const TrackList& tracks)
+TrackList UnifiedMusicLibrary::tracksForPaths(const QStringList& filepaths) const
 {
-    p->threadHandler.saveUpdatedTracks(tracks);
+    return p->index.tracksForPaths(filepaths);
+}
+
+WriteRequest UnifiedMusicLibrary::updateTrackMetadata(const TrackList& tracks)
+{
+    return p->threadHandler.saveUpdatedTracks(tracks);
 }
 
 void UnifiedMusicLibrary::updateTrackStats(const Track& track)
 {
+    // Only written to the database, so the library no longer matches it
+    p->unsyncedWrites = true;
     p->threadHandler.saveUpdatedTrackStats({track});
 }
 
@@ -306,17 +403,16 @@ void UnifiedMusicLibrary::trackWasPlayed(const Track& track)
     p->pendingStatUpdates.emplace(hash, updatedTrack);
 
     TrackList tracksToUpdate;
-    for(const auto& libraryTrack : p->tracks) {
-        if(libraryTrack.hash() == hash) {
-            Track sameHashTrack{libraryTrack};
-            sameHashTrack.setFirstPlayed(dt);
-            sameHashTrack.setLastPlayed(dt);
-            sameHashTrack.setPlayCount(updatedTrack.playCount());
-            tracksToUpdate.emplace_back(sameHashTrack);
-        }
+    const TrackList sameHashTracks = p->index.tracksWithHash(hash);
+    for(const Track& sameHashTrack : sameHashTracks) {
+        Track playedTrack{sameHashTrack};
+        playedTrack.setFirstPlayed(dt);
+        playedTrack.setLastPlayed(dt);
+        playedTrack.setPlayCount(updatedTrack.playCount());
+        tracksToUpdate.emplace_back(playedTrack);
     }
 
-    p->updateTracks(tracksToUpdate);
+    p->updateTrackStats(tracksToUpdate);
 }
 
 void UnifiedMusicLibrary::cleanupTracks()
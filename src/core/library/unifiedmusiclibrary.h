@@ -46,9 +46,12 @@ public:
     [[nodiscard]] bool isEmpty() const override;
 
     [[nodiscard]] TrackList tracks() const override;
+    [[nodiscard]] const TrackStore& trackStore() const override;
     [[nodiscard]] TrackList tracksForIds(const TrackIds& ids) const override;
+    [[nodiscard]] TrackList tracksInDirectory(const QString& dir) const override;
+    [[nodiscard]] TrackList tracksForPaths(const QStringList& filepaths) const override;
 
-    void updateTrackMetadata(const TrackList& tracks) override;
+    WriteRequest updateTrackMetadata(const TrackList& tracks) override;
     void updateTrackStats(const Track& track) override;
 
     void trackWasPlayed(const Track& track);
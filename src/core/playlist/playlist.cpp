@@ -27,6 +27,7 @@
 #include <random>
 #include <ranges>
 #include <set>
+#include <unordered_map>
 
 namespace Fooyin {
 struct Playlist::PrivateKey
@@ -42,6 +43,9 @@ struct Playlist::Private
     QString name;
     int index{-1};
     TrackList tracks;
+    // Positions of each track id, rebuilt on demand after tracks are replaced or removed
+    mutable std::unordered_map<int, std::vector<int>> trackIndexes;
+    mutable bool indexesValid{false};
 
     int currentTrackIndex{0};
     int nextTrackIndex{-1};
@@ -66,6 +70,48 @@ struct Playlist::Private
         , index{index_}
     { }
 
+    void indexTrack(int trackIndex) const
+    {
+        const Track& track = tracks.at(trackIndex);
+        if(track.isInDatabase()) {
+            trackIndexes[track.id()].push_back(trackIndex);
+        }
+    }
+
+    const std::unordered_map<int, std::vector<int>>& indexes() const
+    {
+        if(!indexesValid) {
+            trackIndexes.clear();
+            const int count = static_cast<int>(tracks.size());
+            for(int i{0}; i < count; ++i) {
+                indexTrack(i);
+            }
+            indexesValid = true;
+        }
+        return trackIndexes;
+    }
+
+    [[nodiscard]] std::vector<int> indexesOf(const TrackList& tracksToFind) const
+    {
+        std::vector<int> foundIndexes;
+
+        const auto& idIndexes = indexes();
+        for(const Track& track : tracksToFind) {
+            if(!track.isInDatabase()) {
+                continue;
+            }
+            if(const auto it = idIndexes.find(track.id()); it != idIndexes.cend()) {
+                foundIndexes.insert(foundIndexes.end(), it->second.cbegin(), it->second.cend());
+            }
+        }
+
+        std::ranges::sort(foundIndexes);
+        const auto [first, last] = std::ranges::unique(foundIndexes);
+        foundIndexes.erase(first, last);
+
+        return foundIndexes;
+    }
+
     void readTrack(int trackIndex)
     {
         if(trackIndex < 0 || std::cmp_greater_equal(trackIndex, tracks.size())) {
@@ -321,6 +367,7 @@ void Playlist::setTracksModified(bool modified)
 void Playlist::replaceTracks(const TrackList& tracks)
 {
     if(std::exchange(p->tracks, tracks) != tracks) {
+        p->indexesValid   = false;
         p->tracksModified = true;
         p->shuffleOrder.clear();
         p->nextTrackIndex = -1;
@@ -333,11 +380,54 @@ void Playlist::appendTracks(const TrackList& tracks)
         return;
     }
 
+    const int firstIndex = trackCount();
     std::ranges::copy(tracks, std::back_inserter(p->tracks));
+
+    if(p->indexesValid) {
+        for(int i{firstIndex}; i < trackCount(); ++i) {
+            p->indexTrack(i);
+        }
+    }
+
     p->tracksModified = true;
     p->shuffleOrder.clear();
 }
 
+std::vector<int> Playlist::updateTracks(const TrackList& tracks)
+{
+    std::vector<int> updatedIndexes;
+
+    const auto& idIndexes = p->indexes();
+    for(const Track& track : tracks) {
+        if(!track.isInDatabase()) {
+            continue;
+        }
+        const auto it = idIndexes.find(track.id());
+        if(it == idIndexes.cend()) {
+            continue;
+        }
+        for(const int index : it->second) {
+            Track& playlistTrack = p->tracks.at(index);
+            if(playlistTrack != track) {
+                p->tracksModified = true;
+            }
+            playlistTrack = track;
+            updatedIndexes.push_back(index);
+        }
+    }
+
+    std::ranges::sort(updatedIndexes);
+    const auto [first, last] = std::ranges::unique(updatedIndexes);
+    updatedIndexes.erase(first, last);
+
+    return updatedIndexes;
+}
+
+std::vector<int> Playlist::indexesOf(const TrackList& tracks) const
+{
+    return p->indexesOf(tracks);
+}
+
 std::vector<int> Playlist::removeTracks(const std::vector<int>& indexes)
 {
     std::vector<int> removedIndexes;
@@ -370,6 +460,10 @@ std::vector<int> Playlist::removeTracks(const std::vector<int>& indexes)
 
     std::erase_if(p->shuffleOrder, [](int num) { return num < 0; });
 
+    if(!removedIndexes.empty()) {
+        p->indexesValid = false;
+    }
+
     changeCurrentIndex(adjustedTrackIndex);
 
     if(indexesToRemove.contains(p->nextTrackIndex)) {
@@ -385,6 +479,7 @@ void Playlist::clear()
 {
     if(!p->tracks.empty()) {
         p->tracks.clear();
+        p->trackIndexes.clear();
         p->tracksModified = true;
         p->shuffleOrder.clear();
     }
@@ -30,41 +30,6 @@
 #include <ranges>
 #include <utility>
 
-namespace {
-enum class CommonOperation : uint8_t
-{
-    Update = 0,
-    Remove
-};
-
-std::vector<int> updateCommonTracks(Fooyin::TrackList& tracks, const Fooyin::TrackList& updatedTracks,
-                                    CommonOperation operation)
-{
-    std::vector<int> indexes;
-
-    Fooyin::TrackList result;
-    result.reserve(tracks.size());
-
-    for(auto trackIt{tracks.begin()}; trackIt != tracks.end(); ++trackIt) {
-        auto updatedIt = std::ranges::find_if(updatedTracks, [&trackIt](const Fooyin::Track& updatedTrack) {
-            return updatedTrack.isInDatabase() && trackIt->id() == updatedTrack.id();
-        });
-        if(updatedIt != updatedTracks.end()) {
-            indexes.push_back(static_cast<int>(std::distance(tracks.begin(), trackIt)));
-            if(operation == CommonOperation::Update) {
-                result.push_back(*updatedIt);
-            }
-        }
-        else {
-            result.push_back(*trackIt);
-        }
-    }
-
-    tracks = result;
-    return indexes;
-}
-} // namespace
-
 namespace Fooyin {
 struct PlaylistHandler::Private
 {
@@ -632,11 +597,8 @@ void PlaylistHandler::populatePlaylists(const TrackList& tracks)
 void PlaylistHandler::tracksUpdated(const TrackList& tracks)
 {
     for(auto& playlist : p->playlists) {
-        TrackList playlistTracks  = playlist->tracks();
-        const auto updatedIndexes = updateCommonTracks(playlistTracks, tracks, CommonOperation::Update);
-
+        const auto updatedIndexes = playlist->updateTracks(tracks);
         if(!updatedIndexes.empty()) {
-            playlist->replaceTracks(playlistTracks);
             emit playlistTracksChanged(playlist.get(), updatedIndexes);
         }
     }
@@ -645,12 +607,10 @@ void PlaylistHandler::tracksUpdated(const TrackList& tracks)
 void PlaylistHandler::tracksRemoved(const TrackList& tracks)
 {
     for(auto& playlist : p->playlists) {
-        TrackList playlistTracks  = playlist->tracks();
-        const auto updatedIndexes = updateCommonTracks(playlistTracks, tracks, CommonOperation::Remove);
-
-        if(!updatedIndexes.empty()) {
-            playlist->replaceTracks(playlistTracks);
-            emit playlistTracksChanged(playlist.get(), updatedIndexes);
+        const auto removedIndexes = playlist->indexesOf(tracks);
+        if(!removedIndexes.empty()) {
+            playlist->removeTracks(removedIndexes);
+            emit playlistTracksChanged(playlist.get(), removedIndexes);
         }
     }
 }
@@ -19,6 +19,8 @@
 
 #include <core/scripting/scriptparser.h>
 
+#include "scriptvm.h"
+
 #include <core/constants.h>
 #include <core/scripting/scriptscanner.h>
 #include <core/track.h>
@@ -27,26 +29,6 @@
 
 using TokenType = Fooyin::ScriptScanner::TokenType;
 
-namespace {
-QStringList evalStringList(const Fooyin::ScriptResult& evalExpr, const QStringList& result)
-{
-    QStringList listResult;
-    const QStringList values = evalExpr.value.split(QStringLiteral("\037"));
-    const bool isEmpty       = result.empty();
-
-    for(const QString& value : values) {
-        if(isEmpty) {
-            listResult.append(value);
-        }
-        else {
-            std::ranges::transform(result, std::back_inserter(listResult),
-                                   [&](const QString& retValue) -> QString { return retValue + value; });
-        }
-    }
-    return listResult;
-}
-} // namespace
-
 namespace Fooyin {
 struct ScriptParser::Private
 {
@@ -61,7 +43,6 @@ struct ScriptParser::Private
 
     QString currentInput;
     std::unordered_map<QString, ParsedScript> parsedScripts;
-    QStringList currentResult;
 
     explicit Private(ScriptParser* self_)
         : self{self_}
@@ -229,7 +210,8 @@ struct ScriptParser::Private
             checkExists();
         }
 
-        expr.value = value;
+        expr.value    = value;
+        expr.accessor = registry->resolveVariable(value);
         consume(TokenType::TokVar, QStringLiteral("Expected '%' after expression"));
         return expr;
     }
@@ -323,29 +305,19 @@ struct ScriptParser::Private
 
     ScriptResult evalVariable(const Expression& exp, const auto& tracks) const
     {
-        const QString var   = std::get<QString>(exp.value);
-        ScriptResult result = registry->value(var, tracks);
-
-        if(!result.cond) {
-            return {};
-        }
-
-        if(result.value.contains(u"\037")) {
-            result.value = result.value.replace(QStringLiteral("\037"), QStringLiteral(", "));
-        }
-
-        return result;
+        const auto& var = std::get<QString>(exp.value);
+        return Scripting::formatVariable(registry->value(var, tracks));
     }
 
     ScriptResult evalVariableList(const Expression& exp, const auto& tracks) const
     {
-        const QString var = std::get<QString>(exp.value);
+        const auto& var = std::get<QString>(exp.value);
         return registry->value(var, tracks);
     }
 
     ScriptResult evalFunction(const Expression& exp, const auto& tracks) const
     {
-        auto func = std::get<FuncValue>(exp.value);
+        const auto& func = std::get<FuncValue>(exp.value);
         ScriptValueList args;
         std::ranges::transform(func.args, std::back_inserter(args),
                                [this, &tracks](const Expression& arg) { return evalExpression(arg, tracks); });
@@ -357,22 +329,13 @@ struct ScriptParser::Private
         ScriptResult result;
         bool allPassed{true};
 
-        auto arg = std::get<ExpressionList>(exp.value);
+        const auto& arg = std::get<ExpressionList>(exp.value);
         for(const Expression& subArg : arg) {
             const auto subExpr = evalExpression(subArg, tracks);
             if(!subExpr.cond) {
                 allPassed = false;
             }
-            if(subExpr.value.contains(u"\037")) {
-                QStringList newResult;
-                const auto values = subExpr.value.split(QStringLiteral("\037"));
-                std::ranges::transform(values, std::back_inserter(newResult),
-                                       [&](const auto& value) { return result.value + value; });
-                result.value = newResult.join(u"\037");
-            }
-            else {
-                result.value = result.value + subExpr.value;
-            }
+            Scripting::appendArg(result, subExpr);
         }
         result.cond = allPassed;
         return result;
@@ -380,11 +343,9 @@ struct ScriptParser::Private
 
     ScriptResult evalConditional(const Expression& exp, const auto& tracks) const
     {
-        ScriptResult result;
         QStringList exprResult;
-        result.cond = true;
 
-        auto arg = std::get<ExpressionList>(exp.value);
+        const auto& arg = std::get<ExpressionList>(exp.value);
         for(const Expression& subArg : arg) {
             const auto subExpr = evalExpression(subArg, tracks);
 
@@ -392,35 +353,12 @@ struct ScriptParser::Private
             if(subArg.type != Expr::Literal) {
                 if(!subExpr.cond || subExpr.value.isEmpty()) {
                     // No need to evaluate rest
-                    result.value.clear();
-                    result.cond = false;
-                    return result;
-                }
-            }
-            if(subExpr.value.contains(u"\037")) {
-                const QStringList evalList = evalStringList(subExpr, exprResult);
-                if(!evalList.empty()) {
-                    exprResult = evalList;
+                    return {};
                 }
             }
-            else {
-                if(exprResult.empty()) {
-                    exprResult.append(subExpr.value);
-                }
-                else {
-                    std::ranges::transform(exprResult, exprResult.begin(), [&](const QString& retValue) -> QString {
-                        return retValue + subExpr.value;
-                    });
-                }
-            }
-        }
-        if(exprResult.size() == 1) {
-            result.value = exprResult.constFirst();
+            Scripting::appendResult(exprResult, subExpr);
         }
-        else if(exprResult.size() > 1) {
-            result.value = exprResult.join(u"\037");
-        }
-        return result;
+        return Scripting::conditionResult(exprResult);
     }
 
     ParsedScript parse(const QString& input, const auto& tracks)
@@ -446,6 +384,10 @@ struct ScriptParser::Private
 
         consume(TokenType::TokEos, QStringLiteral("Expected end of expression"));
 
+        if(script.isValid()) {
+            script.program = Scripting::compile(script.expressions, registry);
+        }
+
         return script;
     }
 
@@ -455,45 +397,24 @@ struct ScriptParser::Private
             return {};
         }
 
-        currentResult.clear();
+        // Programs are bound to the registry they were compiled against
+        if(input.program && input.program->registry == registry) {
+            return Scripting::execute(*input.program, tracks);
+        }
+
+        QStringList result;
 
-        const ExpressionList expressions = input.expressions;
-        for(const auto& expr : expressions) {
+        for(const auto& expr : input.expressions) {
             const auto evalExpr = evalExpression(expr, tracks);
 
             if(evalExpr.value.isNull()) {
                 continue;
             }
 
-            if(evalExpr.value.contains(u"\037")) {
-                const QStringList evalList = evalStringList(evalExpr, currentResult);
-                if(!evalList.empty()) {
-                    currentResult = evalList;
-                }
-            }
-            else {
-                if(currentResult.empty()) {
-                    currentResult.push_back(evalExpr.value);
-                }
-                else {
-                    std::ranges::transform(
-                        currentResult, currentResult.begin(),
-                        [&](const QString& retValue) -> QString { return retValue + evalExpr.value; });
-                }
-            }
-        }
-
-        if(currentResult.size() == 1) {
-            // Calling join on a QStringList with a single empty string will return a null QString, so return the first
-            // result.
-            return currentResult.constFirst();
-        }
-
-        if(currentResult.size() > 1) {
-            return currentResult.join(u"\037");
+            Scripting::appendResult(result, evalExpr);
         }
 
-        return {};
+        return Scripting::joinResult(result);
     }
 };
 
@@ -35,10 +35,46 @@ using NativeBoolFunc = std::function<Fooyin::ScriptResult(const QStringList&)>;
 using NativeCondFunc = std::function<Fooyin::ScriptResult(const Fooyin::ScriptValueList&)>;
 using Func           = std::variant<NativeFunc, NativeVoidFunc, NativeBoolFunc, NativeCondFunc>;
 
-using TrackFunc     = std::function<Fooyin::ScriptRegistry::FuncRet(const Fooyin::Track&)>;
+using TrackAccessor = Fooyin::ScriptResult (*)(const Fooyin::Track&);
 using TrackSetFunc  = std::function<void(Fooyin::Track&, const Fooyin::ScriptRegistry::FuncRet&)>;
 using TrackListFunc = std::function<Fooyin::ScriptRegistry::FuncRet(const Fooyin::TrackList&)>;
 
+// These mirror ScriptRegistry::calculateResult without going through FuncRet
+Fooyin::ScriptResult toResult(int value)
+{
+    return {.value = QString::number(value), .cond = value >= 0};
+}
+
+Fooyin::ScriptResult toResult(uint64_t value)
+{
+    return {.value = QString::number(value), .cond = true};
+}
+
+Fooyin::ScriptResult toResult(const QString& value)
+{
+    return {.value = value, .cond = !value.isEmpty()};
+}
+
+Fooyin::ScriptResult toResult(const QStringList& value)
+{
+    const QString joined = value.empty() ? QStringLiteral("") : value.join(u"\037");
+    return {.value = joined, .cond = !joined.isEmpty()};
+}
+
+template <auto Getter>
+Fooyin::ScriptResult trackValue(const Fooyin::Track& track)
+{
+    return toResult((track.*Getter)());
+}
+
+Fooyin::ScriptResult extraTagValue(const QString& tag, const Fooyin::Track& track)
+{
+    if(!track.hasExtraTag(tag)) {
+        return {};
+    }
+    return toResult(track.extraTag(tag));
+}
+
 template <typename FuncType>
 auto generateSetFunc(FuncType func)
 {
@@ -70,10 +106,13 @@ auto generateSetFunc(FuncType func)
 namespace Fooyin {
 struct ScriptRegistry::Private
 {
-    std::unordered_map<QString, TrackFunc> metadata;
+    std::vector<TrackAccessor> metadataAccessors;
+    std::unordered_map<QString, int> metadata;
     std::unordered_map<QString, TrackSetFunc> setMetadata;
-    std::unordered_map<QString, TrackListFunc> listProperties;
-    std::unordered_map<QString, Func> funcs;
+    std::vector<TrackListFunc> listFuncs;
+    std::unordered_map<QString, int> listProperties;
+    std::vector<Func> funcs;
+    std::unordered_map<QString, int> funcIndexes;
 
     Private()
     {
@@ -82,41 +121,59 @@ struct ScriptRegistry::Private
         addDefaultMetadata();
     }
 
+    void addMetadata(const char* name, TrackAccessor accessor)
+    {
+        metadata.emplace(QString::fromLatin1(name), static_cast<int>(metadataAccessors.size()));
+        metadataAccessors.push_back(accessor);
+    }
+
+    void addListProperty(const QString& name, const TrackListFunc& func)
+    {
+        listProperties.emplace(name, static_cast<int>(listFuncs.size()));
+        listFuncs.push_back(func);
+    }
+
+    void addFunction(const QString& name, const Func& func)
+    {
+        funcIndexes.emplace(name, static_cast<int>(funcs.size()));
+        funcs.push_back(func);
+    }
+
     void addDefaultFunctions()
     {
-        funcs.emplace(QStringLiteral("add"), Fooyin::Scripting::add);
-        funcs.emplace(QStringLiteral("sub"), Fooyin::Scripting::sub);
-        funcs.emplace(QStringLiteral("mul"), Fooyin::Scripting::mul);
-        funcs.emplace(QStringLiteral("div"), Fooyin::Scripting::div);
-        funcs.emplace(QStringLiteral("min"), Fooyin::Scripting::min);
-        funcs.emplace(QStringLiteral("max"), Fooyin::Scripting::max);
-        funcs.emplace(QStringLiteral("mod"), Fooyin::Scripting::mod);
-
-        funcs.emplace(QStringLiteral("num"), Fooyin::Scripting::num);
-        funcs.emplace(QStringLiteral("replace"), Fooyin::Scripting::replace);
-        funcs.emplace(QStringLiteral("chop"), Fooyin::Scripting::chop);
-        funcs.emplace(QStringLiteral("slice"), Fooyin::Scripting::slice);
-        funcs.emplace(QStringLiteral("left"), Fooyin::Scripting::left);
-        funcs.emplace(QStringLiteral("right"), Fooyin::Scripting::right);
-        funcs.emplace(QStringLiteral("strcmp"), Fooyin::Scripting::strcmp);
-        funcs.emplace(QStringLiteral("strcmpi"), Fooyin::Scripting::strcmpi);
-        funcs.emplace(QStringLiteral("sep"), Fooyin::Scripting::sep);
-        funcs.emplace(QStringLiteral("swapprefix"), Fooyin::Scripting::swapPrefix);
-
-        funcs.emplace(QStringLiteral("timems"), Fooyin::Scripting::msToString);
-
-        funcs.emplace(QStringLiteral("if"), Fooyin::Scripting::cif);
-        funcs.emplace(QStringLiteral("if2"), Fooyin::Scripting::cif2);
-        funcs.emplace(QStringLiteral("ifgreater"), Fooyin::Scripting::ifgreater);
-        funcs.emplace(QStringLiteral("iflonger"), Fooyin::Scripting::iflonger);
-        funcs.emplace(QStringLiteral("ifequal"), Fooyin::Scripting::ifequal);
+        addFunction(QStringLiteral("add"), Fooyin::Scripting::add);
+        addFunction(QStringLiteral("sub"), Fooyin::Scripting::sub);
+        addFunction(QStringLiteral("mul"), Fooyin::Scripting::mul);
+        addFunction(QStringLiteral("div"), Fooyin::Scripting::div);
+        addFunction(QStringLiteral("min"), Fooyin::Scripting::min);
+        addFunction(QStringLiteral("max"), Fooyin::Scripting::max);
+        addFunction(QStringLiteral("mod"), Fooyin::Scripting::mod);
+
+        addFunction(QStringLiteral("num"), Fooyin::Scripting::num);
+        addFunction(QStringLiteral("replace"), Fooyin::Scripting::replace);
+        addFunction(QStringLiteral("chop"), Fooyin::Scripting::chop);
+        addFunction(QStringLiteral("slice"), Fooyin::Scripting::slice);
+        addFunction(QStringLiteral("left"), Fooyin::Scripting::left);
+        addFunction(QStringLiteral("right"), Fooyin::Scripting::right);
+        addFunction(QStringLiteral("strcmp"), Fooyin::Scripting::strcmp);
+        addFunction(QStringLiteral("strcmpi"), Fooyin::Scripting::strcmpi);
+        addFunction(QStringLiteral("sep"), Fooyin::Scripting::sep);
+        addFunction(QStringLiteral("swapprefix"), Fooyin::Scripting::swapPrefix);
+
+        addFunction(QStringLiteral("timems"), Fooyin::Scripting::msToString);
+
+        addFunction(QStringLiteral("if"), Fooyin::Scripting::cif);
+        addFunction(QStringLiteral("if2"), Fooyin::Scripting::cif2);
+        addFunction(QStringLiteral("ifgreater"), Fooyin::Scripting::ifgreater);
+        addFunction(QStringLiteral("iflonger"), Fooyin::Scripting::iflonger);
+        addFunction(QStringLiteral("ifequal"), Fooyin::Scripting::ifequal);
     }
 
     void addDefaultListFuncs()
     {
-        listProperties.emplace(QStringLiteral("trackcount"), Fooyin::Scripting::trackCount);
-        listProperties.emplace(QStringLiteral("playtime"), Fooyin::Scripting::playtime);
-        listProperties.emplace(QStringLiteral("genres"), Fooyin::Scripting::genres);
+        addListProperty(QStringLiteral("trackcount"), Fooyin::Scripting::trackCount);
+        addListProperty(QStringLiteral("playtime"), Fooyin::Scripting::playtime);
+        addListProperty(QStringLiteral("genres"), Fooyin::Scripting::genres);
     }
 
     void addDefaultMetadata()
@@ -124,35 +181,35 @@ struct ScriptRegistry::Private
         using namespace Fooyin::Constants;
         using Fooyin::Track;
 
-        metadata[QString::fromLatin1(MetaData::Title)]        = &Track::title;
-        metadata[QString::fromLatin1(MetaData::Artist)]       = &Track::artists;
-        metadata[QString::fromLatin1(MetaData::UniqueArtist)] = &Track::uniqueArtists;
-        metadata[QString::fromLatin1(MetaData::Album)]        = &Track::album;
-        metadata[QString::fromLatin1(MetaData::AlbumArtist)]  = &Track::albumArtists;
-        metadata[QString::fromLatin1(MetaData::Track)]        = &Track::trackNumber;
-        metadata[QString::fromLatin1(MetaData::TrackTotal)]   = &Track::trackTotal;
-        metadata[QString::fromLatin1(MetaData::Disc)]         = &Track::discNumber;
-        metadata[QString::fromLatin1(MetaData::DiscTotal)]    = &Track::discTotal;
-        metadata[QString::fromLatin1(MetaData::Genre)]        = &Track::genres;
-        metadata[QString::fromLatin1(MetaData::Composer)]     = &Track::composer;
-        metadata[QString::fromLatin1(MetaData::Performer)]    = &Track::performer;
-        metadata[QString::fromLatin1(MetaData::Duration)]     = &Track::duration;
-        metadata[QString::fromLatin1(MetaData::Comment)]      = &Track::comment;
-        metadata[QString::fromLatin1(MetaData::Date)]         = &Track::date;
-        metadata[QString::fromLatin1(MetaData::Year)]         = &Track::year;
-        // metadata[QString::fromLatin1(MetaData::Cover)]        = &Track::coverPath;
-        metadata[QString::fromLatin1(MetaData::FileSize)]     = &Track::fileSize;
-        metadata[QString::fromLatin1(MetaData::Bitrate)]      = &Track::bitrate;
-        metadata[QString::fromLatin1(MetaData::SampleRate)]   = &Track::sampleRate;
-        metadata[QString::fromLatin1(MetaData::PlayCount)]    = &Track::playCount;
-        metadata[QString::fromLatin1(MetaData::Codec)]        = &Track::typeString;
-        metadata[QString::fromLatin1(MetaData::AddedTime)]    = &Track::addedTime;
-        metadata[QString::fromLatin1(MetaData::ModifiedTime)] = &Track::modifiedTime;
-        metadata[QString::fromLatin1(MetaData::FilePath)]     = &Track::filepath;
-        metadata[QString::fromLatin1(MetaData::RelativePath)] = &Track::relativePath;
-        metadata[QString::fromLatin1(MetaData::FileName)]     = &Track::filename;
-        metadata[QString::fromLatin1(MetaData::Extension)]    = &Track::extension;
-        metadata[QString::fromLatin1(MetaData::Path)]         = &Track::path;
+        addMetadata(MetaData::Title, trackValue<&Track::title>);
+        addMetadata(MetaData::Artist, trackValue<&Track::artists>);
+        addMetadata(MetaData::UniqueArtist, trackValue<&Track::uniqueArtists>);
+        addMetadata(MetaData::Album, trackValue<&Track::album>);
+        addMetadata(MetaData::AlbumArtist, trackValue<&Track::albumArtists>);
+        addMetadata(MetaData::Track, trackValue<&Track::trackNumber>);
+        addMetadata(MetaData::TrackTotal, trackValue<&Track::trackTotal>);
+        addMetadata(MetaData::Disc, trackValue<&Track::discNumber>);
+        addMetadata(MetaData::DiscTotal, trackValue<&Track::discTotal>);
+        addMetadata(MetaData::Genre, trackValue<&Track::genres>);
+        addMetadata(MetaData::Composer, trackValue<&Track::composer>);
+        addMetadata(MetaData::Performer, trackValue<&Track::performer>);
+        addMetadata(MetaData::Duration, trackValue<&Track::duration>);
+        addMetadata(MetaData::Comment, trackValue<&Track::comment>);
+        addMetadata(MetaData::Date, trackValue<&Track::date>);
+        addMetadata(MetaData::Year, trackValue<&Track::year>);
+        // addMetadata(MetaData::Cover, trackValue<&Track::coverPath>);
+        addMetadata(MetaData::FileSize, trackValue<&Track::fileSize>);
+        addMetadata(MetaData::Bitrate, trackValue<&Track::bitrate>);
+        addMetadata(MetaData::SampleRate, trackValue<&Track::sampleRate>);
+        addMetadata(MetaData::PlayCount, trackValue<&Track::playCount>);
+        addMetadata(MetaData::Codec, trackValue<&Track::typeString>);
+        addMetadata(MetaData::AddedTime, trackValue<&Track::addedTime>);
+        addMetadata(MetaData::ModifiedTime, trackValue<&Track::modifiedTime>);
+        addMetadata(MetaData::FilePath, trackValue<&Track::filepath>);
+        addMetadata(MetaData::RelativePath, trackValue<&Track::relativePath>);
+        addMetadata(MetaData::FileName, trackValue<&Track::filename>);
+        addMetadata(MetaData::Extension, trackValue<&Track::extension>);
+        addMetadata(MetaData::Path, trackValue<&Track::path>);
 
         setMetadata[QString::fromLatin1(MetaData::Title)]       = generateSetFunc(&Track::setTitle);
         setMetadata[QString::fromLatin1(MetaData::Artist)]      = generateSetFunc(&Track::setArtists);
@@ -201,20 +258,26 @@ bool ScriptRegistry::isVariable(const QString& var, const TrackList& tracks) con
 
 bool ScriptRegistry::isFunction(const QString& func) const
 {
-    return p->funcs.contains(func);
+    return p->funcIndexes.contains(func);
+}
+
+int ScriptRegistry::functionIndex(const QString& func) const
+{
+    const auto it = p->funcIndexes.find(func);
+    return it != p->funcIndexes.cend() ? it->second : -1;
 }
 
 ScriptResult ScriptRegistry::value(const QString& var, const Track& track) const
 {
-    if(var.isEmpty() || !isVariable(var, track)) {
+    if(var.isEmpty()) {
         return {};
     }
 
-    if(p->metadata.contains(var)) {
-        return calculateResult(p->metadata.at(var)(track));
+    if(const auto it = p->metadata.find(var); it != p->metadata.cend()) {
+        return p->metadataAccessors.at(it->second)(track);
     }
 
-    return calculateResult(track.extraTag(var.toUpper()));
+    return extraTagValue(var.toUpper(), track);
 }
 
 ScriptResult ScriptRegistry::value(const QString& var, const TrackList& tracks) const
@@ -223,27 +286,91 @@ ScriptResult ScriptRegistry::value(const QString& var, const TrackList& tracks)
         return {};
     }
 
-    if(p->listProperties.contains(var)) {
-        return calculateResult(p->listProperties.at(var)(tracks));
+    if(const auto it = p->listProperties.find(var); it != p->listProperties.cend()) {
+        return calculateResult(p->listFuncs.at(it->second)(tracks));
     }
 
     if(!tracks.empty()) {
-        if(p->metadata.contains(var)) {
-            return calculateResult(p->metadata.at(var)(tracks.front()));
+        if(const auto it = p->metadata.find(var); it != p->metadata.cend()) {
+            return p->metadataAccessors.at(it->second)(tracks.front());
         }
-        return calculateResult(tracks.front().extraTag(var.toUpper()));
+        return extraTagValue(var.toUpper(), tracks.front());
     }
 
     return {};
 }
 
+VariableAccessor ScriptRegistry::resolveVariable(const QString& var) const
+{
+    VariableAccessor accessor;
+    accessor.name = var;
+
+    if(var.isEmpty()) {
+        return accessor;
+    }
+
+    if(const auto it = p->listProperties.find(var); it != p->listProperties.cend()) {
+        accessor.type = VariableAccessor::TrackList;
+        accessor.id   = it->second;
+    }
+    else if(const auto metaIt = p->metadata.find(var); metaIt != p->metadata.cend()) {
+        accessor.type = VariableAccessor::Metadata;
+        accessor.id   = metaIt->second;
+    }
+    else {
+        accessor.type = VariableAccessor::ExtraTag;
+        accessor.tag  = var.toUpper();
+    }
+
+    return accessor;
+}
+
+ScriptResult ScriptRegistry::value(const VariableAccessor& accessor, const Track& track) const
+{
+    switch(accessor.type) {
+        case(VariableAccessor::Metadata):
+            return p->metadataAccessors.at(accessor.id)(track);
+        case(VariableAccessor::ExtraTag):
+            return extraTagValue(accessor.tag, track);
+        case(VariableAccessor::TrackList):
+            return {};
+        case(VariableAccessor::Unresolved):
+        default:
+            return value(accessor.name, track);
+    }
+}
+
+ScriptResult ScriptRegistry::value(const VariableAccessor& accessor, const TrackList& tracks) const
+{
+    switch(accessor.type) {
+        case(VariableAccessor::TrackList):
+            return calculateResult(p->listFuncs.at(accessor.id)(tracks));
+        case(VariableAccessor::Metadata):
+            return tracks.empty() ? ScriptResult{} : p->metadataAccessors.at(accessor.id)(tracks.front());
+        case(VariableAccessor::ExtraTag):
+            return tracks.empty() ? ScriptResult{} : extraTagValue(accessor.tag, tracks.front());
+        case(VariableAccessor::Unresolved):
+        default:
+            return value(accessor.name, tracks);
+    }
+}
+
 ScriptResult ScriptRegistry::function(const QString& func, const ScriptValueList& args) const
 {
-    if(func.isEmpty() || !p->funcs.contains(func)) {
+    if(func.isEmpty()) {
+        return {};
+    }
+
+    return function(functionIndex(func), args);
+}
+
+ScriptResult ScriptRegistry::function(int index, const ScriptValueList& args) const
+{
+    if(index < 0 || index >= static_cast<int>(p->funcs.size())) {
         return {};
     }
 
-    auto function = p->funcs.at(func);
+    const auto& function = p->funcs.at(index);
     if(std::holds_alternative<NativeFunc>(function)) {
         const QString value = std::get<NativeFunc>(function)(containerCast<QStringList>(args));
         return {.value = value, .cond = !value.isEmpty()};
@@ -0,0 +1,331 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "scriptvm.h"
+
+#include <core/scripting/scriptregistry.h>
+#include <core/track.h>
+
+namespace {
+using Fooyin::Scripting::Instruction;
+using Fooyin::Scripting::OpCode;
+using Fooyin::Scripting::ScriptProgram;
+
+QStringList evalStringList(const Fooyin::ScriptResult& evalExpr, const QStringList& result)
+{
+    QStringList listResult;
+    const QStringList values = evalExpr.value.split(QStringLiteral("\037"));
+    const bool isEmpty       = result.empty();
+
+    for(const QString& value : values) {
+        if(isEmpty) {
+            listResult.append(value);
+        }
+        else {
+            std::ranges::transform(result, std::back_inserter(listResult),
+                                   [&](const QString& retValue) -> QString { return retValue + value; });
+        }
+    }
+    return listResult;
+}
+
+int addSlot(std::vector<QString>& slots, const QString& value)
+{
+    const auto it = std::ranges::find(slots, value);
+    if(it != slots.cend()) {
+        return static_cast<int>(std::distance(slots.cbegin(), it));
+    }
+    slots.push_back(value);
+    return static_cast<int>(slots.size() - 1);
+}
+
+int addVariable(ScriptProgram& program, const Fooyin::Expression& expr)
+{
+    const auto& name = std::get<QString>(expr.value);
+
+    const auto it = std::ranges::find(program.variables, name, &Fooyin::VariableAccessor::name);
+    if(it != program.variables.cend()) {
+        return static_cast<int>(std::distance(program.variables.cbegin(), it));
+    }
+
+    // Expressions built outside of ScriptParser won't have been resolved
+    program.variables.push_back(expr.accessor.name == name ? expr.accessor
+                                                           : program.registry->resolveVariable(name));
+    return static_cast<int>(program.variables.size() - 1);
+}
+
+void addInstruction(ScriptProgram& program, OpCode op, int operand = 0, int count = 0)
+{
+    program.code.push_back({.op = op, .operand = operand, .count = count});
+}
+
+void compileExpression(ScriptProgram& program, const Fooyin::Expression& expr)
+{
+    using namespace Fooyin;
+
+    switch(expr.type) {
+        case(Expr::Literal):
+            addInstruction(program, OpCode::PushLiteral, addSlot(program.constants, std::get<QString>(expr.value)));
+            break;
+        case(Expr::Variable):
+            addInstruction(program, OpCode::PushVariable, addVariable(program, expr));
+            break;
+        case(Expr::VariableList):
+            addInstruction(program, OpCode::PushVariableList, addVariable(program, expr));
+            break;
+        case(Expr::Function): {
+            const auto& func = std::get<FuncValue>(expr.value);
+            for(const Expression& arg : func.args) {
+                compileExpression(program, arg);
+            }
+            addInstruction(program, OpCode::CallFunction, program.registry->functionIndex(func.name),
+                           static_cast<int>(func.args.size()));
+            break;
+        }
+        case(Expr::FunctionArg): {
+            const auto& args = std::get<ExpressionList>(expr.value);
+            for(const Expression& arg : args) {
+                compileExpression(program, arg);
+            }
+            addInstruction(program, OpCode::JoinArgs, 0, static_cast<int>(args.size()));
+            break;
+        }
+        case(Expr::Conditional): {
+            const auto& args = std::get<ExpressionList>(expr.value);
+            std::vector<size_t> jumps;
+
+            addInstruction(program, OpCode::BeginCondition);
+            for(const Expression& arg : args) {
+                compileExpression(program, arg);
+                jumps.push_back(program.code.size());
+                addInstruction(program, OpCode::AppendCondition, 0, arg.type == Expr::Literal ? 1 : 0);
+            }
+            addInstruction(program, OpCode::EndCondition);
+
+            // A failed condition skips the rest of the block, including EndCondition
+            const int end = static_cast<int>(program.code.size());
+            for(const size_t jump : jumps) {
+                program.code[jump].operand = end;
+            }
+            break;
+        }
+        case(Expr::Null):
+        default:
+            addInstruction(program, OpCode::PushNull);
+            break;
+    }
+}
+
+template <typename Tracks>
+QString run(const ScriptProgram& program, const Tracks& tracks)
+{
+    using namespace Fooyin;
+    using namespace Fooyin::Scripting;
+
+    std::vector<ScriptResult> stack;
+    std::vector<QStringList> conditions;
+    QStringList result;
+
+    const auto& code     = program.code;
+    const auto codeSize  = static_cast<int>(code.size());
+    const auto* registry = program.registry;
+
+    int pc{0};
+    while(pc < codeSize) {
+        const Instruction& instr = code[pc++];
+
+        switch(instr.op) {
+            case(OpCode::PushNull):
+                stack.emplace_back();
+                break;
+            case(OpCode::PushLiteral):
+                stack.push_back({.value = program.constants[instr.operand], .cond = true});
+                break;
+            case(OpCode::PushVariable):
+                stack.push_back(formatVariable(registry->value(program.variables[instr.operand], tracks)));
+                break;
+            case(OpCode::PushVariableList):
+                stack.push_back(registry->value(program.variables[instr.operand], tracks));
+                break;
+            case(OpCode::CallFunction): {
+                const auto first = stack.end() - instr.count;
+                const ScriptValueList args{std::make_move_iterator(first), std::make_move_iterator(stack.end())};
+                stack.erase(first, stack.end());
+                stack.push_back(instr.operand >= 0 ? registry->function(instr.operand, args) : ScriptResult{});
+                break;
+            }
+            case(OpCode::JoinArgs): {
+                ScriptResult arg;
+                bool allPassed{true};
+
+                const auto first = stack.end() - instr.count;
+                for(auto it = first; it != stack.end(); ++it) {
+                    if(!it->cond) {
+                        allPassed = false;
+                    }
+                    appendArg(arg, *it);
+                }
+                arg.cond = allPassed;
+
+                stack.erase(first, stack.end());
+                stack.push_back(std::move(arg));
+                break;
+            }
+            case(OpCode::BeginCondition):
+                conditions.emplace_back();
+                break;
+            case(OpCode::AppendCondition): {
+                const ScriptResult value = std::move(stack.back());
+                stack.pop_back();
+
+                // Literals never fail a condition
+                if(instr.count == 0 && (!value.cond || value.value.isEmpty())) {
+                    conditions.pop_back();
+                    stack.emplace_back();
+                    pc = instr.operand;
+                    break;
+                }
+
+                appendResult(conditions.back(), value);
+                break;
+            }
+            case(OpCode::EndCondition):
+                stack.push_back(conditionResult(conditions.back()));
+                conditions.pop_back();
+                break;
+            case(OpCode::AppendResult): {
+                const ScriptResult value = std::move(stack.back());
+                stack.pop_back();
+
+                if(!value.value.isNull()) {
+                    appendResult(result, value);
+                }
+                break;
+            }
+        }
+    }
+
+    return joinResult(result);
+}
+} // namespace
+
+namespace Fooyin::Scripting {
+ScriptProgramPtr compile(const ExpressionList& expressions, const ScriptRegistry* registry)
+{
+    if(!registry) {
+        return {};
+    }
+
+    auto program      = std::make_shared<ScriptProgram>();
+    program->registry = registry;
+
+    for(const Expression& expr : expressions) {
+        compileExpression(*program, expr);
+        addInstruction(*program, OpCode::AppendResult);
+    }
+
+    return program;
+}
+
+QString execute(const ScriptProgram& program, const Track& track)
+{
+    return run(program, track);
+}
+
+QString execute(const ScriptProgram& program, const TrackList& tracks)
+{
+    return run(program, tracks);
+}
+
+ScriptResult formatVariable(ScriptResult result)
+{
+    if(!result.cond) {
+        return {};
+    }
+
+    if(result.value.contains(u"\037")) {
+        result.value = result.value.replace(QStringLiteral("\037"), QStringLiteral(", "));
+    }
+
+    return result;
+}
+
+void appendArg(ScriptResult& result, const ScriptResult& arg)
+{
+    if(arg.value.contains(u"\037")) {
+        QStringList newResult;
+        const auto values = arg.value.split(QStringLiteral("\037"));
+        std::ranges::transform(values, std::back_inserter(newResult),
+                               [&](const auto& value) { return result.value + value; });
+        result.value = newResult.join(u"\037");
+    }
+    else {
+        result.value = result.value + arg.value;
+    }
+}
+
+void appendResult(QStringList& result, const ScriptResult& value)
+{
+    if(value.value.contains(u"\037")) {
+        const QStringList evalList = evalStringList(value, result);
+        if(!evalList.empty()) {
+            result = evalList;
+        }
+    }
+    else {
+        if(result.empty()) {
+            result.push_back(value.value);
+        }
+        else {
+            std::ranges::transform(result, result.begin(),
+                                   [&](const QString& retValue) -> QString { return retValue + value.value; });
+        }
+    }
+}
+
+ScriptResult conditionResult(const QStringList& result)
+{
+    ScriptResult condResult;
+    condResult.cond = true;
+
+    if(result.size() == 1) {
+        condResult.value = result.constFirst();
+    }
+    else if(result.size() > 1) {
+        condResult.value = result.join(u"\037");
+    }
+
+    return condResult;
+}
+
+QString joinResult(const QStringList& result)
+{
+    if(result.size() == 1) {
+        // Calling join on a QStringList with a single empty string will return a null QString, so return the first
+        // result.
+        return result.constFirst();
+    }
+
+    if(result.size() > 1) {
+        return result.join(u"\037");
+    }
+
+    return {};
+}
+} // namespace Fooyin::Scripting
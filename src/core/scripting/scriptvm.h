@@ -0,0 +1,81 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <core/scripting/expression.h>
+#include <core/scripting/scriptvalue.h>
+#include <core/trackfwd.h>
+
+#include <QStringList>
+
+namespace Fooyin {
+class ScriptRegistry;
+
+namespace Scripting {
+enum class OpCode : uint8_t
+{
+    PushNull = 0,
+    PushLiteral,
+    PushVariable,
+    PushVariableList,
+    CallFunction,
+    JoinArgs,
+    BeginCondition,
+    AppendCondition,
+    EndCondition,
+    AppendResult,
+};
+
+struct Instruction
+{
+    OpCode op{OpCode::PushNull};
+    // Constant/variable/function slot, or jump target for AppendCondition
+    int operand{0};
+    // Argument count, or whether the condition operand is a literal for AppendCondition
+    int count{0};
+};
+
+/*!
+ * A ParsedScript flattened into bytecode for a small stack machine.
+ * Function and variable names are resolved in @p registry at compile time, so a program
+ * can only be executed against the registry it was compiled with.
+ */
+struct ScriptProgram
+{
+    const ScriptRegistry* registry{nullptr};
+    std::vector<Instruction> code;
+    std::vector<QString> constants;
+    std::vector<VariableAccessor> variables;
+};
+using ScriptProgramPtr = std::shared_ptr<ScriptProgram>;
+
+ScriptProgramPtr compile(const ExpressionList& expressions, const ScriptRegistry* registry);
+
+QString execute(const ScriptProgram& program, const Track& track);
+QString execute(const ScriptProgram& program, const TrackList& tracks);
+
+// Shared with the tree-walking evaluator so both produce identical results
+ScriptResult formatVariable(ScriptResult result);
+void appendArg(ScriptResult& result, const ScriptResult& arg);
+void appendResult(QStringList& result, const ScriptResult& value);
+ScriptResult conditionResult(const QStringList& result);
+QString joinResult(const QStringList& result);
+} // namespace Scripting
+} // namespace Fooyin
@@ -0,0 +1,196 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "fileformat.h"
+
+#include <taglib/tiostream.h>
+
+#include <algorithm>
+#include <array>
+#include <string_view>
+
+using namespace std::string_view_literals;
+
+namespace {
+using Type = Fooyin::Track::Type;
+
+// Formats which can only be told apart by their contents
+constexpr auto Ambiguous = static_cast<Type>(-1);
+
+constexpr auto MaxExtensionLength = 4;
+constexpr auto SniffLength        = 64;
+
+// Sorted by extension for binary search
+constexpr std::array Extensions{
+    std::pair{"aax"sv, Type::MP4},
+    std::pair{"aif"sv, Type::AIFF},
+    std::pair{"aifc"sv, Type::AIFF},
+    std::pair{"aiff"sv, Type::AIFF},
+    std::pair{"ape"sv, Type::APE},
+    std::pair{"asf"sv, Type::ASF},
+    std::pair{"flac"sv, Type::FLAC},
+    std::pair{"m4a"sv, Type::MP4},
+    std::pair{"m4b"sv, Type::MP4},
+    std::pair{"mp+"sv, Type::MPC},
+    std::pair{"mp2"sv, Type::MPEG},
+    std::pair{"mp3"sv, Type::MPEG},
+    std::pair{"mp4"sv, Type::MP4},
+    std::pair{"mpc"sv, Type::MPC},
+    std::pair{"mpga"sv, Type::MPEG},
+    std::pair{"mpp"sv, Type::MPC},
+    std::pair{"oga"sv, Ambiguous},
+    std::pair{"ogg"sv, Ambiguous},
+    std::pair{"opus"sv, Type::OggOpus},
+    std::pair{"wav"sv, Type::WAV},
+    std::pair{"wma"sv, Type::ASF},
+    std::pair{"wv"sv, Type::WavPack},
+};
+static_assert(std::ranges::is_sorted(Extensions, {}, &decltype(Extensions)::value_type::first));
+
+Type formatForExtension(const QString& filepath)
+{
+    const auto dot = filepath.lastIndexOf(u'.');
+    if(dot < 0 || filepath.indexOf(u'/', dot) >= 0) {
+        return Type::Unknown;
+    }
+
+    const auto length = filepath.size() - dot - 1;
+    if(length <= 0 || length > MaxExtensionLength) {
+        return Type::Unknown;
+    }
+
+    std::array<char, MaxExtensionLength> buffer{};
+    for(qsizetype i{0}; i < length; ++i) {
+        const char16_t ch = filepath.at(dot + 1 + i).toLower().unicode();
+        if(ch > 0x7f) {
+            return Type::Unknown;
+        }
+        buffer[i] = static_cast<char>(ch);
+    }
+
+    const std::string_view extension{buffer.data(), static_cast<size_t>(length)};
+
+    const auto it = std::ranges::lower_bound(Extensions, extension, {}, &decltype(Extensions)::value_type::first);
+    if(it != Extensions.cend() && it->first == extension) {
+        return it->second;
+    }
+
+    return Type::Unknown;
+}
+
+bool startsWith(std::string_view data, std::string_view magic, size_t offset = 0)
+{
+    return data.size() >= offset + magic.size() && data.substr(offset, magic.size()) == magic;
+}
+
+Type formatForOgg(std::string_view data)
+{
+    if(data.size() < 27) {
+        return Type::Unknown;
+    }
+
+    // The first packet follows the page header and its segment table
+    const size_t packetStart = 27 + static_cast<unsigned char>(data[26]);
+
+    if(startsWith(data, "\x01vorbis"sv, packetStart)) {
+        return Type::OggVorbis;
+    }
+    if(startsWith(data, "OpusHead"sv, packetStart)) {
+        return Type::OggOpus;
+    }
+
+    return Type::Unknown;
+}
+
+Type formatForContents(TagLib::IOStream* stream)
+{
+    stream->seek(0);
+    const TagLib::ByteVector header = stream->readBlock(SniffLength);
+    const std::string_view data{header.data(), header.size()};
+
+    Type type{Type::Unknown};
+
+    if(startsWith(data, "OggS"sv)) {
+        type = formatForOgg(data);
+    }
+    else if(startsWith(data, "ID3"sv) && data.size() >= 10) {
+        // FLAC files are sometimes prefixed with an ID3v2 tag
+        long tagSize{0};
+        for(size_t i{6}; i < 10; ++i) {
+            tagSize = (tagSize << 7) | (static_cast<unsigned char>(data[i]) & 0x7f);
+        }
+        tagSize += 10;
+        if((static_cast<unsigned char>(data[5]) & 0x10) != 0) {
+            tagSize += 10;
+        }
+
+        stream->seek(tagSize);
+        const TagLib::ByteVector next = stream->readBlock(4);
+        type = std::string_view{next.data(), next.size()} == "fLaC"sv ? Type::FLAC : Type::MPEG;
+    }
+    else if(startsWith(data, "fLaC"sv)) {
+        type = Type::FLAC;
+    }
+    else if((startsWith(data, "RIFF"sv) || startsWith(data, "RF64"sv)) && startsWith(data, "WAVE"sv, 8)) {
+        type = Type::WAV;
+    }
+    else if(startsWith(data, "FORM"sv) && (startsWith(data, "AIFF"sv, 8) || startsWith(data, "AIFC"sv, 8))) {
+        type = Type::AIFF;
+    }
+    else if(startsWith(data, "ftyp"sv, 4)) {
+        type = Type::MP4;
+    }
+    else if(startsWith(data, "MAC "sv)) {
+        type = Type::APE;
+    }
+    else if(startsWith(data, "wvpk"sv)) {
+        type = Type::WavPack;
+    }
+    else if(startsWith(data, "MPCK"sv) || startsWith(data, "MP+"sv)) {
+        type = Type::MPC;
+    }
+    else if(startsWith(data, "\x30\x26\xb2\x75\x8e\x66\xcf\x11"sv)) {
+        type = Type::ASF;
+    }
+    else if(data.size() >= 2 && static_cast<unsigned char>(data[0]) == 0xff
+            && (static_cast<unsigned char>(data[1]) & 0xe0) == 0xe0) {
+        type = Type::MPEG;
+    }
+
+    stream->seek(0);
+
+    return type;
+}
+} // namespace
+
+namespace Fooyin::Tagging {
+Track::Type detectFormat(const QString& filepath, TagLib::IOStream* stream)
+{
+    const Type type = formatForExtension(filepath);
+    if(type != Ambiguous && type != Type::Unknown) {
+        return type;
+    }
+
+    if(!stream || !stream->isOpen()) {
+        return Type::Unknown;
+    }
+
+    return formatForContents(stream);
+}
+} // namespace Fooyin::Tagging
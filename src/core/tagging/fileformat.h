@@ -0,0 +1,37 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fycore_export.h"
+
+#include <core/track.h>
+
+namespace TagLib {
+class IOStream;
+}
+
+namespace Fooyin::Tagging {
+/*!
+ * Determines the format of @p filepath from its extension, only reading the start of @p stream
+ * if the extension is missing or shared between formats (e.g. Vorbis and Opus in .ogg).
+ * The stream is left at the start of the file.
+ */
+FYCORE_EXPORT Track::Type detectFormat(const QString& filepath, TagLib::IOStream* stream);
+} // namespace Fooyin::Tagging
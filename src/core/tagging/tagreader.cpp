@@ -19,6 +19,7 @@
 
 #include "tagreader.h"
 
+#include "fileformat.h"
 #include "tagdefs.h"
 
 #include <core/constants.h>
@@ -51,7 +52,6 @@
 #include <QCryptographicHash>
 #include <QDir>
 #include <QFileInfo>
-#include <QMimeDatabase>
 #include <QPixmap>
 
 #include <set>
@@ -160,47 +160,6 @@ QStringList convertStringList(const TagLib::StringList& strList)
     return list;
 }
 
-Fooyin::Track::Type typeForMime(const QString& mimeType)
-{
-    if(mimeType == QStringLiteral("audio/mpeg") || mimeType == QStringLiteral("audio/mpeg3")
-       || mimeType == QStringLiteral("audio/x-mpeg")) {
-        return Fooyin::Track::Type::MPEG;
-    }
-    if(mimeType == QStringLiteral("audio/x-aiff") || mimeType == QStringLiteral("audio/x-aifc")) {
-        return Fooyin::Track::Type::AIFF;
-    }
-    if(mimeType == QStringLiteral("audio/vnd.wave") || mimeType == QStringLiteral("audio/wav")
-       || mimeType == QStringLiteral("audio/x-wav")) {
-        return Fooyin::Track::Type::WAV;
-    }
-    if(mimeType == QStringLiteral("audio/x-musepack")) {
-        return Fooyin::Track::Type::MPC;
-    }
-    if(mimeType == QStringLiteral("audio/x-ape")) {
-        return Fooyin::Track::Type::APE;
-    }
-    if(mimeType == QStringLiteral("audio/x-wavpack")) {
-        return Fooyin::Track::Type::WavPack;
-    }
-    if(mimeType == QStringLiteral("audio/mp4") || mimeType == QStringLiteral("audio/vnd.audible.aax")) {
-        return Fooyin::Track::Type::MP4;
-    }
-    if(mimeType == QStringLiteral("audio/flac")) {
-        return Fooyin::Track::Type::FLAC;
-    }
-    if(mimeType == QStringLiteral("audio/ogg") || mimeType == QStringLiteral("audio/x-vorbis+ogg")) {
-        return Fooyin::Track::Type::OggVorbis;
-    }
-    if(mimeType == QStringLiteral("audio/opus") || mimeType == QStringLiteral("audio/x-opus+ogg")) {
-        return Fooyin::Track::Type::OggOpus;
-    }
-    if(mimeType == QStringLiteral("audio/x-ms-wma")) {
-        return Fooyin::Track::Type::ASF;
-    }
-
-    return Fooyin::Track::Type::Unknown;
-}
-
 TagLib::AudioProperties::ReadStyle readStyle(Fooyin::Tagging::Quality quality)
 {
     switch(quality) {
@@ -648,7 +607,6 @@ QByteArray readAsfCover(const TagLib::ASF::Tag* asfTags, Fooyin::Track::Cover co
 } // namespace
 
 namespace Fooyin::Tagging {
-// TODO: Implement a file/mime type resolver
 bool readMetaData(Track& track, Quality quality)
 {
     const auto filepath = track.filepath();
@@ -670,8 +628,7 @@ bool readMetaData(Track& track, Quality quality)
         return false;
     }
 
-    const QMimeDatabase mimeDb;
-    QString mimeType = mimeDb.mimeTypeForFile(filepath).name();
+    const Track::Type type = detectFormat(filepath, &stream);
     const auto style = readStyle(quality);
 
     const auto readProperties = [&track](const TagLib::File& file, bool skipExtra = false) {
@@ -679,12 +636,7 @@ bool readMetaData(Track& track, Quality quality)
         readGeneralProperties(file.properties(), track, skipExtra);
     };
 
-    if(mimeType == QStringLiteral("audio/ogg") || mimeType == QStringLiteral("audio/x-vorbis+ogg")) {
-        // Workaround for opus files with ogg suffix returning incorrect type
-        mimeType = mimeDb.mimeTypeForFile(filepath, QMimeDatabase::MatchContent).name();
-    }
-    if(mimeType == QStringLiteral("audio/mpeg") || mimeType == QStringLiteral("audio/mpeg3")
-       || mimeType == QStringLiteral("audio/x-mpeg")) {
+    if(type == Track::Type::MPEG) {
 #if(TAGLIB_MAJOR_VERSION >= 2)
         TagLib::MPEG::File file(&stream, true, style, TagLib::ID3v2::FrameFactory::instance());
 #else
@@ -697,7 +649,7 @@ bool readMetaData(Track& track, Quality quality)
             }
         }
     }
-    else if(mimeType == QStringLiteral("audio/x-aiff") || mimeType == QStringLiteral("audio/x-aifc")) {
+    else if(type == Track::Type::AIFF) {
         const TagLib::RIFF::AIFF::File file(&stream, true, style);
         if(file.isValid()) {
             readProperties(file);
@@ -706,8 +658,7 @@ bool readMetaData(Track& track, Quality quality)
             }
         }
     }
-    else if(mimeType == QStringLiteral("audio/vnd.wave") || mimeType == QStringLiteral("audio/wav")
-            || mimeType == QStringLiteral("audio/x-wav")) {
+    else if(type == Track::Type::WAV) {
         const TagLib::RIFF::WAV::File file(&stream, true, style);
         if(file.isValid()) {
             readProperties(file);
@@ -716,7 +667,7 @@ bool readMetaData(Track& track, Quality quality)
             }
         }
     }
-    else if(mimeType == QStringLiteral("audio/x-musepack")) {
+    else if(type == Track::Type::MPC) {
         TagLib::MPC::File file(&stream, true, style);
         if(file.isValid()) {
             readProperties(file);
@@ -725,7 +676,7 @@ bool readMetaData(Track& track, Quality quality)
             }
         }
     }
-    else if(mimeType == QStringLiteral("audio/x-ape")) {
+    else if(type == Track::Type::APE) {
         TagLib::APE::File file(&stream, true, style);
         if(file.isValid()) {
             readProperties(file);
@@ -734,7 +685,7 @@ bool readMetaData(Track& track, Quality quality)
             }
         }
     }
-    else if(mimeType == QStringLiteral("audio/x-wavpack")) {
+    else if(type == Track::Type::WavPack) {
         TagLib::WavPack::File file(&stream, true, style);
         if(file.isValid()) {
             readProperties(file);
@@ -743,7 +694,7 @@ bool readMetaData(Track& track, Quality quality)
             }
         }
     }
-    else if(mimeType == QStringLiteral("audio/mp4") || mimeType == QStringLiteral("audio/vnd.audible.aax")) {
+    else if(type == Track::Type::MP4) {
         const TagLib::MP4::File file(&stream, true, style);
         if(file.isValid()) {
             readProperties(file, true);
@@ -752,7 +703,7 @@ bool readMetaData(Track& track, Quality quality)
             }
         }
     }
-    else if(mimeType == QStringLiteral("audio/flac")) {
+    else if(type == Track::Type::FLAC) {
 #if(TAGLIB_MAJOR_VERSION >= 2)
         TagLib::FLAC::File file(&stream, true, style, TagLib::ID3v2::FrameFactory::instance());
 #else
@@ -765,7 +716,7 @@ bool readMetaData(Track& track, Quality quality)
             }
         }
     }
-    else if(mimeType == QStringLiteral("audio/ogg") || mimeType == QStringLiteral("audio/x-vorbis+ogg")) {
+    else if(type == Track::Type::OggVorbis) {
         const TagLib::Ogg::Vorbis::File file(&stream, true, style);
         if(file.isValid()) {
             readProperties(file);
@@ -774,7 +725,7 @@ bool readMetaData(Track& track, Quality quality)
             }
         }
     }
-    else if(mimeType == QStringLiteral("audio/opus") || mimeType == QStringLiteral("audio/x-opus+ogg")) {
+    else if(type == Track::Type::OggOpus) {
         const TagLib::Ogg::Opus::File file(&stream, true, style);
         if(file.isValid()) {
             readProperties(file);
@@ -783,7 +734,7 @@ bool readMetaData(Track& track, Quality quality)
             }
         }
     }
-    else if(mimeType == QStringLiteral("audio/x-ms-wma")) {
+    else if(type == Track::Type::ASF) {
         const TagLib::ASF::File file(&stream, true, style);
         if(file.isValid()) {
             readProperties(file);
@@ -793,10 +744,10 @@ bool readMetaData(Track& track, Quality quality)
         }
     }
     else {
-        qDebug() << "Unsupported mime type: " << mimeType;
+        qDebug() << "Unsupported file type: " << filepath;
     }
 
-    track.setType(typeForMime(mimeType));
+    track.setType(type);
     track.generateHash();
 
     return true;
@@ -817,16 +768,10 @@ QByteArray readCover(const Track& track, Track::Cover cover)
         return {};
     }
 
-    const QMimeDatabase mimeDb;
-    QString mimeType = mimeDb.mimeTypeForFile(filepath).name();
+    const Track::Type type = detectFormat(filepath, &stream);
     const auto style = TagLib::AudioProperties::Average;
 
-    if(mimeType == QStringLiteral("audio/ogg") || mimeType == QStringLiteral("audio/x-vorbis+ogg")) {
-        // Workaround for opus files with ogg suffix returning incorrect type
-        mimeType = mimeDb.mimeTypeForFile(filepath, QMimeDatabase::MatchContent).name();
-    }
-    if(mimeType == QStringLiteral("audio/mpeg") || mimeType == QStringLiteral("audio/mpeg3")
-       || mimeType == QStringLiteral("audio/x-mpeg")) {
+    if(type == Track::Type::MPEG) {
 #if(TAGLIB_MAJOR_VERSION >= 2)
         TagLib::MPEG::File file(&stream, true, style, TagLib::ID3v2::FrameFactory::instance());
 #else
@@ -836,44 +781,43 @@ QByteArray readCover(const Track& track, Track::Cover cover)
             return readId3Cover(file.ID3v2Tag(), cover);
         }
     }
-    else if(mimeType == QStringLiteral("audio/x-aiff") || mimeType == QStringLiteral("audio/x-aifc")) {
+    else if(type == Track::Type::AIFF) {
         const TagLib::RIFF::AIFF::File file(&stream, true);
         if(file.isValid() && file.hasID3v2Tag()) {
             return readId3Cover(file.tag(), cover);
         }
     }
-    else if(mimeType == QStringLiteral("audio/vnd.wave") || mimeType == QStringLiteral("audio/wav")
-            || mimeType == QStringLiteral("audio/x-wav")) {
+    else if(type == Track::Type::WAV) {
         const TagLib::RIFF::WAV::File file(&stream, true);
         if(file.isValid() && file.hasID3v2Tag()) {
             return readId3Cover(file.ID3v2Tag(), cover);
         }
     }
-    else if(mimeType == QStringLiteral("audio/x-musepack")) {
+    else if(type == Track::Type::MPC) {
         TagLib::MPC::File file(&stream, true);
         if(file.isValid() && file.APETag()) {
             return readApeCover(file.APETag(), cover);
         }
     }
-    else if(mimeType == QStringLiteral("audio/x-ape")) {
+    else if(type == Track::Type::APE) {
         TagLib::APE::File file(&stream, true);
         if(file.isValid() && file.APETag()) {
             return readApeCover(file.APETag(), cover);
         }
     }
-    else if(mimeType == QStringLiteral("audio/x-wavpack")) {
+    else if(type == Track::Type::WavPack) {
         TagLib::WavPack::File file(&stream, true);
         if(file.isValid() && file.APETag()) {
             return readApeCover(file.APETag(), cover);
         }
     }
-    else if(mimeType == QStringLiteral("audio/mp4") || mimeType == QStringLiteral("audio/vnd.audible.aax")) {
+    else if(type == Track::Type::MP4) {
         const TagLib::MP4::File file(&stream, true);
         if(file.isValid() && file.tag()) {
             return readMp4Cover(file.tag(), cover);
         }
     }
-    else if(mimeType == QStringLiteral("audio/flac")) {
+    else if(type == Track::Type::FLAC) {
 #if(TAGLIB_MAJOR_VERSION >= 2)
         TagLib::FLAC::File file(&stream, true, style, TagLib::ID3v2::FrameFactory::instance());
 #else
@@ -883,19 +827,19 @@ QByteArray readCover(const Track& track, Track::Cover cover)
             return readFlacCover(file.pictureList(), cover);
         }
     }
-    else if(mimeType == QStringLiteral("audio/ogg") || mimeType == QStringLiteral("audio/x-vorbis+ogg")) {
+    else if(type == Track::Type::OggVorbis) {
         const TagLib::Ogg::Vorbis::File file(&stream, true);
         if(file.isValid() && file.tag()) {
             return readFlacCover(file.tag()->pictureList(), cover);
         }
     }
-    else if(mimeType == QStringLiteral("audio/opus") || mimeType == QStringLiteral("audio/x-opus+ogg")) {
+    else if(type == Track::Type::OggOpus) {
         const TagLib::Ogg::Opus::File file(&stream, true);
         if(file.isValid() && file.tag()) {
             return readFlacCover(file.tag()->pictureList(), cover);
         }
     }
-    else if(mimeType == QStringLiteral("audio/x-ms-wma")) {
+    else if(type == Track::Type::ASF) {
         const TagLib::ASF::File file(&stream, true);
         if(file.isValid() && file.tag()) {
             return readAsfCover(file.tag(), cover);
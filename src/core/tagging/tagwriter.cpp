@@ -19,6 +19,7 @@
 
 #include "tagwriter.h"
 
+#include "fileformat.h"
 #include "tagdefs.h"
 
 #include <core/track.h>
@@ -47,7 +48,6 @@
 #include <taglib/wavpackfile.h>
 
 #include <QFileInfo>
-#include <QMimeDatabase>
 
 #include <set>
 
@@ -441,16 +441,10 @@ bool writeMetaData(const Track& track)
         file.setProperties(savedProperties);
     };
 
-    const QMimeDatabase mimeDb;
-    QString mimeType = mimeDb.mimeTypeForFile(filepath).name();
+    const Track::Type type = detectFormat(filepath, &stream);
     const auto style = TagLib::AudioProperties::Average;
 
-    if(mimeType == QStringLiteral("audio/ogg") || mimeType == QStringLiteral("audio/x-vorbis+ogg")) {
-        // Workaround for opus files with ogg suffix returning incorrect type
-        mimeType = mimeDb.mimeTypeForFile(filepath, QMimeDatabase::MatchContent).name();
-    }
-    if(mimeType == QStringLiteral("audio/mpeg") || mimeType == QStringLiteral("audio/mpeg3")
-       || mimeType == QStringLiteral("audio/x-mpeg")) {
+    if(type == Track::Type::MPEG) {
 #if(TAGLIB_MAJOR_VERSION >= 2)
         TagLib::MPEG::File file(&stream, true, style, TagLib::ID3v2::FrameFactory::instance());
 #else
@@ -464,7 +458,7 @@ bool writeMetaData(const Track& track)
             file.save();
         }
     }
-    else if(mimeType == QStringLiteral("audio/x-aiff") || mimeType == QStringLiteral("audio/x-aifc")) {
+    else if(type == Track::Type::AIFF) {
         TagLib::RIFF::AIFF::File file(&stream, false);
         if(file.isValid()) {
             writeProperties(file);
@@ -474,8 +468,7 @@ bool writeMetaData(const Track& track)
             file.save();
         }
     }
-    else if(mimeType == QStringLiteral("audio/vnd.wave") || mimeType == QStringLiteral("audio/wav")
-            || mimeType == QStringLiteral("audio/x-wav")) {
+    else if(type == Track::Type::WAV) {
         TagLib::RIFF::WAV::File file(&stream, false);
         if(file.isValid()) {
             writeProperties(file);
@@ -485,7 +478,7 @@ bool writeMetaData(const Track& track)
             file.save();
         }
     }
-    else if(mimeType == QStringLiteral("audio/x-musepack")) {
+    else if(type == Track::Type::MPC) {
         TagLib::MPC::File file(&stream, false);
         if(file.isValid()) {
             writeProperties(file);
@@ -495,7 +488,7 @@ bool writeMetaData(const Track& track)
             file.save();
         }
     }
-    else if(mimeType == QStringLiteral("audio/x-ape")) {
+    else if(type == Track::Type::APE) {
         TagLib::APE::File file(&stream, false);
         if(file.isValid()) {
             writeProperties(file);
@@ -505,7 +498,7 @@ bool writeMetaData(const Track& track)
             file.save();
         }
     }
-    else if(mimeType == QStringLiteral("audio/x-wavpack")) {
+    else if(type == Track::Type::WavPack) {
         TagLib::WavPack::File file(&stream, false);
         if(file.isValid()) {
             writeProperties(file);
@@ -515,7 +508,7 @@ bool writeMetaData(const Track& track)
             file.save();
         }
     }
-    else if(mimeType == QStringLiteral("audio/mp4")) {
+    else if(type == Track::Type::MP4) {
         TagLib::MP4::File file(&stream, false);
         if(file.isValid()) {
             writeProperties(file, true);
@@ -525,7 +518,7 @@ bool writeMetaData(const Track& track)
             file.save();
         }
     }
-    else if(mimeType == QStringLiteral("audio/flac")) {
+    else if(type == Track::Type::FLAC) {
 #if(TAGLIB_MAJOR_VERSION >= 2)
         TagLib::FLAC::File file(&stream, true, style, TagLib::ID3v2::FrameFactory::instance());
 #else
@@ -539,7 +532,7 @@ bool writeMetaData(const Track& track)
             file.save();
         }
     }
-    else if(mimeType == QStringLiteral("audio/ogg") || mimeType == QStringLiteral("audio/x-vorbis+ogg")) {
+    else if(type == Track::Type::OggVorbis) {
         TagLib::Ogg::Vorbis::File file(&stream, false);
         if(file.isValid()) {
             writeProperties(file);
@@ -549,7 +542,7 @@ bool writeMetaData(const Track& track)
             file.save();
         }
     }
-    else if(mimeType == QStringLiteral("audio/opus") || mimeType == QStringLiteral("audio/x-opus+ogg")) {
+    else if(type == Track::Type::OggOpus) {
         TagLib::Ogg::Opus::File file(&stream, false);
         if(file.isValid()) {
             writeProperties(file);
@@ -557,7 +550,7 @@ bool writeMetaData(const Track& track)
             file.save();
         }
     }
-    else if(mimeType == QStringLiteral("audio/x-ms-wma")) {
+    else if(type == Track::Type::ASF) {
         TagLib::ASF::File file(&stream, false);
         if(file.isValid()) {
             writeProperties(file);
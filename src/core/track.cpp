@@ -21,11 +21,14 @@
 
 #include <core/constants.h>
 #include <utils/crypto.h>
+#include <utils/stringpool.h>
 
 #include <QFileInfo>
 #include <QIODevice>
 
 namespace Fooyin {
+// Values which repeat across a library (artists, albums, genres etc.) are interned by their setters,
+// so tracks share their storage rather than each holding a copy
 struct Track::Private : public QSharedData
 {
     int libraryId{-1};
@@ -73,7 +76,7 @@ struct Track::Private : public QSharedData
     {
         const QFileInfo fileInfo{this->filepath};
         filename  = fileInfo.fileName();
-        extension = fileInfo.suffix();
+        extension = StringPool::instance().intern(fileInfo.suffix());
     }
 };
 
@@ -449,7 +452,7 @@ void Track::setFilePath(const QString& path)
 
     const QFileInfo fileInfo{path};
     p->filename  = fileInfo.fileName();
-    p->extension = fileInfo.suffix();
+    p->extension = StringPool::instance().intern(fileInfo.suffix());
 }
 
 void Track::setRelativePath(const QString& path)
@@ -468,7 +471,7 @@ void Track::setTitle(const QString& title)
 
 void Track::setArtists(const QStringList& artists)
 {
-    p->artists = artists;
+    p->artists = StringPool::instance().intern(artists);
 
     if(!p->hash.isEmpty()) {
         generateHash();
@@ -477,7 +480,7 @@ void Track::setArtists(const QStringList& artists)
 
 void Track::setAlbum(const QString& title)
 {
-    p->album = title;
+    p->album = StringPool::instance().intern(title);
 
     if(!p->hash.isEmpty()) {
         generateHash();
@@ -486,7 +489,7 @@ void Track::setAlbum(const QString& title)
 
 void Track::setAlbumArtists(const QStringList& artists)
 {
-    p->albumArtists = artists;
+    p->albumArtists = StringPool::instance().intern(artists);
 }
 
 void Track::setTrackNumber(int number)
@@ -519,17 +522,17 @@ void Track::setDiscTotal(int total)
 
 void Track::setGenres(const QStringList& genres)
 {
-    p->genres = genres;
+    p->genres = StringPool::instance().intern(genres);
 }
 
 void Track::setComposer(const QString& composer)
 {
-    p->composer = composer;
+    p->composer = StringPool::instance().intern(composer);
 }
 
 void Track::setPerformer(const QString& performer)
 {
-    p->performer = performer;
+    p->performer = StringPool::instance().intern(performer);
 }
 
 void Track::setDuration(uint64_t duration)
@@ -544,7 +547,7 @@ void Track::setComment(const QString& comment)
 
 void Track::setDate(const QString& date)
 {
-    p->date = date;
+    p->date = StringPool::instance().intern(date);
 
     const QStringList dateParts = date.split(QChar::fromLatin1('-'));
     if(dateParts.empty()) {
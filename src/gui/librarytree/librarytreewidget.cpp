@@ -244,7 +244,7 @@ struct LibraryTreeWidget::Private
 
     void searchChanged(const QString& search)
     {
-        const bool reset = prevSearch.length() > search.length();
+        const bool reset = !Filter::narrowsSearch(prevSearch, search);
         prevSearch       = search;
 
         if(search.isEmpty()) {
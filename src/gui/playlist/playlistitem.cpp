@@ -21,6 +21,7 @@
 
 #include <utils/helpers.h>
 
+#include <atomic>
 #include <utility>
 
 namespace Fooyin {
@@ -34,8 +35,8 @@ PlaylistItem::PlaylistItem(ItemType type, Data data, PlaylistItem* parent)
     , m_state{State::None}
     , m_type{type}
     , m_data{std::move(data)}
-    , m_baseKey{QStringLiteral("0")}
-    , m_key{QStringLiteral("0")}
+    , m_baseKey{0}
+    , m_key{0}
     , m_indentation{0}
     , m_index{-1}
 { }
@@ -60,12 +61,12 @@ Data& PlaylistItem::data() const
     return m_data;
 }
 
-QString PlaylistItem::baseKey() const
+PlaylistItemKey PlaylistItem::baseKey() const
 {
     return m_baseKey;
 }
 
-QString PlaylistItem::key() const
+PlaylistItemKey PlaylistItem::key() const
 {
     return m_key;
 }
@@ -90,12 +91,12 @@ void PlaylistItem::setState(State state)
     m_state = state;
 }
 
-void PlaylistItem::setBaseKey(const QString& key)
+void PlaylistItem::setBaseKey(PlaylistItemKey key)
 {
     m_baseKey = key;
 }
 
-void PlaylistItem::setKey(const QString& key)
+void PlaylistItem::setKey(PlaylistItemKey key)
 {
     m_key = key;
 }
@@ -128,4 +129,10 @@ void PlaylistItem::removeChild(int index)
     TreeItem::removeChild(index);
     m_state = childCount() == 0 ? State::Delete : State::Update;
 }
+
+PlaylistItemKey PlaylistItem::generateKey()
+{
+    static std::atomic<PlaylistItemKey> nextKey{1};
+    return nextKey.fetch_add(1, std::memory_order_relaxed);
+}
 } // namespace Fooyin
@@ -25,6 +25,8 @@
 
 namespace Fooyin {
 using Data = std::variant<PlaylistTrackItem, PlaylistContainerItem>;
+// Identifies an item within a PlaylistModel. The root item always has a key of 0.
+using PlaylistItemKey = uint64_t;
 
 class PlaylistItem : public TreeItem<PlaylistItem>
 {
@@ -70,15 +72,15 @@ public:
     [[nodiscard]] State state() const;
     [[nodiscard]] ItemType type() const;
     [[nodiscard]] Data& data() const;
-    [[nodiscard]] QString baseKey() const;
-    [[nodiscard]] QString key() const;
+    [[nodiscard]] PlaylistItemKey baseKey() const;
+    [[nodiscard]] PlaylistItemKey key() const;
     [[nodiscard]] int indentation() const;
     [[nodiscard]] int index() const;
 
     void setPending(bool pending);
     void setState(State state);
-    void setBaseKey(const QString& key);
-    void setKey(const QString& key);
+    void setBaseKey(PlaylistItemKey key);
+    void setKey(PlaylistItemKey key);
     void setIndentation(int indentation);
     void setIndex(int index);
 
@@ -86,13 +88,16 @@ public:
     void insertChild(int row, PlaylistItem* child) override;
     void removeChild(int index) override;
 
+    // Returns a new unique key; safe to call from any thread
+    static PlaylistItemKey generateKey();
+
 private:
     bool m_pending;
     State m_state;
     ItemType m_type;
     mutable Data m_data;
-    QString m_baseKey;
-    QString m_key;
+    PlaylistItemKey m_baseKey;
+    PlaylistItemKey m_key;
     int m_indentation;
     int m_index;
 };
@@ -32,7 +32,6 @@
 #include <gui/coverprovider.h>
 #include <gui/guiconstants.h>
 #include <gui/guisettings.h>
-#include <utils/crypto.h>
 #include <utils/settings/settingsmanager.h>
 #include <utils/utils.h>
 
@@ -48,6 +47,11 @@
 #include <stack>
 
 namespace {
+size_t cacheLimit(int sizeMiB)
+{
+    return static_cast<size_t>(std::max(sizeMiB, 0)) * 1024 * 1024;
+}
+
 bool cmpItemsPlaylistItems(Fooyin::PlaylistItem* pItem1, Fooyin::PlaylistItem* pItem2, bool reverse = false)
 {
     Fooyin::PlaylistItem* item1{pItem1};
@@ -155,8 +159,8 @@ int determineDropIndex(const QAbstractItemModel* model, const QModelIndex& paren
 
 Fooyin::PlaylistItem* cloneParent(Fooyin::ItemKeyMap& nodes, Fooyin::PlaylistItem* parent)
 {
-    const QString parentKey = Fooyin::Utils::generateRandomHash();
-    auto* newParent         = &nodes.emplace(parentKey, *parent).first->second;
+    const Fooyin::PlaylistItemKey parentKey = Fooyin::PlaylistItem::generateKey();
+    auto* newParent                         = &nodes.emplace(parentKey, *parent).first->second;
     newParent->setKey(parentKey);
     newParent->resetRow();
     newParent->clearChildren();
@@ -501,6 +505,7 @@ PlaylistModel::PlaylistModel(MusicLibrary* library, PlayerController* playerCont
     , m_coverSize{settings->value<Settings::Gui::Internal::PlaylistThumbnailSize>(),
                   settings->value<Settings::Gui::Internal::PlaylistThumbnailSize>()}
     , m_populator{playerController}
+    , m_cache{cacheLimit(settings->value<Settings::Gui::Internal::PlaylistModelCacheSize>())}
     , m_playlistLoaded{false}
     , m_currentPlaylist{nullptr}
     , m_currentPlayState{PlayState::Stopped}
@@ -532,6 +537,9 @@ PlaylistModel::PlaylistModel(MusicLibrary* library, PlayerController* playerCont
         emit dataChanged({}, {}, {Qt::DecorationRole});
     });
 
+    m_settings->subscribe<Settings::Gui::Internal::PlaylistModelCacheSize>(
+        this, [this](int size) { m_cache.setLimit(cacheLimit(size)); });
+
     m_settings->subscribe<Settings::Gui::IconTheme>(this, [this]() {
         m_playingIcon = Utils::iconFromTheme(Constants::Icons::Play).pixmap(20);
         m_pausedIcon  = Utils::iconFromTheme(Constants::Icons::Pause).pixmap(20);
@@ -622,7 +630,7 @@ QVariant PlaylistModel::data(const QModelIndex& index, int role) const
     }
 
     if(role == PlaylistItem::BaseKey) {
-        return item->baseKey();
+        return QVariant::fromValue(item->baseKey());
     }
 
     if(role == PlaylistItem::SingleColumnMode) {
@@ -675,7 +683,7 @@ void PlaylistModel::fetchMore(const QModelIndex& parent)
     const auto rowsToInsert = std::views::take(rows, rowCount);
 
     beginInsertRows(parent, row, row + rowCount - 1);
-    for(const QString& pendingRow : rowsToInsert) {
+    for(const PlaylistItemKey pendingRow : rowsToInsert) {
         PlaylistItem& child = m_nodes.at(pendingRow);
         fetchChildren(parentItem, &child);
     }
@@ -890,6 +898,10 @@ void PlaylistModel::changeColumnAlignment(int column, Qt::Alignment alignment)
 
 void PlaylistModel::reset(const PlaylistPreset& preset, const PlaylistColumnList& columns, Playlist* playlist)
 {
+    // Only switching playlists is cached; resetting the same playlist means its contents or layout changed
+    const bool switchingPlaylist = playlist && m_currentPlaylist && playlist != m_currentPlaylist;
+    const bool cached            = switchingPlaylist && cacheCurrentPlaylist();
+
     if(preset.isValid()) {
         m_currentPreset = preset;
     }
@@ -902,12 +914,24 @@ void PlaylistModel::reset(const PlaylistPreset& preset, const PlaylistColumnList
 
     m_populator.stopThread();
 
-    m_playlistLoaded  = false;
-    m_resetting       = true;
     m_currentPlaylist = playlist;
 
     updateHeader(playlist);
 
+    if(switchingPlaylist && restoreCachedPlaylist()) {
+        return;
+    }
+
+    if(cached) {
+        // The view mustn't keep pointing at items now owned by the cache
+        beginResetModel();
+        resetRoot();
+        endResetModel();
+    }
+
+    m_playlistLoaded = false;
+    m_resetting      = true;
+
     QMetaObject::invokeMethod(&m_populator, [this, playlist] {
         m_populator.run(m_currentPlaylist->id(), m_currentPreset, m_columns, playlist->tracks());
     });
@@ -927,7 +951,7 @@ TrackIndexResult PlaylistModel::trackIndexAtPlaylistIndex(int index, bool fetch)
         }
 
         if(m_trackIndexes.contains(index)) {
-            const QString key = m_trackIndexes.at(index);
+            const PlaylistItemKey key = m_trackIndexes.at(index);
             if(m_nodes.contains(key)) {
                 auto& item = m_nodes.at(key);
                 return {indexOfItem(&item), false};
@@ -937,7 +961,7 @@ TrackIndexResult PlaylistModel::trackIndexAtPlaylistIndex(int index, bool fetch)
 
     // End of playlist - return last track index
     const auto lastIndex = static_cast<int>(m_trackIndexes.size()) - 1;
-    const QString key    = m_trackIndexes.at(lastIndex);
+    const PlaylistItemKey key = m_trackIndexes.at(lastIndex);
     if(m_nodes.contains(key)) {
         auto& item = m_nodes.at(key);
         return {indexOfItem(&item), true};
@@ -1032,6 +1056,20 @@ void PlaylistModel::removeTracks(const TrackGroups& groups)
     removeTracks(rows);
 }
 
+void PlaylistModel::updateCachedTracks(Playlist* playlist, const std::vector<int>& indexes)
+{
+    if(playlist) {
+        m_cache.tracksChanged(playlist->id(), playlist->trackCount(), indexes);
+    }
+}
+
+void PlaylistModel::removeCachedPlaylist(Playlist* playlist)
+{
+    if(playlist) {
+        m_cache.remove(playlist->id());
+    }
+}
+
 void PlaylistModel::updateHeader(Playlist* playlist)
 {
     if(playlist) {
@@ -1099,6 +1137,65 @@ void PlaylistModel::playStateChanged(PlayState state)
     emit dataChanged({}, {}, {Qt::DecorationRole, Qt::BackgroundRole});
 }
 
+bool PlaylistModel::cacheCurrentPlaylist()
+{
+    if(!m_currentPlaylist || !m_playlistLoaded || m_resetting || m_populator.state() == Worker::Running
+       || !m_indexesPendingRemoval.empty()) {
+        return false;
+    }
+
+    PlaylistModelState state;
+    state.nodes        = std::move(m_nodes);
+    state.pendingNodes = std::move(m_pendingNodes);
+    state.trackParents = std::move(m_trackParents);
+    state.trackIndexes = std::move(m_trackIndexes);
+    state.rootChildren = rootItem()->children();
+    state.trackCount   = m_currentPlaylist->trackCount();
+
+    m_nodes.clear();
+    m_pendingNodes.clear();
+    m_trackParents.clear();
+    m_trackIndexes.clear();
+
+    m_cache.insert(m_currentPlaylist->id(), m_currentPreset, m_columns, std::move(state));
+
+    return true;
+}
+
+bool PlaylistModel::restoreCachedPlaylist()
+{
+    auto state = m_cache.take(m_currentPlaylist->id(), m_currentPlaylist->trackCount(), m_currentPreset, m_columns);
+    if(!state) {
+        return false;
+    }
+
+    beginResetModel();
+    resetRoot();
+
+    m_nodes        = std::move(state->nodes);
+    m_pendingNodes = std::move(state->pendingNodes);
+    m_trackParents = std::move(state->trackParents);
+    m_trackIndexes = std::move(state->trackIndexes);
+
+    auto* root = rootItem();
+    for(PlaylistItem* child : state->rootChildren) {
+        root->appendChild(child);
+    }
+
+    endResetModel();
+
+    m_resetting      = false;
+    m_playlistLoaded = true;
+
+    if(!state->pendingUpdates.empty()) {
+        updateTracks({state->pendingUpdates.cbegin(), state->pendingUpdates.cend()});
+    }
+
+    emit playlistLoaded();
+
+    return true;
+}
+
 void PlaylistModel::populateModel(PendingData& data)
 {
     if(m_currentPlaylist && m_currentPlaylist->id() != data.playlistId) {
@@ -1118,9 +1215,9 @@ void PlaylistModel::populateModel(PendingData& data)
 
     if(m_resetting) {
         for(const auto& [parentKey, rows] : data.nodes) {
-            auto* parent = parentKey == QStringLiteral("0") ? itemForIndex({}) : &m_nodes.at(parentKey);
+            auto* parent = parentKey == 0 ? itemForIndex({}) : &m_nodes.at(parentKey);
 
-            for(const QString& row : rows) {
+            for(const PlaylistItemKey row : rows) {
                 PlaylistItem* child = &m_nodes.at(row);
                 parent->appendChild(child);
                 child->setPending(false);
@@ -1332,9 +1429,9 @@ QVariant PlaylistModel::subheaderData(PlaylistItem* item, int column, int role)
     }
 }
 
-PlaylistItem* PlaylistModel::itemForKey(const QString& key)
+PlaylistItem* PlaylistModel::itemForKey(PlaylistItemKey key)
 {
-    if(key == QStringLiteral("0")) {
+    if(key == 0) {
         return rootItem();
     }
     if(m_nodes.contains(key)) {
@@ -1577,18 +1674,18 @@ void PlaylistModel::handleTrackGroup(const PendingData& data)
 {
     updateTrackIndexes();
 
-    auto cmpParentKeys = [data](const QString& key1, const QString& key2) {
+    auto cmpParentKeys = [&data](PlaylistItemKey key1, PlaylistItemKey key2) {
         if(key1 == key2) {
             return false;
         }
         return std::ranges::find(data.containerOrder, key1) < std::ranges::find(data.containerOrder, key2);
     };
-    using ParentItemMap = std::map<QString, PlaylistItemList, decltype(cmpParentKeys)>;
+    using ParentItemMap = std::map<PlaylistItemKey, PlaylistItemList, decltype(cmpParentKeys)>;
     std::map<int, ParentItemMap> itemData;
 
     for(const auto& [index, childKeys] : data.indexNodes) {
         ParentItemMap childrenMap(cmpParentKeys);
-        for(const QString& childKey : childKeys) {
+        for(const PlaylistItemKey childKey : childKeys) {
             if(PlaylistItem* child = itemForKey(childKey)) {
                 if(child->parent()) {
                     childrenMap[child->parent()->key()].push_back(child);
@@ -1712,8 +1809,8 @@ int PlaylistModel::dropCopyRowsRecursive(const QModelIndex& source, const Playli
     auto* sourceParent = itemForIndex(source);
     for(Fooyin::PlaylistItem* childItem : rows) {
         childItem->resetRow();
-        const QString newKey = Fooyin::Utils::generateRandomHash();
-        auto* newChild       = &m_nodes.emplace(newKey, *childItem).first->second;
+        const PlaylistItemKey newKey = PlaylistItem::generateKey();
+        auto* newChild               = &m_nodes.emplace(newKey, *childItem).first->second;
         newChild->clearChildren();
         newChild->setKey(newKey);
 
@@ -1796,12 +1893,12 @@ bool PlaylistModel::removePlaylistRows(int row, int count, const QModelIndex& pa
 
 void PlaylistModel::fetchChildren(PlaylistItem* parent, PlaylistItem* child)
 {
-    const QString key = child->key();
+    const PlaylistItemKey key = child->key();
 
     if(m_pendingNodes.contains(key)) {
         auto& childRows = m_pendingNodes.at(key);
 
-        for(const QString& childRow : childRows) {
+        for(const PlaylistItemKey childRow : childRows) {
             PlaylistItem& childItem = m_nodes.at(childRow);
             fetchChildren(child, &childItem);
         }
@@ -1979,7 +2076,7 @@ void PlaylistModel::coverUpdated(const Track& track)
 
     const auto parents = m_trackParents.at(track.id());
 
-    for(const QString& parentKey : parents) {
+    for(const PlaylistItemKey parentKey : parents) {
         if(m_nodes.contains(parentKey)) {
             auto* parentItem = &m_nodes.at(parentKey);
 
@@ -2025,7 +2122,7 @@ PlaylistModel::TrackItemResult PlaylistModel::itemForTrackIndex(int index)
     }
 
     if(m_trackIndexes.contains(index)) {
-        const QString key = m_trackIndexes.at(index);
+        const PlaylistItemKey key = m_trackIndexes.at(index);
         if(m_nodes.contains(key)) {
             return {&m_nodes.at(key), false};
         }
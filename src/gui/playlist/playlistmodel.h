@@ -21,6 +21,7 @@
 
 #include "playlistcolumn.h"
 #include "playlistitem.h"
+#include "playlistmodelcache.h"
 #include "playlistpopulator.h"
 
 #include <core/player/playerdefs.h>
@@ -110,6 +111,10 @@ public:
     void removeTracks(const TrackGroups& groups);
     void updateHeader(Playlist* playlist);
 
+    // Keep cached states of playlists other than the current one in sync
+    void updateCachedTracks(Playlist* playlist, const std::vector<int>& indexes);
+    void removeCachedPlaylist(Playlist* playlist);
+
     static TrackGroups saveTrackGroups(const QModelIndexList& indexes);
 
     void tracksAboutToBeChanged();
@@ -127,6 +132,9 @@ public slots:
     void playStateChanged(PlayState state);
 
 private:
+    bool cacheCurrentPlaylist();
+    bool restoreCachedPlaylist();
+
     void populateModel(PendingData& data);
     void populateTrackGroup(PendingData& data);
     void updateModel(ItemKeyMap& data);
@@ -135,7 +143,7 @@ private:
     QVariant headerData(PlaylistItem* item, int column, int role) const;
     QVariant subheaderData(PlaylistItem* item, int column, int role) const;
 
-    PlaylistItem* itemForKey(const QString& key);
+    PlaylistItem* itemForKey(PlaylistItemKey key);
 
     struct DropTargetResult
     {
@@ -221,12 +229,13 @@ private:
     QSize m_coverSize;
     QThread m_populatorThread;
     PlaylistPopulator m_populator;
+    PlaylistModelCache m_cache;
 
     bool m_playlistLoaded;
     NodeKeyMap m_pendingNodes;
     ItemKeyMap m_nodes;
     TrackIdNodeMap m_trackParents;
-    std::map<int, QString> m_trackIndexes;
+    std::map<int, PlaylistItemKey> m_trackIndexes;
 
     PlaylistPreset m_currentPreset;
     PlaylistColumnList m_columns;
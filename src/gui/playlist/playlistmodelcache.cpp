@@ -0,0 +1,141 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "playlistmodelcache.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+// Rough size of an item and each of its formatted columns, used to keep within the limit
+constexpr size_t ItemCost   = sizeof(Fooyin::PlaylistItem) + 128;
+constexpr size_t ColumnCost = 96;
+// Beyond this, repopulating the whole playlist is quicker than updating it
+constexpr size_t MaxPendingUpdates = 500;
+
+size_t estimateCost(const Fooyin::PlaylistModelState& state, const Fooyin::PlaylistColumnList& columns)
+{
+    return state.nodes.size() * (ItemCost + (std::max<size_t>(columns.size(), 2) * ColumnCost));
+}
+} // namespace
+
+namespace Fooyin {
+PlaylistModelCache::PlaylistModelCache(size_t limit)
+    : m_limit{limit}
+    , m_totalCost{0}
+{ }
+
+void PlaylistModelCache::setLimit(size_t limit)
+{
+    m_limit = limit;
+    evict();
+}
+
+void PlaylistModelCache::insert(const Id& playlistId, const PlaylistPreset& preset, const PlaylistColumnList& columns,
+                                PlaylistModelState state)
+{
+    const size_t cost = estimateCost(state, columns);
+    if(cost > m_limit) {
+        return;
+    }
+
+    std::erase_if(m_entries, [this, &playlistId, &preset, &columns](const Entry& entry) {
+        if(entry.playlistId == playlistId && entry.preset == preset && entry.columns == columns) {
+            m_totalCost -= entry.cost;
+            return true;
+        }
+        return false;
+    });
+
+    m_entries.push_front({playlistId, preset, columns, std::move(state), cost});
+    m_totalCost += cost;
+
+    evict();
+}
+
+std::optional<PlaylistModelState> PlaylistModelCache::take(const Id& playlistId, int trackCount,
+                                                           const PlaylistPreset& preset,
+                                                           const PlaylistColumnList& columns)
+{
+    auto entryIt = std::ranges::find_if(m_entries, [&playlistId, &preset, &columns](const Entry& entry) {
+        return entry.playlistId == playlistId && entry.preset == preset && entry.columns == columns;
+    });
+
+    if(entryIt == m_entries.end()) {
+        return {};
+    }
+
+    PlaylistModelState state = std::move(entryIt->state);
+    m_totalCost -= entryIt->cost;
+    m_entries.erase(entryIt);
+
+    if(state.trackCount != trackCount) {
+        // Tracks were added or removed without the entry being dropped, so its indexes can't be trusted
+        return {};
+    }
+
+    return state;
+}
+
+void PlaylistModelCache::tracksChanged(const Id& playlistId, int trackCount, const std::vector<int>& indexes)
+{
+    std::erase_if(m_entries, [this, &playlistId, trackCount, &indexes](Entry& entry) {
+        if(entry.playlistId != playlistId) {
+            return false;
+        }
+
+        PlaylistModelState& state = entry.state;
+        if(state.trackCount == trackCount) {
+            state.pendingUpdates.insert(indexes.cbegin(), indexes.cend());
+            if(state.pendingUpdates.size() <= MaxPendingUpdates
+               && std::cmp_less_equal(state.pendingUpdates.size(), trackCount / 2)) {
+                return false;
+            }
+        }
+
+        m_totalCost -= entry.cost;
+        return true;
+    });
+}
+
+void PlaylistModelCache::remove(const Id& playlistId)
+{
+    std::erase_if(m_entries, [this, &playlistId](const Entry& entry) {
+        if(entry.playlistId == playlistId) {
+            m_totalCost -= entry.cost;
+            return true;
+        }
+        return false;
+    });
+}
+
+void PlaylistModelCache::clear()
+{
+    m_entries.clear();
+    m_totalCost = 0;
+}
+
+void PlaylistModelCache::evict()
+{
+    while(m_totalCost > m_limit && !m_entries.empty()) {
+        m_totalCost -= m_entries.back().cost;
+        m_entries.pop_back();
+    }
+}
+} // namespace Fooyin
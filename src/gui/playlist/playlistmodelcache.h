@@ -0,0 +1,89 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "playlistcolumn.h"
+#include "playlistpopulator.h"
+#include "playlistpreset.h"
+
+#include <utils/id.h>
+
+#include <list>
+#include <map>
+#include <optional>
+#include <set>
+
+namespace Fooyin {
+/*!
+ * The populated item tree of a PlaylistModel, moved out of the model when switching to another playlist.
+ * Items are owned by @p nodes, so pointers between them remain valid while cached.
+ */
+struct PlaylistModelState
+{
+    ItemKeyMap nodes;
+    NodeKeyMap pendingNodes;
+    TrackIdNodeMap trackParents;
+    std::map<int, PlaylistItemKey> trackIndexes;
+    PlaylistItemList rootChildren;
+
+    int trackCount{0};
+    // Playlist indexes which have changed since the state was cached
+    std::set<int> pendingUpdates;
+};
+
+/*!
+ * Least recently used cache of populated playlists, keyed by playlist, preset and columns.
+ * Entries are evicted once their estimated size exceeds the limit.
+ */
+class PlaylistModelCache
+{
+public:
+    explicit PlaylistModelCache(size_t limit);
+
+    void setLimit(size_t limit);
+
+    void insert(const Id& playlistId, const PlaylistPreset& preset, const PlaylistColumnList& columns,
+                PlaylistModelState state);
+    //! Returns the cached state, unless the playlist no longer has @p trackCount tracks, in which case it's dropped.
+    std::optional<PlaylistModelState> take(const Id& playlistId, int trackCount, const PlaylistPreset& preset,
+                                           const PlaylistColumnList& columns);
+
+    //! Records changed @p indexes so they can be repopulated on restore, or drops entries if too much has changed.
+    void tracksChanged(const Id& playlistId, int trackCount, const std::vector<int>& indexes);
+    void remove(const Id& playlistId);
+    void clear();
+
+private:
+    struct Entry
+    {
+        Id playlistId;
+        PlaylistPreset preset;
+        PlaylistColumnList columns;
+        PlaylistModelState state;
+        size_t cost{0};
+    };
+
+    void evict();
+
+    size_t m_limit;
+    size_t m_totalCost;
+    std::list<Entry> m_entries;
+};
+} // namespace Fooyin
@@ -23,16 +23,50 @@
 #include "playlistscriptregistry.h"
 
 #include <core/player/playercontroller.h>
-#include <utils/crypto.h>
 
-#include <QCryptographicHash>
+#include <QHashFunctions>
+#include <QThread>
 #include <QTimer>
+#include <QtConcurrent>
 
 #include <ranges>
+#include <span>
 
 constexpr int TrackPreloadSize = 2000;
+// Most tracks evaluated at once, as each holds its own copy of the header and subheaders until it's added
+constexpr int EvaluateBatchSize = 4000;
+// Smallest number of tracks worth handing to another thread
+constexpr int MinChunkSize = 250;
 
 namespace Fooyin {
+namespace {
+// Scripts of a single track, evaluated independently of the tracks around it
+struct EvaluatedTrack
+{
+    HeaderRow header;
+    PlaylistItemKey headerKey{0};
+    std::vector<PlaylistContainerItem> subheaders;
+    PlaylistTrackItem track;
+};
+using EvaluatedTracks = std::vector<EvaluatedTrack>;
+
+// Each thread needs its own parser, as the registry holds the index of the track being evaluated
+struct ScriptEvaluator
+{
+    PlaylistScriptRegistry registry;
+    ScriptParser parser{&registry};
+    ScriptFormatter formatter;
+};
+
+struct EvaluationChunk
+{
+    ScriptEvaluator* evaluator;
+    int firstIndex{0};
+    std::span<const Track> tracks;
+    std::span<EvaluatedTrack> results;
+};
+} // namespace
+
 struct PlaylistPopulator::Private
 {
     PlaylistPopulator* self;
@@ -46,12 +80,12 @@ struct PlaylistPopulator::Private
 
     ScriptFormatter formatter;
 
-    QString prevBaseHeaderKey;
-    QString prevHeaderKey;
-    std::vector<QString> prevBaseSubheaderKey;
-    std::vector<QString> prevSubheaderKey;
+    std::vector<std::unique_ptr<ScriptEvaluator>> evaluators;
 
-    std::vector<PlaylistContainerItem> subheaders;
+    PlaylistItemKey prevBaseHeaderKey{0};
+    PlaylistItemKey prevHeaderKey{0};
+    std::vector<PlaylistItemKey> prevBaseSubheaderKey;
+    std::vector<PlaylistItemKey> prevSubheaderKey;
 
     PlaylistItem root;
     PendingData data;
@@ -63,7 +97,12 @@ struct PlaylistPopulator::Private
         , playerController{playerController_}
         , registry{std::make_unique<PlaylistScriptRegistry>()}
         , parser{registry.get()}
-    { }
+    {
+        const int threadCount = std::max(QThread::idealThreadCount(), 1);
+        for(int i{0}; i < threadCount; ++i) {
+            evaluators.push_back(std::make_unique<ScriptEvaluator>());
+        }
+    }
 
     void reset()
     {
@@ -71,12 +110,21 @@ struct PlaylistPopulator::Private
         headers.clear();
         prevBaseSubheaderKey.clear();
         prevSubheaderKey.clear();
-        prevBaseHeaderKey.clear();
-        prevHeaderKey.clear();
+        prevBaseHeaderKey = 0;
+        prevHeaderKey     = 0;
     }
 
-    PlaylistItem* getOrInsertItem(const QString& key, PlaylistItem::ItemType type, const Data& item,
-                                  PlaylistItem* parent, const QString& baseKey)
+    void setup(const Id& playlistId)
+    {
+        const PlaybackQueue queue = playerController->playbackQueue();
+        registry->setup(playlistId, queue);
+        for(const auto& evaluator : evaluators) {
+            evaluator->registry.setup(playlistId, queue);
+        }
+    }
+
+    PlaylistItem* getOrInsertItem(PlaylistItemKey key, PlaylistItem::ItemType type, const Data& item,
+                                  PlaylistItem* parent, PlaylistItemKey baseKey)
     {
         auto [node, inserted] = data.items.try_emplace(key, PlaylistItem{type, item, parent});
         if(inserted) {
@@ -102,32 +150,118 @@ struct PlaylistPopulator::Private
         }
     }
 
-    void iterateHeader(const Track& track, PlaylistItem*& parent)
+    void evaluateTrack(ScriptEvaluator& evaluator, const Track& track, int index, EvaluatedTrack& result) const
     {
-        HeaderRow row{currentPreset.header};
-        if(!row.isValid()) {
-            return;
-        }
+        evaluator.registry.setTrackIndex(index);
 
-        auto evaluateBlocks = [this, track](RichScript& script) -> QString {
+        auto evaluateScript = [&evaluator, &track](RichScript& script) -> QString {
             script.text.clear();
-            const auto evalScript = parser.evaluate(script.script, track);
+            const auto evalScript = evaluator.parser.evaluate(script.script, track);
             if(!evalScript.isEmpty()) {
-                script.text = formatter.evaluate(evalScript);
+                script.text = evaluator.formatter.evaluate(evalScript);
             }
             return evalScript;
         };
 
-        auto generateHeaderKey = [&row, &evaluateBlocks]() {
-            return Utils::generateHash(evaluateBlocks(row.title), evaluateBlocks(row.subtitle),
-                                       evaluateBlocks(row.sideText), evaluateBlocks(row.info));
-        };
+        if(currentPreset.header.isValid()) {
+            HeaderRow& row   = result.header;
+            row              = currentPreset.header;
+            result.headerKey = qHashMulti(0, evaluateScript(row.title), evaluateScript(row.subtitle),
+                                          evaluateScript(row.sideText), evaluateScript(row.info));
+        }
+
+        for(SubheaderRow subheader : currentPreset.subHeaders) {
+            const auto leftScript    = evaluator.parser.evaluate(subheader.leftText.script, track);
+            subheader.leftText.text  = evaluator.formatter.evaluate(leftScript);
+            const auto rightScript   = evaluator.parser.evaluate(subheader.rightText.script, track);
+            subheader.rightText.text = evaluator.formatter.evaluate(rightScript);
+
+            PlaylistContainerItem currentContainer;
+            currentContainer.setTitle(subheader.leftText);
+            currentContainer.setSubtitle(subheader.rightText);
+            currentContainer.setRowHeight(subheader.rowHeight);
+            currentContainer.calculateSize();
+            result.subheaders.push_back(currentContainer);
+        }
+
+        if(!currentPreset.track.isValid()) {
+            return;
+        }
+
+        TrackRow trackRow{currentPreset.track};
 
-        const QString baseKey = generateHeaderKey();
-        QString key           = Utils::generateRandomHash();
-        if(!prevHeaderKey.isEmpty() && prevBaseHeaderKey == baseKey) {
+        if(!columns.empty()) {
+            for(const auto& column : columns) {
+                const auto evalScript = evaluator.parser.evaluate(column.field, track);
+                trackRow.columns.emplace_back(column.field, evaluator.formatter.evaluate(evalScript));
+            }
+            result.track = {trackRow.columns, track};
+        }
+        else {
+            evaluateScript(trackRow.leftText);
+            evaluateScript(trackRow.rightText);
+
+            result.track = {trackRow.leftText, trackRow.rightText, track};
+        }
+    }
+
+    void evaluateChunk(const EvaluationChunk& chunk) const
+    {
+        int index{chunk.firstIndex};
+        for(size_t i{0}; i < chunk.tracks.size(); ++i) {
+            if(!self->mayRun()) {
+                return;
+            }
+            evaluateTrack(*chunk.evaluator, chunk.tracks[i], index++, chunk.results[i]);
+        }
+    }
+
+    EvaluatedTracks evaluateTracks(std::span<const Track> tracks, int firstIndex) const
+    {
+        EvaluatedTracks results(tracks.size());
+
+        const auto trackCount = static_cast<int>(tracks.size());
+        const int chunkCount  = std::clamp(trackCount / MinChunkSize, 1, static_cast<int>(evaluators.size()));
+        const int chunkSize   = (trackCount + chunkCount - 1) / chunkCount;
+
+        std::vector<EvaluationChunk> chunks;
+        for(int i{0}; i < chunkCount; ++i) {
+            const int offset = i * chunkSize;
+            const int count  = std::min(chunkSize, trackCount - offset);
+            if(count <= 0) {
+                break;
+            }
+            chunks.push_back({.evaluator  = evaluators.at(i).get(),
+                              .firstIndex = firstIndex + offset,
+                              .tracks     = tracks.subspan(offset, count),
+                              .results    = std::span{results}.subspan(offset, count)});
+        }
+
+        if(chunks.size() == 1) {
+            evaluateChunk(chunks.front());
+        }
+        else {
+            QtConcurrent::blockingMap(chunks, [this](const EvaluationChunk& chunk) { evaluateChunk(chunk); });
+        }
+
+        return results;
+    }
+
+    void iterateHeader(const Track& track, EvaluatedTrack& evaluated, PlaylistItem*& parent)
+    {
+        if(!currentPreset.header.isValid()) {
+            return;
+        }
+
+        const HeaderRow& row          = evaluated.header;
+        const PlaylistItemKey baseKey = evaluated.headerKey;
+        PlaylistItemKey key           = 0;
+        if(prevHeaderKey != 0 && prevBaseHeaderKey == baseKey) {
             key = prevHeaderKey;
         }
+        else {
+            key = PlaylistItem::generateKey();
+        }
         prevBaseHeaderKey = baseKey;
         prevHeaderKey     = key;
 
@@ -152,21 +286,9 @@ struct PlaylistPopulator::Private
         parent           = headerItem;
     }
 
-    void iterateSubheaders(const Track& track, PlaylistItem*& parent)
+    void iterateSubheaders(const Track& track, EvaluatedTrack& evaluated, PlaylistItem*& parent)
     {
-        for(auto& subheader : currentPreset.subHeaders) {
-            const auto leftScript    = parser.evaluate(subheader.leftText.script, track);
-            subheader.leftText.text  = formatter.evaluate(leftScript);
-            const auto rightScript   = parser.evaluate(subheader.rightText.script, track);
-            subheader.rightText.text = formatter.evaluate(rightScript);
-
-            PlaylistContainerItem currentContainer;
-            currentContainer.setTitle(subheader.leftText);
-            currentContainer.setSubtitle(subheader.rightText);
-            currentContainer.setRowHeight(subheader.rowHeight);
-            currentContainer.calculateSize();
-            subheaders.push_back(currentContainer);
-        }
+        const auto& subheaders = evaluated.subheaders;
 
         const int subheaderCount = static_cast<int>(subheaders.size());
         prevSubheaderKey.resize(subheaderCount);
@@ -187,16 +309,20 @@ struct PlaylistPopulator::Private
             const QString subheaderKey = generateSubheaderKey(subheader);
 
             if(subheaderKey.isEmpty()) {
-                prevBaseSubheaderKey[i].clear();
-                prevSubheaderKey[i].clear();
+                prevBaseSubheaderKey[i] = 0;
+                prevSubheaderKey[i]     = 0;
                 continue;
             }
 
-            const QString baseKey = Utils::generateHash(parent->baseKey(), subheaderKey);
-            QString key           = Utils::generateRandomHash();
-            if(static_cast<int>(prevSubheaderKey.size()) > i && prevBaseSubheaderKey.at(i) == baseKey) {
+            const PlaylistItemKey baseKey = qHashMulti(0, parent->baseKey(), subheaderKey);
+            PlaylistItemKey key           = 0;
+            if(static_cast<int>(prevSubheaderKey.size()) > i && prevSubheaderKey.at(i) != 0
+               && prevBaseSubheaderKey.at(i) == baseKey) {
                 key = prevSubheaderKey.at(i);
             }
+            else {
+                key = PlaylistItem::generateKey();
+            }
             prevBaseSubheaderKey[i] = baseKey;
             prevSubheaderKey[i]     = key;
 
@@ -216,51 +342,24 @@ struct PlaylistPopulator::Private
             parent = subheaderItem;
             ++i;
         }
-        subheaders.clear();
     }
 
-    PlaylistItem* iterateTrack(const Track& track, int index)
+    // Builds the tree from evaluated scripts; grouping depends on the previous track, so this must run in order
+    PlaylistItem* iterateTrack(const Track& track, EvaluatedTrack& evaluated, int index)
     {
         PlaylistItem* parent = &root;
 
-        iterateHeader(track, parent);
-        iterateSubheaders(track, parent);
+        iterateHeader(track, evaluated, parent);
+        iterateSubheaders(track, evaluated, parent);
 
         if(!currentPreset.track.isValid()) {
             return nullptr;
         }
 
-        auto evaluateTrack = [this, &track](RichScript& script) {
-            script.text.clear();
-            const auto evalScript = parser.evaluate(script.script, track);
-            if(!evalScript.isEmpty()) {
-                script.text = formatter.evaluate(evalScript);
-            }
-        };
-
-        registry->setTrackIndex(index);
-
-        TrackRow trackRow{currentPreset.track};
-        PlaylistTrackItem playlistTrack;
+        const PlaylistItemKey baseKey = qHashMulti(0, parent->key(), track.hash(), index);
+        const PlaylistItemKey key     = PlaylistItem::generateKey();
 
-        if(!columns.empty()) {
-            for(const auto& column : columns) {
-                const auto evalScript = parser.evaluate(column.field, track);
-                trackRow.columns.emplace_back(column.field, formatter.evaluate(evalScript));
-            }
-            playlistTrack = {trackRow.columns, track};
-        }
-        else {
-            evaluateTrack(trackRow.leftText);
-            evaluateTrack(trackRow.rightText);
-
-            playlistTrack = {trackRow.leftText, trackRow.rightText, track};
-        }
-
-        const QString baseKey = Utils::generateHash(parent->key(), track.hash(), QString::number(index));
-        const QString key     = Utils::generateRandomHash();
-
-        auto* trackItem = getOrInsertItem(key, PlaylistItem::Track, playlistTrack, parent, baseKey);
+        auto* trackItem = getOrInsertItem(key, PlaylistItem::Track, evaluated.track, parent, baseKey);
         data.trackParents[track.id()].push_back(key);
 
         if(parent->type() != PlaylistItem::Header) {
@@ -269,52 +368,61 @@ struct PlaylistPopulator::Private
         return trackItem;
     }
 
-    void runBatch(int size, int index)
+    void runBatches()
     {
-        if(size <= 0) {
-            return;
-        }
+        const std::span<const Track> tracks{pendingTracks};
+        const auto trackCount = static_cast<int>(tracks.size());
 
-        auto tracksBatch = std::ranges::views::take(pendingTracks, size);
+        // The first batch is emitted on its own so the visible part of the playlist appears quickly
+        int emitIndex = std::min(TrackPreloadSize, trackCount);
+        int index{0};
 
-        for(const Track& track : tracksBatch) {
-            if(!self->mayRun()) {
-                return;
+        while(index < trackCount) {
+            const auto batch = tracks.subspan(index, std::min(EvaluateBatchSize, emitIndex - index));
+
+            EvaluatedTracks evaluated = evaluateTracks(batch, index);
+
+            for(size_t i{0}; i < batch.size(); ++i) {
+                if(!self->mayRun()) {
+                    return;
+                }
+                iterateTrack(batch[i], evaluated[i], index++);
             }
-            iterateTrack(track, index++);
-        }
 
-        updateContainers();
+            if(index < emitIndex) {
+                continue;
+            }
 
-        if(!self->mayRun()) {
-            return;
-        }
+            updateContainers();
 
-        emit self->populated(data);
+            if(!self->mayRun()) {
+                return;
+            }
 
-        auto tracksToKeep = std::ranges::views::drop(pendingTracks, size);
-        TrackList tempTracks;
-        std::ranges::copy(tracksToKeep, std::back_inserter(tempTracks));
-        pendingTracks = std::move(tempTracks);
+            emit self->populated(data);
 
-        data.nodes.clear();
+            data.nodes.clear();
 
-        const auto remaining = static_cast<int>(pendingTracks.size());
-        runBatch(remaining, index);
+            emitIndex = trackCount;
+        }
+
+        pendingTracks.clear();
     }
 
     void runTracksGroup(const std::map<int, TrackList>& tracks)
     {
         for(const auto& [index, trackGroup] : tracks) {
-            std::vector<QString> trackKeys;
+            std::vector<PlaylistItemKey> trackKeys;
+
+            EvaluatedTracks evaluated = evaluateTracks(trackGroup, index);
 
             int trackIndex{index};
 
-            for(const Track& track : trackGroup) {
+            for(size_t i{0}; i < trackGroup.size(); ++i) {
                 if(!self->mayRun()) {
                     return;
                 }
-                if(const auto* trackItem = iterateTrack(track, trackIndex++)) {
+                if(const auto* trackItem = iterateTrack(trackGroup[i], evaluated[i], trackIndex++)) {
                     trackKeys.push_back(trackItem->key());
                 }
             }
@@ -349,9 +457,9 @@ void PlaylistPopulator::run(const Id& playlistId, const PlaylistPreset& preset,
     p->currentPreset   = preset;
     p->columns         = columns;
     p->pendingTracks   = tracks;
-    p->registry->setup(playlistId, p->playerController->playbackQueue());
+    p->setup(playlistId);
 
-    p->runBatch(TrackPreloadSize, 0);
+    p->runBatches();
 
     emit finished();
 
@@ -368,7 +476,7 @@ void PlaylistPopulator::runTracks(const Id& playlistId, const PlaylistPreset& pr
     p->data.playlistId = playlistId;
     p->currentPreset   = preset;
     p->columns         = columns;
-    p->registry->setup(playlistId, p->playerController->playbackQueue());
+    p->setup(playlistId);
 
     p->runTracksGroup(tracks);
 
@@ -119,4 +119,14 @@ ScriptResult PlaylistScriptRegistry::value(const QString& var, const Track& trac
 
     return ScriptRegistry::value(var, track);
 }
+
+VariableAccessor PlaylistScriptRegistry::resolveVariable(const QString& var) const
+{
+    if(isListVariable(var) || p->vars.contains(var)) {
+        // Depends on the current playlist state, so must be evaluated by name
+        return {.name = var};
+    }
+
+    return ScriptRegistry::resolveVariable(var);
+}
 } // namespace Fooyin
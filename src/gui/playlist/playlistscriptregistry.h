@@ -40,6 +40,7 @@ public:
 
     bool isVariable(const QString& var, const Track& track) const override;
     ScriptResult value(const QString& var, const Track& track) const override;
+    [[nodiscard]] VariableAccessor resolveVariable(const QString& var) const override;
 
 private:
     struct Private;
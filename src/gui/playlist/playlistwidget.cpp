@@ -184,7 +184,17 @@ void PlaylistWidgetPrivate::setupConnections()
                          expandTree(playlistView, model, parent, first, last);
                      });
 
-    QObject::connect(playlistController->playlistHandler(), &PlaylistHandler::activePlaylistChanged, this, [this]() {
+    auto* playlistHandler = playlistController->playlistHandler();
+    QObject::connect(playlistHandler, &PlaylistHandler::playlistTracksChanged, model,
+                     &PlaylistModel::updateCachedTracks);
+    QObject::connect(playlistHandler, &PlaylistHandler::playlistTracksAdded, model,
+                     [this](Playlist* playlist) { model->removeCachedPlaylist(playlist); });
+    QObject::connect(playlistHandler, &PlaylistHandler::playlistTracksRemoved, model,
+                     [this](Playlist* playlist) { model->removeCachedPlaylist(playlist); });
+    QObject::connect(playlistHandler, &PlaylistHandler::playlistRemoved, model,
+                     &PlaylistModel::removeCachedPlaylist);
+
+    QObject::connect(playlistHandler, &PlaylistHandler::activePlaylistChanged, this, [this]() {
         if(!playlistController->currentIsActive()) {
             model->playingTrackChanged({});
         }
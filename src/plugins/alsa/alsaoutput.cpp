@@ -19,6 +19,8 @@
 
 #include "alsaoutput.h"
 
+#include <utils/settings/settingsmanager.h>
+
 #include <alsa/asoundlib.h>
 
 #include <QDebug>
@@ -131,6 +133,8 @@ using PcmHandleUPtr = std::unique_ptr<snd_pcm_t, PcmHandleDeleter>;
 namespace Fooyin::Alsa {
 struct AlsaOutput::Private
 {
+    SettingsManager* settings;
+
     AudioFormat format;
 
     bool initialised{false};
@@ -143,6 +147,12 @@ struct AlsaOutput::Private
     bool deviceLost;
     bool started{false};
 
+    bool mmap{false};
+    bool mappable{false};
+    bool mapped{false};
+    snd_pcm_uframes_t mappedOffset{0};
+    snd_pcm_uframes_t mappedFrames{0};
+
     void reset()
     {
         if(pcmHandle) {
@@ -150,6 +160,9 @@ struct AlsaOutput::Private
             pcmHandle.reset();
         }
         started = false;
+        mmap     = false;
+        mappable = false;
+        mapped   = false;
     }
 
     bool initAlsa()
@@ -175,9 +188,16 @@ struct AlsaOutput::Private
 
         pausable = snd_pcm_hw_params_can_pause(hwParams);
 
-        err = snd_pcm_hw_params_set_access(handle, hwParams, SND_PCM_ACCESS_RW_INTERLEAVED);
-        if(checkError(err, QStringLiteral("Failed to set access mode"))) {
-            return false;
+        // Only write straight into the device buffer if asked to, falling back to copying through snd_pcm_writei
+        const bool useMmap = settings && settings->value(QString::fromLatin1(MmapAccessSetting)).toBool();
+
+        mmap     = useMmap && snd_pcm_hw_params_set_access(handle, hwParams, SND_PCM_ACCESS_MMAP_INTERLEAVED) >= 0;
+        mappable = mmap;
+        if(!mmap) {
+            err = snd_pcm_hw_params_set_access(handle, hwParams, SND_PCM_ACCESS_RW_INTERLEAVED);
+            if(checkError(err, QStringLiteral("Failed to set access mode"))) {
+                return false;
+            }
         }
 
         const snd_pcm_format_t alsaFormat = findAlsaFormat(format.sampleFormat());
@@ -266,6 +286,12 @@ struct AlsaOutput::Private
             return false;
         }
 
+        // Wake waitForSpace once a full period can be written
+        err = snd_pcm_sw_params_set_avail_min(handle, swParams, periodSize);
+        if(checkError(err, QStringLiteral("Unable to set minimum available count"))) {
+            return false;
+        }
+
         err = snd_pcm_sw_params(handle, swParams);
         if(checkError(err, QStringLiteral("Failed to apply software parameters"))) {
             return false;
@@ -374,8 +400,8 @@ struct AlsaOutput::Private
     }
 };
 
-AlsaOutput::AlsaOutput()
-    : p{std::make_unique<Private>()}
+AlsaOutput::AlsaOutput(SettingsManager* settings)
+    : p{std::make_unique<Private>(settings)}
 { }
 
 AlsaOutput::~AlsaOutput()
@@ -484,7 +510,12 @@ int AlsaOutput::write(const AudioBuffer& buffer)
     const int frameCount = buffer.frameCount();
 
     snd_pcm_sframes_t err{0};
-    err = snd_pcm_writei(p->pcmHandle.get(), buffer.constData().data(), frameCount);
+    if(p->mmap) {
+        err = snd_pcm_mmap_writei(p->pcmHandle.get(), buffer.constData().data(), frameCount);
+    }
+    else {
+        err = snd_pcm_writei(p->pcmHandle.get(), buffer.constData().data(), frameCount);
+    }
     if(checkError(err, QStringLiteral("Write error"))) {
         return 0;
     }
@@ -495,6 +526,76 @@ int AlsaOutput::write(const AudioBuffer& buffer)
     return static_cast<int>(err);
 }
 
+std::span<std::byte> AlsaOutput::mapBuffer(int frames)
+{
+    if(!p->mappable || !p->pcmHandle || frames <= 0 || !p->recoverState()) {
+        return {};
+    }
+
+    snd_pcm_t* handle = p->pcmHandle.get();
+
+    const snd_pcm_sframes_t avail = snd_pcm_avail_update(handle);
+    if(checkError(static_cast<int>(avail), QStringLiteral("Unable to get available frames")) || avail == 0) {
+        return {};
+    }
+
+    const snd_pcm_channel_area_t* areas{nullptr};
+    snd_pcm_uframes_t offset{0};
+    snd_pcm_uframes_t count = std::min(static_cast<snd_pcm_uframes_t>(avail), static_cast<snd_pcm_uframes_t>(frames));
+
+    const int err = snd_pcm_mmap_begin(handle, &areas, &offset, &count);
+    if(checkError(err, QStringLiteral("Unable to map device buffer"))) {
+        return {};
+    }
+
+    const auto frameBytes = static_cast<unsigned int>(p->format.bytesPerFrame());
+    if(areas[0].step != frameBytes * 8 || areas[0].first % 8 != 0) {
+        // Not laid out as our interleaved frames; use snd_pcm_mmap_writei from now on
+        snd_pcm_mmap_commit(handle, offset, 0);
+        p->mappable = false;
+        printError(QStringLiteral("Unexpected device buffer layout, falling back to buffered writes"));
+        return {};
+    }
+
+    p->mapped       = true;
+    p->mappedOffset = offset;
+    p->mappedFrames = count;
+
+    auto* start = static_cast<std::byte*>(areas[0].addr) + (areas[0].first / 8) + (offset * frameBytes);
+    return {start, count * frameBytes};
+}
+
+int AlsaOutput::commitBuffer(int frames)
+{
+    if(!p->mapped) {
+        return 0;
+    }
+
+    p->mapped = false;
+
+    const auto count = std::min(static_cast<snd_pcm_uframes_t>(std::max(frames, 0)), p->mappedFrames);
+
+    const snd_pcm_sframes_t committed = snd_pcm_mmap_commit(p->pcmHandle.get(), p->mappedOffset, count);
+    if(checkError(static_cast<int>(committed), QStringLiteral("Unable to commit device buffer"))) {
+        return 0;
+    }
+    return static_cast<int>(committed);
+}
+
+bool AlsaOutput::waitForSpace(std::chrono::milliseconds timeout)
+{
+    if(!p->pcmHandle || !p->started) {
+        return false;
+    }
+
+    const int err = snd_pcm_wait(p->pcmHandle.get(), static_cast<int>(timeout.count()));
+    if(err < 0) {
+        // Let the next write recover, and fall back to sleeping so a persistent error doesn't spin
+        return false;
+    }
+    return true;
+}
+
 void AlsaOutput::setPaused(bool pause)
 {
     if(!p->pausable) {
@@ -23,11 +23,17 @@
 
 #include <memory>
 
-namespace Fooyin::Alsa {
+namespace Fooyin {
+class SettingsManager;
+
+namespace Alsa {
+// Writes straight into the device buffer when enabled; off by default as some drivers and plugins mishandle it
+constexpr auto MmapAccessSetting = "ALSA/MmapAccess";
+
 class AlsaOutput : public AudioOutput
 {
 public:
-    AlsaOutput();
+    explicit AlsaOutput(SettingsManager* settings);
     ~AlsaOutput() override;
 
     bool init(const AudioFormat& format) override;
@@ -44,10 +50,15 @@ public:
 
     int write(const AudioBuffer& buffer) override;
     void setPaused(bool pause) override;
+
+    std::span<std::byte> mapBuffer(int frames) override;
+    int commitBuffer(int frames) override;
+    bool waitForSpace(std::chrono::milliseconds timeout) override;
     void setDevice(const QString& device) override;
 
 private:
     struct Private;
     std::unique_ptr<Private> p;
 };
-} // namespace Fooyin::Alsa
+} // namespace Alsa
+} // namespace Fooyin
@@ -21,11 +21,19 @@
 
 #include "alsaoutput.h"
 
+#include <utils/settings/settingsmanager.h>
+
 namespace Fooyin::Alsa {
+void AlsaPlugin::initialise(const CorePluginContext& context)
+{
+    m_settings = context.settingsManager;
+    m_settings->createSetting(QString::fromLatin1(MmapAccessSetting), false);
+}
+
 AudioOutputBuilder AlsaPlugin::registerOutput()
 {
-    return {.name = QStringLiteral("ALSA"), .creator = []() {
-                return std::make_unique<AlsaOutput>();
+    return {.name = QStringLiteral("ALSA"), .creator = [this]() {
+                return std::make_unique<AlsaOutput>(m_settings);
             }};
 }
 } // namespace Fooyin::Alsa
@@ -20,18 +20,24 @@
 #pragma once
 
 #include <core/engine/outputplugin.h>
+#include <core/plugins/coreplugin.h>
 #include <core/plugins/plugin.h>
 
 namespace Fooyin::Alsa {
 class AlsaPlugin : public QObject,
                    public Plugin,
+                   public CorePlugin,
                    public OutputPlugin
 {
     Q_OBJECT
     Q_PLUGIN_METADATA(IID "com.fooyin.plugin/1.0" FILE "alsa.json")
-    Q_INTERFACES(Fooyin::Plugin Fooyin::OutputPlugin)
+    Q_INTERFACES(Fooyin::Plugin Fooyin::CorePlugin Fooyin::OutputPlugin)
 
 public:
+    void initialise(const CorePluginContext& context) override;
     AudioOutputBuilder registerOutput() override;
+
+private:
+    SettingsManager* m_settings{nullptr};
 };
 } // namespace Fooyin::Alsa
@@ -327,7 +327,8 @@ struct FilterController::Private
 
         FilterGroup& group = groups.at(groupId);
 
-        const bool reset         = !group.filteredTracks.empty() || filter->searchFilter().length() > search.length();
+        const bool narrows       = Filter::narrowsSearch(filter->searchFilter(), search);
+        const bool reset         = !group.filteredTracks.empty() || !narrows;
         TrackList tracksToFilter = reset ? library->tracks() : filter->tracks();
         TrackList filteredTracks = co_await Utils::asyncExec(
             [&search, &tracksToFilter]() { return Filter::filterTracks(tracksToFilter, search); });
@@ -0,0 +1,181 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "nulloutput.h"
+
+#include <algorithm>
+
+namespace {
+const auto RealtimeDevice    = QStringLiteral("realtime");
+const auto UnthrottledDevice = QStringLiteral("unthrottled");
+} // namespace
+
+namespace Fooyin::Null {
+NullOutput::NullOutput()
+    : m_bufferSize{8192}
+    , m_initialised{false}
+    , m_realtime{true}
+    , m_device{RealtimeDevice}
+    , m_started{false}
+    , m_paused{false}
+    , m_queued{0}
+    , m_framesWritten{0}
+{ }
+
+bool NullOutput::init(const AudioFormat& format)
+{
+    if(!format.isValid()) {
+        return false;
+    }
+
+    m_format        = format;
+    m_realtime      = m_device != UnthrottledDevice;
+    m_started       = false;
+    m_paused        = false;
+    m_queued        = 0;
+    m_framesWritten = 0;
+    m_initialised   = true;
+
+    return true;
+}
+
+void NullOutput::uninit()
+{
+    m_initialised = false;
+    m_started     = false;
+    m_queued      = 0;
+}
+
+void NullOutput::reset()
+{
+    m_started = false;
+    m_queued  = 0;
+}
+
+void NullOutput::start()
+{
+    m_started   = true;
+    m_lastDrain = Clock::now();
+}
+
+bool NullOutput::initialised() const
+{
+    return m_initialised;
+}
+
+QString NullOutput::device() const
+{
+    return m_device;
+}
+
+bool NullOutput::canHandleVolume() const
+{
+    // Leave volume to the renderer so its soft-volume path is exercised
+    return false;
+}
+
+int NullOutput::bufferSize() const
+{
+    return m_bufferSize;
+}
+
+OutputState NullOutput::currentState()
+{
+    drain();
+
+    OutputState state;
+
+    state.queuedSamples = m_queued;
+    state.freeSamples   = m_bufferSize - m_queued;
+    state.delay         = static_cast<double>(m_queued) / static_cast<double>(m_format.sampleRate());
+
+    return state;
+}
+
+OutputDevices NullOutput::getAllDevices() const
+{
+    return {{RealtimeDevice, QStringLiteral("Real-time")}, {UnthrottledDevice, QStringLiteral("Unthrottled")}};
+}
+
+int NullOutput::write(const AudioBuffer& buffer)
+{
+    drain();
+
+    const int frames = std::min(buffer.frameCount(), m_bufferSize - m_queued);
+    m_framesWritten += static_cast<uint64_t>(frames);
+
+    if(m_realtime) {
+        if(m_queued == 0) {
+            // Nothing was playing, so don't count the idle time against this data
+            m_lastDrain = Clock::now();
+        }
+        m_queued += frames;
+    }
+
+    return frames;
+}
+
+void NullOutput::setPaused(bool pause)
+{
+    drain();
+
+    m_paused = pause;
+    if(!pause) {
+        m_lastDrain = Clock::now();
+    }
+}
+
+void NullOutput::setDevice(const QString& device)
+{
+    if(!device.isEmpty()) {
+        m_device = device;
+    }
+}
+
+uint64_t NullOutput::framesWritten() const
+{
+    return m_framesWritten;
+}
+
+void NullOutput::drain()
+{
+    if(!m_started || m_paused || m_queued == 0) {
+        return;
+    }
+
+    const auto now     = Clock::now();
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_lastDrain).count();
+    const auto played  = elapsed * m_format.sampleRate() / 1'000'000'000;
+
+    if(played <= 0) {
+        return;
+    }
+
+    if(played >= m_queued) {
+        // Ran dry, so playback restarts from the next write
+        m_queued    = 0;
+        m_lastDrain = now;
+        return;
+    }
+
+    m_queued -= static_cast<int>(played);
+    // Only advance by whole frames so rounding doesn't accumulate
+    m_lastDrain += std::chrono::nanoseconds{played * 1'000'000'000 / m_format.sampleRate()};
+}
+} // namespace Fooyin::Null
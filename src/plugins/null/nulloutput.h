@@ -0,0 +1,74 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <core/engine/audiooutput.h>
+
+#include <QString>
+
+#include <chrono>
+
+namespace Fooyin::Null {
+/*!
+ * An output which discards everything written to it. On the "realtime" device audio is consumed
+ * at the stream's sample rate as a sound card would, on the "unthrottled" device as fast as it's written.
+ */
+class NullOutput : public AudioOutput
+{
+public:
+    NullOutput();
+
+    bool init(const AudioFormat& format) override;
+    void uninit() override;
+    void reset() override;
+    void start() override;
+
+    [[nodiscard]] bool initialised() const override;
+    [[nodiscard]] QString device() const override;
+    [[nodiscard]] bool canHandleVolume() const override;
+    [[nodiscard]] int bufferSize() const override;
+    OutputState currentState() override;
+    [[nodiscard]] OutputDevices getAllDevices() const override;
+
+    int write(const AudioBuffer& buffer) override;
+    void setPaused(bool pause) override;
+    void setDevice(const QString& device) override;
+
+    //! Total number of frames accepted since @fn init
+    [[nodiscard]] uint64_t framesWritten() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void drain();
+
+    AudioFormat m_format;
+    int m_bufferSize;
+    bool m_initialised;
+    bool m_realtime;
+    QString m_device;
+
+    bool m_started;
+    bool m_paused;
+    int m_queued;
+    uint64_t m_framesWritten;
+    Clock::time_point m_lastDrain;
+};
+} // namespace Fooyin::Null
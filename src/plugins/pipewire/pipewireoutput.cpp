@@ -30,8 +30,12 @@
 #include <spa/pod/builder.h>
 #include <spa/utils/result.h>
 
+#include <utils/ringbuffer.h>
+
 #include <QDebug>
 
+#include <atomic>
+
 #ifdef __GNUC__
 #pragma GCC diagnostic ignored "-Wmissing-field-initializers"
 #pragma GCC diagnostic ignored "-Wold-style-cast"
@@ -103,8 +107,13 @@ struct PipeWireOutput::Private
 
     AudioFormat format;
 
-    AudioBuffer buffer;
-    uint32_t bufferPos{0};
+    // Written by write, read by the realtime process callback
+    RingBuffer<std::byte> buffer;
+    // Total bytes written and read, each only touched by its own side
+    size_t bytesWritten{0};
+    size_t bytesRead{0};
+    // Everything written before this point is discarded by the next process call
+    std::atomic<size_t> discardUntil{0};
 
     std::unique_ptr<PipewireThreadLoop> loop;
     std::unique_ptr<PipewireContext> context;
@@ -139,8 +148,19 @@ struct PipeWireOutput::Private
             registry.reset(nullptr);
         }
 
-        buffer.clear();
-        bufferPos = 0;
+        buffer.resize(0);
+        bytesWritten = 0;
+        bytesRead    = 0;
+        discardUntil.store(0, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] size_t queuedBytes() const
+    {
+        const size_t queued    = buffer.readAvailable();
+        const size_t readPos   = bytesWritten - queued;
+        const size_t discard   = discardUntil.load(std::memory_order_relaxed);
+        const size_t toDiscard = discard > readPos ? discard - readPos : 0;
+        return queued - std::min(queued, toDiscard);
     }
 
     bool initCore()
@@ -231,7 +251,12 @@ struct PipeWireOutput::Private
     {
         auto* self = static_cast<PipeWireOutput::Private*>(userData);
 
-        if(!self->bufferPos) {
+        const size_t discard = self->discardUntil.load(std::memory_order_acquire);
+        if(discard > self->bytesRead) {
+            self->bytesRead += self->buffer.skip(discard - self->bytesRead);
+        }
+
+        if(self->buffer.readAvailable() == 0) {
             self->loop->signal(false);
             return;
         }
@@ -244,16 +269,16 @@ struct PipeWireOutput::Private
 
         const spa_data& data = pwBuffer->buffer->datas[0];
 
-        const auto size = std::min(data.maxsize, self->bufferPos);
-        auto* dst       = data.data;
+        const auto frameBytes  = static_cast<size_t>(self->format.bytesPerFrame());
+        const size_t available = std::min<size_t>(data.maxsize, self->buffer.readAvailable());
+        const size_t size      = (available / frameBytes) * frameBytes;
 
-        std::memcpy(dst, self->buffer.data(), self->bufferPos);
-        self->bufferPos -= size;
-        self->buffer.erase(size);
+        const size_t read = self->buffer.read({static_cast<std::byte*>(data.data), size});
+        self->bytesRead += read;
 
         data.chunk->offset = 0;
-        data.chunk->stride = self->format.bytesPerFrame();
-        data.chunk->size   = self->stream->bufferSize();
+        data.chunk->stride = static_cast<int32_t>(frameBytes);
+        data.chunk->size   = static_cast<uint32_t>(read);
 
         self->stream->queueBuffer(pwBuffer);
         self->loop->signal(false);
@@ -288,7 +313,6 @@ PipeWireOutput::~PipeWireOutput() = default;
 bool PipeWireOutput::init(const AudioFormat& format)
 {
     p->format = format;
-    p->buffer = {format, 0};
 
     pw_init(nullptr, nullptr);
 
@@ -296,6 +320,9 @@ bool PipeWireOutput::init(const AudioFormat& format)
         return false;
     }
 
+    // Sized before the stream is started, so process never sees it reallocate
+    p->buffer.resize(p->stream->bufferSize());
+
     if(p->pendingVolumeChange) {
         p->pendingVolumeChange = false;
         setVolume(p->volume);
@@ -313,10 +340,9 @@ void PipeWireOutput::uninit()
 
 void PipeWireOutput::reset()
 {
-    {
-        const ThreadLoopGuard guard{p->loop.get()};
-    }
+    p->discardUntil.store(p->bytesWritten, std::memory_order_release);
 
+    const ThreadLoopGuard guard{p->loop.get()};
     p->stream->flush(false);
 }
 
@@ -369,8 +395,16 @@ OutputState PipeWireOutput::currentState()
 {
     OutputState state;
 
-    state.queuedSamples = p->buffer.frameCount();
-    state.freeSamples   = (p->stream->bufferSize() / p->format.bytesPerFrame()) - state.queuedSamples;
+    const int frameBytes = p->format.bytesPerFrame();
+    if(!p->stream || frameBytes <= 0) {
+        return state;
+    }
+
+    state.queuedSamples = static_cast<int>(p->queuedBytes() / frameBytes);
+    // Space still held by discarded data isn't free until the next process call
+    const auto writable = static_cast<int>(p->buffer.writeAvailable() / frameBytes);
+    state.freeSamples   = std::clamp((p->stream->bufferSize() / frameBytes) - state.queuedSamples, 0, writable);
+    state.delay         = static_cast<double>(state.queuedSamples) / static_cast<double>(p->format.sampleRate());
 
     return state;
 }
@@ -382,12 +416,19 @@ int PipeWireOutput::bufferSize() const
 
 int PipeWireOutput::write(const AudioBuffer& buffer)
 {
-    const ThreadLoopGuard guard{p->loop.get()};
+    const int frameBytes = p->format.bytesPerFrame();
+    if(frameBytes <= 0) {
+        return 0;
+    }
+
+    // Only whole frames, so process never sees a partial one
+    const std::span<const std::byte> data = buffer.constData();
+    const size_t size = (std::min(data.size(), p->buffer.writeAvailable()) / frameBytes) * frameBytes;
 
-    p->buffer.append(buffer.constData());
-    p->bufferPos += buffer.byteCount();
+    const size_t written = p->buffer.write(data.first(size));
+    p->bytesWritten += written;
 
-    return buffer.sampleCount();
+    return static_cast<int>(written / frameBytes);
 }
 
 void PipeWireOutput::setPaused(bool pause)
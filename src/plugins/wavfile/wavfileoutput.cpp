@@ -0,0 +1,203 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "wavfileoutput.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QtEndian>
+
+#include <array>
+#include <limits>
+
+namespace {
+constexpr auto HeaderSize      = 44;
+constexpr uint16_t FormatPcm   = 1;
+constexpr uint16_t FormatFloat = 3;
+
+const auto DefaultDevice = QStringLiteral("default");
+
+template <typename T>
+char* put(char* out, T value)
+{
+    qToLittleEndian(value, out);
+    return out + sizeof(T);
+}
+
+char* put(char* out, const char (&tag)[5])
+{
+    std::copy_n(tag, 4, out);
+    return out + 4;
+}
+} // namespace
+
+namespace Fooyin::WavFile {
+WavFileOutput::WavFileOutput()
+    : m_bufferSize{8192}
+    , m_initialised{false}
+    , m_device{DefaultDevice}
+    , m_dataSize{0}
+{ }
+
+WavFileOutput::~WavFileOutput()
+{
+    if(m_initialised) {
+        uninit();
+    }
+}
+
+bool WavFileOutput::init(const AudioFormat& format)
+{
+    if(!format.isValid()) {
+        return false;
+    }
+
+    m_format   = format;
+    m_dataSize = 0;
+
+    m_file.setFileName(filepath());
+    if(!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "[WavFile] Unable to open" << m_file.fileName() << ":" << m_file.errorString();
+        return false;
+    }
+
+    if(!writeHeader()) {
+        qWarning() << "[WavFile] Unable to write header to" << m_file.fileName();
+        m_file.close();
+        return false;
+    }
+
+    m_initialised = true;
+    return true;
+}
+
+void WavFileOutput::uninit()
+{
+    if(m_file.isOpen()) {
+        // Fill in the sizes now that they're known
+        writeHeader();
+        m_file.close();
+    }
+
+    m_initialised = false;
+}
+
+void WavFileOutput::reset() { }
+
+void WavFileOutput::start() { }
+
+bool WavFileOutput::initialised() const
+{
+    return m_initialised;
+}
+
+QString WavFileOutput::device() const
+{
+    return m_device;
+}
+
+bool WavFileOutput::canHandleVolume() const
+{
+    return false;
+}
+
+int WavFileOutput::bufferSize() const
+{
+    return m_bufferSize;
+}
+
+OutputState WavFileOutput::currentState()
+{
+    // Everything is written out synchronously, so nothing is ever left queued
+    OutputState state;
+    state.freeSamples = m_bufferSize;
+    return state;
+}
+
+OutputDevices WavFileOutput::getAllDevices() const
+{
+    return {{DefaultDevice, QDir::temp().filePath(QStringLiteral("fooyin-output.wav"))}};
+}
+
+int WavFileOutput::write(const AudioBuffer& buffer)
+{
+    const auto written = m_file.write(reinterpret_cast<const char*>(buffer.constData().data()), buffer.byteCount());
+    if(written < 0) {
+        qWarning() << "[WavFile] Write error:" << m_file.errorString();
+        return 0;
+    }
+
+    m_dataSize += static_cast<uint64_t>(written);
+
+    return static_cast<int>(written / m_format.bytesPerFrame());
+}
+
+void WavFileOutput::setPaused(bool /*pause*/) { }
+
+void WavFileOutput::setDevice(const QString& device)
+{
+    if(!device.isEmpty()) {
+        m_device = device;
+    }
+}
+
+QString WavFileOutput::filepath() const
+{
+    if(m_device == DefaultDevice) {
+        return getAllDevices().front().desc;
+    }
+    return m_device;
+}
+
+bool WavFileOutput::writeHeader()
+{
+    const bool isFloat       = m_format.sampleFormat() == SampleFormat::Float;
+    const auto channels      = static_cast<uint16_t>(m_format.channelCount());
+    const auto sampleRate    = static_cast<uint32_t>(m_format.sampleRate());
+    const auto blockAlign    = static_cast<uint16_t>(m_format.bytesPerFrame());
+    const auto bitsPerSample = static_cast<uint16_t>(m_format.bytesPerSample() * 8);
+
+    // Sizes are capped rather than wrapped if the stream outgrows the format
+    constexpr uint64_t MaxDataSize = std::numeric_limits<uint32_t>::max() - HeaderSize;
+    const auto dataSize            = static_cast<uint32_t>(std::min(m_dataSize, MaxDataSize));
+
+    std::array<char, HeaderSize> header;
+    char* out = header.data();
+
+    out = put(out, "RIFF");
+    out = put(out, static_cast<uint32_t>(HeaderSize - 8 + dataSize));
+    out = put(out, "WAVE");
+    out = put(out, "fmt ");
+    out = put(out, uint32_t{16});
+    out = put(out, isFloat ? FormatFloat : FormatPcm);
+    out = put(out, channels);
+    out = put(out, sampleRate);
+    out = put(out, static_cast<uint32_t>(sampleRate * blockAlign));
+    out = put(out, blockAlign);
+    out = put(out, bitsPerSample);
+    out = put(out, "data");
+    put(out, dataSize);
+
+    const qint64 pos = m_file.pos();
+    if(!m_file.seek(0) || m_file.write(header.data(), HeaderSize) != HeaderSize) {
+        return false;
+    }
+    return pos <= HeaderSize || m_file.seek(pos);
+}
+} // namespace Fooyin::WavFile
@@ -0,0 +1,66 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <core/engine/audiooutput.h>
+
+#include <QFile>
+#include <QString>
+
+namespace Fooyin::WavFile {
+/*!
+ * An output which writes the rendered audio, byte for byte, to a WAV file.
+ * The device is the path of the file, which is overwritten each time the output is initialised.
+ */
+class WavFileOutput : public AudioOutput
+{
+public:
+    WavFileOutput();
+    ~WavFileOutput() override;
+
+    bool init(const AudioFormat& format) override;
+    void uninit() override;
+    void reset() override;
+    void start() override;
+
+    [[nodiscard]] bool initialised() const override;
+    [[nodiscard]] QString device() const override;
+    [[nodiscard]] bool canHandleVolume() const override;
+    [[nodiscard]] int bufferSize() const override;
+    OutputState currentState() override;
+    [[nodiscard]] OutputDevices getAllDevices() const override;
+
+    int write(const AudioBuffer& buffer) override;
+    void setPaused(bool pause) override;
+    void setDevice(const QString& device) override;
+
+private:
+    [[nodiscard]] QString filepath() const;
+    bool writeHeader();
+
+    AudioFormat m_format;
+    int m_bufferSize;
+    bool m_initialised;
+    QString m_device;
+
+    QFile m_file;
+    uint64_t m_dataSize;
+};
+} // namespace Fooyin::WavFile
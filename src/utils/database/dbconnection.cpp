@@ -52,6 +52,7 @@ DbConnection::DbConnection(const DbConnection& original, const QString& connecti
 
 DbConnection::~DbConnection()
 {
+    m_queryCache.clear();
     close();
     QSqlDatabase::removeDatabase(m_name);
 }
@@ -75,6 +76,8 @@ bool DbConnection::open()
 
 void DbConnection::close()
 {
+    m_queryCache.clear();
+
     auto db = this->db();
     if(db.isOpen()) {
         if(db.rollback()) {
@@ -93,4 +96,19 @@ QSqlDatabase DbConnection::db() const
 {
     return QSqlDatabase::database(m_name);
 }
+
+DbQuery* DbConnection::cachedQuery(const QString& statement)
+{
+    if(const auto it = m_queryCache.find(statement); it != m_queryCache.end()) {
+        it->second.finish();
+        return &it->second;
+    }
+
+    DbQuery query{db(), statement};
+    if(query.status() != DbQuery::Status::Prepared) {
+        return nullptr;
+    }
+
+    return &m_queryCache.emplace(statement, std::move(query)).first->second;
+}
 } // namespace Fooyin
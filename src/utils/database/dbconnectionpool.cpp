@@ -19,16 +19,25 @@
 
 #include <utils/database/dbconnectionpool.h>
 
+#include <QSqlError>
 #include <QSqlQuery>
 
 namespace {
-bool updatePragmas(Fooyin::DbConnection* connection)
+bool updatePragmas(Fooyin::DbConnection* connection, const std::map<QString, QString>& pragmas)
 {
     QSqlQuery foreignKeys{connection->db()};
     if(!foreignKeys.exec(QStringLiteral("PRAGMA foreign_keys = ON;"))) {
         return false;
     }
 
+    for(const auto& [pragma, value] : pragmas) {
+        QSqlQuery query{connection->db()};
+        if(!query.exec(QStringLiteral("PRAGMA %1 = %2;").arg(pragma, value))) {
+            qWarning() << "[DB] Failed to set pragma" << pragma << "to" << value << ":" << query.lastError();
+            return false;
+        }
+    }
+
     return true;
 }
 } // namespace
@@ -44,6 +53,7 @@ DbConnectionPool::DbConnectionPool(PrivateKey /*key*/, const DbConnection::DbPar
                                    const QString& connectionName)
     : m_connectionCount{0}
     , m_prototype{params, connectionName}
+    , m_pragmas{params.pragmas}
 { }
 
 DbConnectionPoolPtr DbConnectionPool::create(const DbConnection::DbParams& params, const QString& connectionName)
@@ -72,7 +82,7 @@ bool DbConnectionPool::createThreadConnection()
         return false;
     }
 
-    if(!updatePragmas(connection.get())) {
+    if(!updatePragmas(connection.get(), m_pragmas)) {
         qCritical() << "[DB] Failed to set pragmas:" << connectionName;
         return false;
     }
@@ -51,4 +51,26 @@ QSqlDatabase DbConnectionProvider::db() const
 
     return connection->db();
 }
+
+DbQuery* DbConnectionProvider::cachedQuery(const QString& statement) const
+{
+    if(!m_connectionPool) {
+        qCritical() << "[DB] No connection pool";
+        return nullptr;
+    }
+
+    DbConnection* connection = m_connectionPool->threadConnection();
+
+    if(!connection) {
+        qCritical() << "[DB] Thread connection not found";
+        return nullptr;
+    }
+
+    if(!connection->isOpen() && !connection->db().open()) {
+        qCritical() << "[DB] Thread connection could not be opened";
+        return nullptr;
+    }
+
+    return connection->cachedQuery(statement);
+}
 } // namespace Fooyin
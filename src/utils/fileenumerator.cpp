@@ -0,0 +1,279 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <utils/fileenumerator.h>
+
+#include <QDir>
+#include <QFile>
+
+#include <algorithm>
+#include <cctype>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#ifdef Q_OS_UNIX
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+namespace {
+bool isSuffixFilter(const QString& filter)
+{
+    return filter.startsWith(u"*.") && std::ranges::none_of(QStringView{filter}.sliced(1), [](QChar c) {
+               return c == u'*' || c == u'?' || c == u'[' || c.unicode() > 127;
+           });
+}
+
+/*!
+ * Matches filenames against name filters. Filters of the form "*.ext" are compared
+ * against the raw filename, so entries which don't match never need decoding.
+ */
+class NameMatcher
+{
+public:
+    explicit NameMatcher(const QStringList& filters)
+        : m_filters{filters}
+    {
+        if(!std::ranges::all_of(filters, isSuffixFilter)) {
+            return;
+        }
+
+        for(const QString& filter : filters) {
+            m_suffixes.push_back(filter.sliced(1).toLower().toStdString());
+        }
+    }
+
+    [[nodiscard]] bool matches(std::string_view name) const
+    {
+        if(m_filters.empty()) {
+            return true;
+        }
+
+        if(!m_suffixes.empty()) {
+            return std::ranges::any_of(m_suffixes, [name](const std::string& suffix) {
+                return name.size() >= suffix.size()
+                    && std::equal(suffix.crbegin(), suffix.crend(), name.crbegin(), [](char lhs, char rhs) {
+                           return lhs == static_cast<char>(std::tolower(static_cast<unsigned char>(rhs)));
+                       });
+            });
+        }
+
+        return QDir::match(m_filters, QFile::decodeName(QByteArray{name.data(), static_cast<qsizetype>(name.size())}));
+    }
+
+private:
+    QStringList m_filters;
+    std::vector<std::string> m_suffixes;
+};
+
+struct DirContents
+{
+    QStringList files;
+    QStringList subdirs;
+};
+} // namespace
+
+namespace Fooyin {
+struct FileEnumerator::Private
+{
+    NameMatcher matcher;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<QString> pendingDirs;
+    std::deque<QString> files;
+    int activeWorkers{0};
+    bool cancelled{false};
+#ifdef Q_OS_UNIX
+    std::set<std::pair<dev_t, ino_t>> visitedDirs;
+#endif
+
+    std::vector<std::thread> threads;
+
+    Private(const QStringList& dirs, const QStringList& nameFilters, int threadCount)
+        : matcher{nameFilters}
+    {
+        for(const QString& dir : dirs) {
+            pendingDirs.push_back(QDir::cleanPath(dir));
+        }
+
+        for(int i{0}; i < std::max(1, threadCount); ++i) {
+            threads.emplace_back([this]() { run(); });
+        }
+    }
+
+    [[nodiscard]] bool finished() const
+    {
+        return cancelled || (pendingDirs.empty() && activeWorkers == 0);
+    }
+
+    void run()
+    {
+        std::unique_lock lock{mutex};
+
+        while(true) {
+            cv.wait(lock, [this]() { return !pendingDirs.empty() || finished(); });
+            if(finished()) {
+                break;
+            }
+
+            const QString dir = std::move(pendingDirs.front());
+            pendingDirs.pop_front();
+            ++activeWorkers;
+
+            lock.unlock();
+            DirContents contents = readDir(dir);
+            lock.lock();
+
+            --activeWorkers;
+            std::ranges::move(contents.files, std::back_inserter(files));
+            std::ranges::move(contents.subdirs, std::back_inserter(pendingDirs));
+
+            cv.notify_all();
+        }
+
+        cv.notify_all();
+    }
+
+#ifdef Q_OS_UNIX
+    bool markVisited(const struct stat& info)
+    {
+        const std::scoped_lock lock{mutex};
+        return visitedDirs.emplace(info.st_dev, info.st_ino).second;
+    }
+
+    DirContents readDir(const QString& dir)
+    {
+        DirContents contents;
+
+        const QByteArray encodedDir = QFile::encodeName(dir);
+
+        DIR* handle = ::opendir(encodedDir.constData());
+        if(!handle) {
+            return contents;
+        }
+
+        struct stat dirInfo{};
+        if(::fstat(::dirfd(handle), &dirInfo) == 0 && !markVisited(dirInfo)) {
+            // Reached again through a symlink
+            ::closedir(handle);
+            return contents;
+        }
+
+        const QString prefix = dir.endsWith(u'/') ? dir : dir + u'/';
+
+        while(const dirent* entry = ::readdir(handle)) {
+            const std::string_view name{entry->d_name};
+            if(name.starts_with('.')) {
+                // Hidden, or . and ..
+                continue;
+            }
+
+            unsigned char type = entry->d_type;
+            if(type == DT_LNK || type == DT_UNKNOWN) {
+                struct stat info{};
+                const QByteArray path = encodedDir + '/' + entry->d_name;
+                if(::stat(path.constData(), &info) != 0) {
+                    continue;
+                }
+                type = S_ISDIR(info.st_mode) ? DT_DIR : (S_ISREG(info.st_mode) ? DT_REG : DT_UNKNOWN);
+            }
+
+            if(type == DT_DIR) {
+                contents.subdirs.push_back(prefix + QFile::decodeName(entry->d_name));
+            }
+            else if(type == DT_REG && matcher.matches(name)) {
+                contents.files.push_back(prefix + QFile::decodeName(entry->d_name));
+            }
+        }
+
+        ::closedir(handle);
+
+        // readdir order is arbitrary, so match QDir's default sorting
+        contents.files.sort(Qt::CaseInsensitive);
+        contents.subdirs.sort(Qt::CaseInsensitive);
+
+        return contents;
+    }
+#else
+    DirContents readDir(const QString& dir)
+    {
+        DirContents contents;
+
+        const QDir qdir{dir};
+
+        const QFileInfoList subdirs = qdir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot);
+        for(const QFileInfo& subdir : subdirs) {
+            contents.subdirs.push_back(subdir.absoluteFilePath());
+        }
+
+        const QFileInfoList files = qdir.entryInfoList(QDir::Files);
+        for(const QFileInfo& file : files) {
+            if(matcher.matches(file.fileName().toStdString())) {
+                contents.files.push_back(file.absoluteFilePath());
+            }
+        }
+
+        return contents;
+    }
+#endif
+};
+
+FileEnumerator::FileEnumerator(const QStringList& dirs, const QStringList& nameFilters, int threadCount)
+    : p{std::make_unique<Private>(dirs, nameFilters, threadCount)}
+{ }
+
+FileEnumerator::~FileEnumerator()
+{
+    cancel();
+
+    for(std::thread& thread : p->threads) {
+        thread.join();
+    }
+}
+
+QStringList FileEnumerator::takeFiles(qsizetype maxCount)
+{
+    std::unique_lock lock{p->mutex};
+    p->cv.wait(lock, [this]() { return !p->files.empty() || p->finished(); });
+
+    const auto count = std::min(static_cast<size_t>(std::max<qsizetype>(maxCount, 1)), p->files.size());
+
+    QStringList files;
+    files.reserve(static_cast<qsizetype>(count));
+    std::move(p->files.begin(), p->files.begin() + static_cast<std::ptrdiff_t>(count), std::back_inserter(files));
+    p->files.erase(p->files.begin(), p->files.begin() + static_cast<std::ptrdiff_t>(count));
+
+    return files;
+}
+
+void FileEnumerator::cancel()
+{
+    {
+        const std::scoped_lock lock{p->mutex};
+        p->cancelled = true;
+    }
+    p->cv.notify_all();
+}
+} // namespace Fooyin
@@ -19,10 +19,14 @@
 
 #include <utils/fileutils.h>
 
+#include <utils/fileenumerator.h>
+
 #include <QDesktopServices>
 #include <QDir>
 #include <QFile>
 
+#include <limits>
+
 namespace Fooyin::Utils::File {
 QString cleanPath(const QString& path)
 {
@@ -98,18 +102,11 @@ void openDirectory(const QString& dir)
 QStringList getFilesInDir(const QDir& baseDirectory, const QStringList& fileExtensions)
 {
     QStringList ret;
-    QList<QDir> stack{baseDirectory};
+    FileEnumerator enumerator{{baseDirectory.absolutePath()}, fileExtensions};
 
-    while(!stack.isEmpty()) {
-        const QDir dir              = stack.takeFirst();
-        const QFileInfoList subDirs = dir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot);
-        for(const auto& subDir : subDirs) {
-            stack.append(QDir{subDir.absoluteFilePath()});
-        }
-        const QFileInfoList files = dir.entryInfoList(fileExtensions, QDir::Files);
-        for(const auto& file : files) {
-            ret.append(file.absoluteFilePath());
-        }
+    QStringList files;
+    while(!(files = enumerator.takeFiles(std::numeric_limits<qsizetype>::max())).isEmpty()) {
+        ret.append(files);
     }
     return ret;
 }
@@ -117,18 +114,10 @@ QStringList getFilesInDir(const QDir& baseDirectory, const QStringList& fileExte
 QList<QUrl> getUrlsInDir(const QDir& baseDirectory, const QStringList& fileExtensions)
 {
     QList<QUrl> ret;
-    QList<QDir> stack{baseDirectory};
 
-    while(!stack.isEmpty()) {
-        const QDir dir              = stack.takeFirst();
-        const QFileInfoList subDirs = dir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot);
-        for(const auto& subDir : subDirs) {
-            stack.append(QDir{subDir.absoluteFilePath()});
-        }
-        const QFileInfoList files = dir.entryInfoList(fileExtensions, QDir::Files);
-        for(const auto& file : files) {
-            ret.append(QUrl::fromLocalFile(file.absoluteFilePath()));
-        }
+    const QStringList files = getFilesInDir(baseDirectory, fileExtensions);
+    for(const auto& file : files) {
+        ret.append(QUrl::fromLocalFile(file));
     }
     return ret;
 }
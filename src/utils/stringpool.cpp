@@ -0,0 +1,114 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <utils/stringpool.h>
+
+#include <QSet>
+
+#include <array>
+#include <mutex>
+
+namespace {
+// Spreads lookups from the tag reader and database threads over several locks
+constexpr size_t ShardCount = 16;
+
+template <typename T>
+struct Shard
+{
+    mutable std::mutex mutex;
+    QSet<T> values;
+
+    T intern(const T& value)
+    {
+        const std::scoped_lock lock{mutex};
+
+        const auto it = values.constFind(value);
+        if(it != values.cend()) {
+            return *it;
+        }
+        values.insert(value);
+        return value;
+    }
+};
+} // namespace
+
+namespace Fooyin {
+struct StringPool::Private
+{
+    std::array<Shard<QString>, ShardCount> strings;
+    std::array<Shard<QStringList>, ShardCount> lists;
+};
+
+StringPool::StringPool()
+    : p{std::make_unique<Private>()}
+{ }
+
+StringPool::~StringPool() = default;
+
+StringPool& StringPool::instance()
+{
+    static StringPool pool;
+    return pool;
+}
+
+QString StringPool::intern(const QString& str)
+{
+    if(str.isEmpty()) {
+        // Keeps an empty string distinct from a null one
+        return str;
+    }
+
+    return p->strings.at(qHash(str) % ShardCount).intern(str);
+}
+
+QStringList StringPool::intern(const QStringList& list)
+{
+    if(list.isEmpty()) {
+        return list;
+    }
+
+    QStringList interned;
+    interned.reserve(list.size());
+    for(const QString& str : list) {
+        interned.append(intern(str));
+    }
+
+    return p->lists.at(qHash(interned) % ShardCount).intern(interned);
+}
+
+StringPool::Stats StringPool::stats() const
+{
+    Stats stats;
+
+    for(const auto& shard : p->strings) {
+        const std::scoped_lock lock{shard.mutex};
+        stats.strings += static_cast<size_t>(shard.values.size());
+        for(const QString& str : shard.values) {
+            stats.bytes += static_cast<size_t>(str.capacity()) * sizeof(QChar);
+        }
+    }
+
+    for(const auto& shard : p->lists) {
+        const std::scoped_lock lock{shard.mutex};
+        stats.lists += static_cast<size_t>(shard.values.size());
+    }
+
+    return stats;
+}
+} // namespace Fooyin
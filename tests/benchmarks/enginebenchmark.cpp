@@ -0,0 +1,258 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "core/engine/audioplaybackengine.h"
+#include "core/engine/ffmpeg/ffmpegdecoder.h"
+#include "core/internalcoresettings.h"
+#include "null/nulloutput.h"
+#include "wavfile/wavfileoutput.h"
+
+#include <core/coresettings.h>
+#include <core/track.h>
+#include <utils/settings/settingsmanager.h>
+
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QTimer>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+
+using namespace std::chrono_literals;
+
+namespace {
+constexpr auto PlaysPerFile       = 5;
+constexpr auto GaplessPlays       = 3;
+constexpr auto GaplessToleranceMs = 1;
+constexpr auto WavHeaderSize      = 44;
+
+QStringList testFiles()
+{
+    return {QStringLiteral(":/audio/audiotest.aiff"), QStringLiteral(":/audio/audiotest.flac"),
+            QStringLiteral(":/audio/audiotest.m4a"),  QStringLiteral(":/audio/audiotest.mp3"),
+            QStringLiteral(":/audio/audiotest.ogg"),  QStringLiteral(":/audio/audiotest.opus"),
+            QStringLiteral(":/audio/audiotest.wav")};
+}
+
+double cpuSeconds()
+{
+    return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+}
+
+struct DecodedTrack
+{
+    Fooyin::AudioFormat format;
+    uint64_t frames{0};
+
+    [[nodiscard]] double seconds() const
+    {
+        return format.sampleRate() > 0 ? static_cast<double>(frames) / format.sampleRate() : 0.0;
+    }
+};
+
+//! Decodes @p filepath without the engine, as a reference for what should reach the output
+DecodedTrack decode(const QString& filepath)
+{
+    Fooyin::FFmpegDecoder decoder;
+    if(!decoder.init(filepath)) {
+        return {};
+    }
+    decoder.start();
+
+    DecodedTrack decoded{.format = decoder.format()};
+    while(true) {
+        const Fooyin::AudioBuffer buffer = decoder.readBuffer();
+        if(!buffer.isValid()) {
+            break;
+        }
+        decoded.frames += static_cast<uint64_t>(buffer.frameCount());
+    }
+    return decoded;
+}
+} // namespace
+
+namespace Fooyin::Testing {
+class EngineBenchmark : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(m_dir.isValid());
+
+        const QStringList files = testFiles();
+        for(const QString& file : files) {
+            const QFileInfo info{file};
+            const QString copy = m_dir.filePath(info.fileName());
+            ASSERT_TRUE(QFile::copy(file, copy));
+            m_tracks.emplace_back(copy);
+        }
+    }
+
+    //! Plays @p tracks back to back as the player would, returning once the last has finished
+    bool playAll(AudioPlaybackEngine& engine, const TrackList& tracks)
+    {
+        QEventLoop loop;
+        bool finished{false};
+        size_t next{1};
+
+        QObject::connect(&engine, &AudioEngine::trackAboutToFinish, &loop, [&]() {
+            if(next < tracks.size()) {
+                engine.changeTrack(tracks.at(next++));
+            }
+        });
+        QObject::connect(&engine, &AudioEngine::trackStatusChanged, &loop, [&](TrackStatus status) {
+            if(status == EndOfTrack && next >= tracks.size()) {
+                finished = true;
+                loop.quit();
+            }
+            else if(status == InvalidTrack) {
+                loop.quit();
+            }
+        });
+        QTimer::singleShot(5min, &loop, &QEventLoop::quit);
+
+        engine.changeTrack(tracks.front());
+        engine.play();
+        loop.exec();
+        engine.stop();
+
+        return finished;
+    }
+
+    QTemporaryDir m_dir;
+    TrackList m_tracks;
+};
+
+TEST_F(EngineBenchmark, UnthrottledThroughput)
+{
+    SettingsManager settings{m_dir.filePath(QStringLiteral("fooyin.conf"))};
+    const CoreSettings coreSettings{&settings};
+
+    AudioPlaybackEngine engine{&settings};
+    engine.setAudioOutput([]() {
+        auto output = std::make_unique<Null::NullOutput>();
+        output->setDevice(QStringLiteral("unthrottled"));
+        return output;
+    });
+
+    TrackList tracks;
+    double audioSeconds{0};
+    for(int i{0}; i < PlaysPerFile; ++i) {
+        for(const Track& track : m_tracks) {
+            tracks.push_back(track);
+            audioSeconds += decode(track.filepath()).seconds();
+        }
+    }
+    ASSERT_GT(audioSeconds, 0.0);
+
+    QElapsedTimer timer;
+    timer.start();
+    const double cpuStart = cpuSeconds();
+
+    ASSERT_TRUE(playAll(engine, tracks));
+
+    const double cpuUsed = cpuSeconds() - cpuStart;
+    const auto elapsedMs = std::max<qint64>(timer.elapsed(), 1);
+
+    const double realtimeFactor = audioSeconds * 1000.0 / static_cast<double>(elapsedMs);
+    const double cpuMsPerSecond = cpuUsed * 1000.0 / audioSeconds;
+
+    std::cout << "Rendered " << audioSeconds << "s of audio from " << tracks.size() << " tracks in " << elapsedMs
+              << "ms (" << realtimeFactor << "x real-time, " << cpuMsPerSecond << "ms CPU per second of audio)\n";
+    RecordProperty("RealtimeFactor", static_cast<int>(realtimeFactor));
+    RecordProperty("CpuUsPerSecond", static_cast<int>(cpuMsPerSecond * 1000.0));
+}
+
+TEST_F(EngineBenchmark, RealtimeCpuLoad)
+{
+    SettingsManager settings{m_dir.filePath(QStringLiteral("fooyin.conf"))};
+    const CoreSettings coreSettings{&settings};
+
+    AudioPlaybackEngine engine{&settings};
+    engine.setAudioOutput([]() { return std::make_unique<Null::NullOutput>(); });
+
+    const Track& track        = m_tracks.back();
+    const double audioSeconds = decode(track.filepath()).seconds();
+    ASSERT_GT(audioSeconds, 0.0);
+
+    QElapsedTimer timer;
+    timer.start();
+    const double cpuStart = cpuSeconds();
+
+    ASSERT_TRUE(playAll(engine, {track}));
+
+    const double cpuUsed    = cpuSeconds() - cpuStart;
+    const auto elapsedMs    = timer.elapsed();
+    const double cpuPercent = cpuUsed * 100.0 / audioSeconds;
+
+    // Paced by the output, so playback shouldn't finish noticeably early
+    EXPECT_GE(elapsedMs, static_cast<qint64>(audioSeconds * 900.0));
+
+    std::cout << "Played " << audioSeconds << "s of audio in " << elapsedMs << "ms using " << cpuUsed * 1000.0
+              << "ms CPU (" << cpuPercent << "%)\n";
+    RecordProperty("CpuPermille", static_cast<int>(cpuPercent * 10.0));
+}
+
+TEST_F(EngineBenchmark, GaplessAccuracy)
+{
+    SettingsManager settings{m_dir.filePath(QStringLiteral("fooyin.conf"))};
+    const CoreSettings coreSettings{&settings};
+    ASSERT_TRUE(settings.value<Settings::Core::GaplessPlayback>());
+
+    const QString outputPath = m_dir.filePath(QStringLiteral("output.wav"));
+
+    AudioPlaybackEngine engine{&settings};
+    engine.setAudioOutput([&outputPath]() {
+        auto output = std::make_unique<WavFile::WavFileOutput>();
+        output->setDevice(outputPath);
+        return output;
+    });
+
+    const Track& track         = m_tracks.back();
+    const DecodedTrack decoded = decode(track.filepath());
+    ASSERT_GT(decoded.frames, 0U);
+
+    ASSERT_TRUE(playAll(engine, TrackList(GaplessPlays, track)));
+    // Finalises the file
+    engine.setAudioOutput([]() { return std::make_unique<Null::NullOutput>(); });
+
+    const QFileInfo output{outputPath};
+    ASSERT_TRUE(output.exists());
+
+    const auto written    = (output.size() - WavHeaderSize) / decoded.format.bytesPerFrame();
+    const auto expected   = static_cast<int64_t>(decoded.frames * GaplessPlays);
+    const auto difference = written - expected;
+    const auto tolerance  = static_cast<int64_t>(decoded.format.sampleRate()) * GaplessToleranceMs / 1000;
+
+    EXPECT_GT(written, 0);
+    EXPECT_LE(std::abs(difference), tolerance) << "Frames were added or dropped between gapless tracks";
+
+    std::cout << "Wrote " << written << " of " << expected << " frames across " << GaplessPlays
+              << " gapless plays (" << difference << " frames, "
+              << static_cast<double>(difference) * 1000.0 / decoded.format.sampleRate() << "ms)\n";
+    RecordProperty("FrameDifference", static_cast<int>(difference));
+}
+} // namespace Fooyin::Testing
@@ -0,0 +1,233 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "core/database/database.h"
+#include "core/library/libraryindex.h"
+#include "core/library/libraryscanner.h"
+
+#include <core/track.h>
+#include <utils/settings/settingsmanager.h>
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QTimer>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iostream>
+
+namespace {
+using namespace std::chrono_literals;
+
+constexpr auto CopiesPerFile = 100;
+// Tracks from elsewhere in the library which a directory change shouldn't have to look at
+constexpr auto OtherTrackCount = 100000;
+
+QStringList testFiles()
+{
+    return {QStringLiteral(":/audio/audiotest.aiff"), QStringLiteral(":/audio/audiotest.flac"),
+            QStringLiteral(":/audio/audiotest.m4a"),  QStringLiteral(":/audio/audiotest.mp3"),
+            QStringLiteral(":/audio/audiotest.ogg"),  QStringLiteral(":/audio/audiotest.opus"),
+            QStringLiteral(":/audio/audiotest.wav")};
+}
+} // namespace
+
+namespace Fooyin::Testing {
+class LibraryScannerBenchmark : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(m_libraryDir.isValid());
+        ASSERT_TRUE(m_dataDir.isValid());
+
+        const QStringList files = testFiles();
+        for(const QString& file : files) {
+            const QFileInfo info{file};
+            for(int i{0}; i < CopiesPerFile; ++i) {
+                const QString copyName = QStringLiteral("%1_%2.%3").arg(info.baseName()).arg(i).arg(info.suffix());
+                ASSERT_TRUE(QFile::copy(file, m_libraryDir.filePath(copyName)));
+            }
+        }
+
+        m_fileCount = static_cast<int>(files.size()) * CopiesPerFile;
+    }
+
+    QTemporaryDir m_libraryDir;
+    QTemporaryDir m_dataDir;
+    int m_fileCount{0};
+};
+
+TEST_F(LibraryScannerBenchmark, InitialScan)
+{
+    Database database{m_dataDir.filePath(QStringLiteral("fooyin.db"))};
+    ASSERT_EQ(database.status(), Database::Status::Ok);
+
+    SettingsManager settings{m_dataDir.filePath(QStringLiteral("fooyin.conf"))};
+    LibraryScanner scanner{database.connectionPool(), &settings};
+    scanner.initialiseThread();
+
+    int addedTracks{0};
+    QObject::connect(&scanner, &LibraryScanner::scanUpdate, [&addedTracks](const ScanResult& result) {
+        addedTracks += static_cast<int>(result.addedTracks.size());
+    });
+
+    const LibraryInfo library{QStringLiteral("Benchmark"), m_libraryDir.path(), 0};
+
+    QElapsedTimer timer;
+    timer.start();
+    scanner.scanLibrary(library, {});
+    const auto elapsedMs = std::max<qint64>(timer.elapsed(), 1);
+
+    EXPECT_EQ(addedTracks, m_fileCount);
+
+    const double filesPerSecond = (m_fileCount * 1000.0) / static_cast<double>(elapsedMs);
+    std::cout << "Scanned " << m_fileCount << " files in " << elapsedMs << "ms (" << filesPerSecond
+              << " files/s)\n";
+    RecordProperty("FilesPerSecond", static_cast<int>(filesPerSecond));
+}
+
+TEST_F(LibraryScannerBenchmark, RescanUnchanged)
+{
+    Database database{m_dataDir.filePath(QStringLiteral("fooyin.db"))};
+    ASSERT_EQ(database.status(), Database::Status::Ok);
+
+    SettingsManager settings{m_dataDir.filePath(QStringLiteral("fooyin.conf"))};
+    LibraryScanner scanner{database.connectionPool(), &settings};
+    scanner.initialiseThread();
+
+    const LibraryInfo library{QStringLiteral("Benchmark"), m_libraryDir.path(), 0};
+
+    TrackList libraryTracks;
+    {
+        const auto addTracks = [&libraryTracks](const ScanResult& result) {
+            libraryTracks.insert(libraryTracks.end(), result.addedTracks.cbegin(), result.addedTracks.cend());
+        };
+        const auto connection = QObject::connect(&scanner, &LibraryScanner::scanUpdate, addTracks);
+        scanner.scanLibrary(library, {});
+        QObject::disconnect(connection);
+    }
+    ASSERT_EQ(static_cast<int>(libraryTracks.size()), m_fileCount);
+
+    ScanStats stats;
+    QObject::connect(&scanner, &LibraryScanner::scanCompleted,
+                     [&stats](const ScanStats& completed) { stats = completed; });
+
+    QElapsedTimer timer;
+    timer.start();
+    scanner.scanLibrary(library, libraryTracks);
+    const auto elapsedMs = std::max<qint64>(timer.elapsed(), 1);
+
+    EXPECT_EQ(stats.skipped, m_fileCount);
+    EXPECT_EQ(stats.reread, 0);
+    EXPECT_EQ(stats.added, 0);
+    EXPECT_EQ(stats.removed, 0);
+
+    const double filesPerSecond = (m_fileCount * 1000.0) / static_cast<double>(elapsedMs);
+    std::cout << "Rescanned " << m_fileCount << " unchanged files in " << elapsedMs << "ms (" << filesPerSecond
+              << " files/s)\n";
+    RecordProperty("FilesPerSecond", static_cast<int>(filesPerSecond));
+}
+
+TEST_F(LibraryScannerBenchmark, DirectoryChangeLatency)
+{
+    Database database{m_dataDir.filePath(QStringLiteral("fooyin.db"))};
+    ASSERT_EQ(database.status(), Database::Status::Ok);
+
+    SettingsManager settings{m_dataDir.filePath(QStringLiteral("fooyin.conf"))};
+    LibraryScanner scanner{database.connectionPool(), &settings};
+    scanner.initialiseThread();
+
+    const QString albumDir = m_libraryDir.filePath(QStringLiteral("New Album"));
+    ASSERT_TRUE(QDir{}.mkpath(albumDir));
+
+    const LibraryInfo library{QStringLiteral("Benchmark"), m_libraryDir.path(), 0};
+
+    // Stands in for the library's own index
+    LibraryIndex index;
+    for(int i{0}; i < OtherTrackCount; ++i) {
+        index.insert(Track{QStringLiteral("/other/%1/%2.flac").arg(i / 500).arg(i)});
+    }
+
+    // Watches are added in the background, so anything dropped before they're all in place could be missed
+    QEventLoop watchLoop;
+    bool watched{false};
+    QObject::connect(&scanner, &LibraryScanner::libraryWatched, [&]() {
+        watched = true;
+        watchLoop.quit();
+    });
+
+    {
+        const auto addTracks  = [&index](const ScanResult& result) { index.insert(result.addedTracks); };
+        const auto connection = QObject::connect(&scanner, &LibraryScanner::scanUpdate, addTracks);
+        scanner.scanLibrary(library, {});
+        QObject::disconnect(connection);
+    }
+
+    scanner.setupWatchers({{library.id, library}}, true);
+    if(!watched) {
+        QTimer::singleShot(10s, &watchLoop, &QEventLoop::quit);
+        watchLoop.exec();
+    }
+    ASSERT_TRUE(watched) << "The library was never fully watched";
+
+    QEventLoop loop;
+    QElapsedTimer timer;
+    qint64 latencyMs{-1};
+    size_t tracksConsidered{0};
+
+    QObject::connect(&scanner, &LibraryScanner::libraryChanged,
+                     [&](const LibraryInfo& changedLibrary, const QStringList& dirs, const FileEvents& files) {
+                         TrackList tracks;
+                         for(const QString& dir : dirs) {
+                             const TrackList dirTracks = index.tracksInDirectory(dir);
+                             tracks.insert(tracks.end(), dirTracks.cbegin(), dirTracks.cend());
+                         }
+                         for(const FileEvent& event : files) {
+                             const TrackList fileTracks = index.tracksForPaths({event.path, event.oldPath});
+                             tracks.insert(tracks.end(), fileTracks.cbegin(), fileTracks.cend());
+                         }
+                         tracksConsidered += tracks.size();
+                         scanner.scanLibraryChanges(changedLibrary, dirs, files, tracks);
+                     });
+    // scanUpdate is what the library turns into tracksAdded
+    QObject::connect(&scanner, &LibraryScanner::scanUpdate, [&](const ScanResult& result) {
+        if(!result.addedTracks.empty()) {
+            latencyMs = timer.elapsed();
+            loop.quit();
+        }
+    });
+
+    QTimer::singleShot(10s, &loop, &QEventLoop::quit);
+
+    timer.start();
+    ASSERT_TRUE(QFile::copy(QStringLiteral(":/audio/audiotest.flac"), albumDir + u"/dropped.flac"));
+    loop.exec();
+
+    ASSERT_GE(latencyMs, 0) << "No tracks were added after the file was dropped";
+
+    std::cout << "Added a dropped file in " << latencyMs << "ms, checking " << tracksConsidered << " of "
+              << index.size() << " library tracks\n";
+    RecordProperty("LatencyMs", static_cast<int>(latencyMs));
+}
+} // namespace Fooyin::Testing
@@ -0,0 +1,116 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <core/scripting/scriptparser.h>
+#include <core/track.h>
+
+#include <QElapsedTimer>
+
+#include <gtest/gtest.h>
+
+#include <iostream>
+
+namespace {
+constexpr auto TrackCount = 100000;
+
+Fooyin::TrackList syntheticTracks()
+{
+    Fooyin::TrackList tracks;
+    tracks.reserve(TrackCount);
+
+    for(int i{0}; i < TrackCount; ++i) {
+        Fooyin::Track track{QStringLiteral("/music/%1/%2.flac").arg(i / 500).arg(i)};
+        track.setTitle(QStringLiteral("Title %1").arg(i));
+        track.setAlbum(QStringLiteral("Album %1").arg(i / 12));
+        track.setArtists({QStringLiteral("Artist %1").arg(i / 120)});
+        track.setAlbumArtists({QStringLiteral("Album Artist %1").arg(i / 120)});
+        track.setGenres({QStringLiteral("Genre %1").arg(i % 40), QStringLiteral("Genre %1").arg(i % 7)});
+        track.setTrackNumber((i % 12) + 1);
+        track.setDiscNumber(1);
+        track.setDate(QString::number(1970 + (i % 50)));
+        track.setDuration(180000 + (i % 120) * 1000);
+        tracks.push_back(track);
+    }
+
+    return tracks;
+}
+
+template <typename Func>
+qint64 timeEvaluation(const Fooyin::TrackList& tracks, Func&& func)
+{
+    QElapsedTimer timer;
+    timer.start();
+    for(const Fooyin::Track& track : tracks) {
+        func(track);
+    }
+    return timer.elapsed();
+}
+} // namespace
+
+namespace Fooyin::Testing {
+class ScriptParserBenchmark : public ::testing::TestWithParam<QString>
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        s_tracks = syntheticTracks();
+    }
+
+    static void TearDownTestSuite()
+    {
+        s_tracks.clear();
+    }
+
+    static TrackList s_tracks;
+    ScriptParser m_parser;
+};
+
+TrackList ScriptParserBenchmark::s_tracks;
+
+TEST_P(ScriptParserBenchmark, TreeWalkerVsBytecode)
+{
+    const ParsedScript script = m_parser.parse(GetParam());
+    ASSERT_TRUE(script.program);
+
+    ParsedScript treeScript{script};
+    treeScript.program.reset();
+
+    for(const Track& track : s_tracks) {
+        ASSERT_EQ(m_parser.evaluate(treeScript, track), m_parser.evaluate(script, track));
+    }
+
+    const qint64 treeMs     = timeEvaluation(s_tracks, [this, &treeScript](const Track& track) {
+        return m_parser.evaluate(treeScript, track);
+    });
+    const qint64 bytecodeMs = timeEvaluation(s_tracks, [this, &script](const Track& track) {
+        return m_parser.evaluate(script, track);
+    });
+
+    std::cout << GetParam().toStdString() << "\n  tree: " << treeMs << "ms, bytecode: " << bytecodeMs << "ms ("
+              << TrackCount << " tracks)\n";
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Scripts, ScriptParserBenchmark,
+    ::testing::Values(
+        QStringLiteral("%albumartist% - %year% - %album% - $num(%disc%,5) - $num(%track%,5) - %title%"),
+        QStringLiteral("[%albumartist% - ][%year% - ]%album%[ - %genre%]"),
+        QStringLiteral("$if2(%composer%,%artist%)[ - $timems(%duration%)]"),
+        QStringLiteral("%<genre>% - %<artist>%")));
+} // namespace Fooyin::Testing
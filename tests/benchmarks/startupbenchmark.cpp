@@ -0,0 +1,144 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "core/database/database.h"
+#include "core/database/trackdatabase.h"
+#include "core/library/libraryindex.h"
+#include "core/library/librarysnapshot.h"
+
+#include <core/library/tracksort.h>
+#include <core/track.h>
+#include <utils/database/dbconnectionprovider.h>
+
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iostream>
+
+namespace {
+constexpr auto TrackCount         = 50000;
+constexpr auto SnapshotTrackCount = 300000;
+// Default value of Settings::Core::LibrarySortScript
+constexpr auto LibrarySortScript = "%albumartist% - %year% - %album% - $num(%disc%,5) - $num(%track%,5) - %title%";
+
+Fooyin::TrackList syntheticTracks(int count)
+{
+    Fooyin::TrackList tracks;
+    tracks.reserve(count);
+
+    for(int i{0}; i < count; ++i) {
+        Fooyin::Track track{QStringLiteral("/music/%1/%2.flac").arg(i / 500).arg(i)};
+        track.setTitle(QStringLiteral("Title %1").arg(i));
+        track.setAlbum(QStringLiteral("Album %1").arg(i / 12));
+        track.setArtists({QStringLiteral("Artist %1").arg(i / 120)});
+        track.setAlbumArtists({QStringLiteral("Album Artist %1").arg(i / 120)});
+        track.setTrackNumber((i % 12) + 1);
+        track.setDiscNumber(1);
+        track.setDate(QString::number(1970 + (i % 50)));
+        track.setGenres({QStringLiteral("Genre %1").arg(i % 20)});
+        track.setDuration(180000);
+        track.setSampleRate(44100);
+        track.generateHash();
+        tracks.push_back(track);
+    }
+
+    return tracks;
+}
+} // namespace
+
+namespace Fooyin::Testing {
+class StartupBenchmark : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(m_dataDir.isValid());
+    }
+
+    QTemporaryDir m_dataDir;
+};
+
+TEST_F(StartupBenchmark, LoadAllTracks)
+{
+    Database database{m_dataDir.filePath(QStringLiteral("fooyin.db"))};
+    ASSERT_EQ(database.status(), Database::Status::Ok);
+
+    TrackDatabase trackDatabase;
+    trackDatabase.initialise(DbConnectionProvider{database.connectionPool()});
+
+    TrackList tracks = syntheticTracks(TrackCount);
+    ASSERT_TRUE(trackDatabase.storeTracks(tracks));
+
+    QElapsedTimer timer;
+    timer.start();
+    TrackList loadedTracks = trackDatabase.getAllTracks();
+    const auto loadMs      = std::max<qint64>(timer.elapsed(), 1);
+
+    ASSERT_EQ(loadedTracks.size(), tracks.size());
+
+    // The per-row work the load used to do before handing the tracks over
+    timer.restart();
+    for(Track& track : loadedTracks) {
+        track.generateHash();
+        track.setIsEnabled(QFileInfo::exists(track.filepath()));
+    }
+    const auto deferredMs = timer.elapsed();
+
+    std::cout << "Loaded " << loadedTracks.size() << " tracks in " << loadMs << "ms (previously +" << deferredMs
+              << "ms for hashing and existence checks)\n";
+    RecordProperty("LoadMs", static_cast<int>(loadMs));
+    RecordProperty("DeferredMs", static_cast<int>(deferredMs));
+}
+
+TEST_F(StartupBenchmark, LoadSnapshot)
+{
+    const QString sort = QString::fromLatin1(LibrarySortScript);
+
+    TrackList tracks = syntheticTracks(SnapshotTrackCount);
+    for(int i{0}; Track& track : tracks) {
+        track.setId(i++);
+    }
+    tracks = Sorting::calcSortTracks(sort, tracks);
+
+    const LibrarySnapshot snapshot{m_dataDir.filePath(QStringLiteral("library.snapshot"))};
+    ASSERT_TRUE(snapshot.write(1, sort, tracks));
+
+    // Everything the library does before it can show the tracks
+    QElapsedTimer timer;
+    timer.start();
+    const auto contents = snapshot.read(1);
+    ASSERT_TRUE(contents.has_value());
+    const auto readMs = timer.elapsed();
+
+    LibraryIndex index;
+    index.reset(contents->tracks);
+    const TrackList loadedTracks = index.tracks();
+    const auto loadMs            = std::max<qint64>(timer.elapsed(), 1);
+
+    ASSERT_EQ(loadedTracks.size(), tracks.size());
+
+    std::cout << "Loaded " << loadedTracks.size() << " tracks from a snapshot in " << loadMs << "ms (" << readMs
+              << "ms reading)\n";
+    RecordProperty("SnapshotLoadMs", static_cast<int>(loadMs));
+}
+} // namespace Fooyin::Testing
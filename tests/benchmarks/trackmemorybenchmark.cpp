@@ -0,0 +1,136 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <core/track.h>
+#include <utils/stringpool.h>
+
+#include <QElapsedTimer>
+
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <unordered_set>
+
+namespace {
+constexpr auto TrackCount = 300000;
+// Rough size of the header Qt allocates alongside each string or list's data
+constexpr size_t AllocationOverhead = 16;
+
+// Counts the heap used by strings and lists, both as held and as if nothing were shared
+class MemoryCounter
+{
+public:
+    void add(const QString& str)
+    {
+        if(str.isEmpty()) {
+            return;
+        }
+        count(str.constData(), (static_cast<size_t>(str.capacity()) * sizeof(QChar)) + AllocationOverhead);
+    }
+
+    void add(const QStringList& list)
+    {
+        if(list.isEmpty()) {
+            return;
+        }
+        count(list.constData(), (static_cast<size_t>(list.capacity()) * sizeof(QString)) + AllocationOverhead);
+        for(const QString& str : list) {
+            add(str);
+        }
+    }
+
+    [[nodiscard]] size_t unsharedBytes() const
+    {
+        return m_unsharedBytes;
+    }
+
+    [[nodiscard]] size_t sharedBytes() const
+    {
+        return m_sharedBytes;
+    }
+
+private:
+    void count(const void* data, size_t bytes)
+    {
+        m_unsharedBytes += bytes;
+        if(m_seen.insert(data).second) {
+            m_sharedBytes += bytes;
+        }
+    }
+
+    std::unordered_set<const void*> m_seen;
+    size_t m_unsharedBytes{0};
+    size_t m_sharedBytes{0};
+};
+
+// Every value is built separately, as when read from tags or the database
+Fooyin::TrackList syntheticTracks()
+{
+    Fooyin::TrackList tracks;
+    tracks.reserve(TrackCount);
+
+    for(int i{0}; i < TrackCount; ++i) {
+        Fooyin::Track track{QStringLiteral("/music/%1/%2.flac").arg(i / 500).arg(i)};
+        track.setTitle(QStringLiteral("Title %1").arg(i));
+        track.setAlbum(QStringLiteral("Album %1").arg(i / 12));
+        track.setArtists({QStringLiteral("Artist %1").arg(i / 120)});
+        track.setAlbumArtists({QStringLiteral("Album Artist %1").arg(i / 120)});
+        track.setGenres({QStringLiteral("Genre %1").arg(i % 40), QStringLiteral("Genre %1").arg(i % 7)});
+        track.setComposer(QStringLiteral("Composer %1").arg(i / 600));
+        track.setDate(QString::number(1970 + (i % 50)));
+        tracks.push_back(track);
+    }
+
+    return tracks;
+}
+} // namespace
+
+namespace Fooyin::Testing {
+TEST(TrackMemoryBenchmark, InternedMetadata)
+{
+    QElapsedTimer timer;
+    timer.start();
+    const TrackList tracks = syntheticTracks();
+    const auto buildMs     = timer.elapsed();
+
+    MemoryCounter counter;
+    for(const Track& track : tracks) {
+        counter.add(track.artists());
+        counter.add(track.album());
+        counter.add(track.albumArtists());
+        counter.add(track.genres());
+        counter.add(track.composer());
+        counter.add(track.date());
+        counter.add(track.extension());
+    }
+
+    const StringPool::Stats pool = StringPool::instance().stats();
+    const size_t saved           = counter.unsharedBytes() - counter.sharedBytes();
+
+    EXPECT_LT(counter.sharedBytes(), counter.unsharedBytes());
+
+    std::cout << "Interned metadata for " << tracks.size() << " tracks in " << buildMs << "ms: "
+              << counter.sharedBytes() / 1024 << "KiB held, " << counter.unsharedBytes() / 1024
+              << "KiB if unshared (" << saved / 1024 << "KiB saved); pool holds " << pool.strings << " strings and "
+              << pool.lists << " lists\n";
+    RecordProperty("SharedKiB", static_cast<int>(counter.sharedBytes() / 1024));
+    RecordProperty("UnsharedKiB", static_cast<int>(counter.unsharedBytes() / 1024));
+    RecordProperty("SavedKiB", static_cast<int>(saved / 1024));
+}
+} // namespace Fooyin::Testing
@@ -0,0 +1,157 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <core/library/trackquery.h>
+#include <core/track.h>
+
+#include <QDateTime>
+#include <QElapsedTimer>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iostream>
+
+namespace {
+constexpr auto TrackCount  = 300000;
+constexpr int64_t MsPerDay = 24 * 3600000;
+
+Fooyin::TrackList syntheticTracks()
+{
+    Fooyin::TrackList tracks;
+    tracks.reserve(TrackCount);
+
+    const int64_t now = QDateTime::currentMSecsSinceEpoch();
+
+    for(int i{0}; i < TrackCount; ++i) {
+        Fooyin::Track track{QStringLiteral("/music/%1/%2.flac").arg(i / 500).arg(i)};
+        track.setId(i);
+        track.setTitle(QStringLiteral("Title %1").arg(i));
+        track.setAlbum(QStringLiteral("Album %1").arg(i / 12));
+        track.setArtists({QStringLiteral("Artist %1").arg(i / 120)});
+        track.setAlbumArtists({QStringLiteral("Album Artist %1").arg(i / 120)});
+        track.setGenres({QStringLiteral("Genre %1").arg(i % 40)});
+        track.setDate(QString::number(1970 + (i % 50)));
+        track.setDuration(120000 + ((i % 300) * 1000));
+        track.setPlayCount(i % 25);
+        track.setAddedTime(now - ((i % 1000) * MsPerDay));
+        if(i % 3 == 0) {
+            track.setLastPlayed(now - ((i % 90) * MsPerDay));
+        }
+        track.addExtraTag(QStringLiteral("MOOD"), QStringLiteral("Mood %1").arg(i % 10));
+        tracks.push_back(track);
+    }
+
+    return tracks;
+}
+
+// The previous search, which checked four fields for the whole search string
+Fooyin::TrackList containsFilter(const Fooyin::TrackList& tracks, const QString& search)
+{
+    Fooyin::TrackList matches;
+    std::ranges::copy_if(tracks, std::back_inserter(matches), [&search](const Fooyin::Track& track) {
+        return track.artist().contains(search, Qt::CaseInsensitive)
+            || track.title().contains(search, Qt::CaseInsensitive)
+            || track.album().contains(search, Qt::CaseInsensitive)
+            || track.albumArtist().contains(search, Qt::CaseInsensitive);
+    });
+    return matches;
+}
+
+// Evaluates the query on a single thread, for comparison with the chunked filter
+Fooyin::TrackList serialFilter(const Fooyin::TrackQuery& query, const Fooyin::TrackList& tracks)
+{
+    Fooyin::TrackList matches;
+    std::ranges::copy_if(tracks, std::back_inserter(matches),
+                         [&query](const Fooyin::Track& track) { return query.matches(track); });
+    return matches;
+}
+} // namespace
+
+namespace Fooyin::Testing {
+class TrackQueryBenchmark : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        s_tracks = syntheticTracks();
+    }
+
+    static void TearDownTestSuite()
+    {
+        s_tracks = {};
+    }
+
+    static TrackList s_tracks;
+};
+
+TrackList TrackQueryBenchmark::s_tracks;
+
+TEST_F(TrackQueryBenchmark, PlainSearch)
+{
+    const QString search = QStringLiteral("artist 12");
+
+    QElapsedTimer timer;
+    timer.start();
+    const TrackList previous = containsFilter(s_tracks, search);
+    const qint64 previousMs  = timer.restart();
+    const TrackQuery query{QStringLiteral("\"artist 12\"")};
+    const TrackList matches = query.filter(s_tracks);
+    const qint64 queryMs    = timer.elapsed();
+
+    ASSERT_EQ(previous.size(), matches.size());
+
+    std::cout << "Searched " << TrackCount << " tracks for '" << search.toStdString() << "' (" << matches.size()
+              << " matches)\n  contains: " << previousMs << "ms, query: " << queryMs << "ms\n";
+
+    RecordProperty("ContainsMs", static_cast<int>(previousMs));
+    RecordProperty("QueryMs", static_cast<int>(queryMs));
+}
+
+TEST_F(TrackQueryBenchmark, TypicalQueries)
+{
+    const QStringList queries{
+        QStringLiteral("title 123"),
+        QStringLiteral("genre=\"genre 7\""),
+        QStringLiteral("year:1990..1999 AND duration>5:00"),
+        QStringLiteral("playcount>=20 OR lastplayed>7d"),
+        QStringLiteral("addedtime>30d NOT genre:\"genre 1\""),
+        QStringLiteral("%mood%=\"mood 3\" (artist:10 OR album:10)"),
+    };
+
+    for(const QString& search : queries) {
+        QElapsedTimer timer;
+        timer.start();
+        const TrackQuery query{search};
+        const qint64 compileUs = timer.nsecsElapsed() / 1000;
+
+        timer.restart();
+        const TrackList serial  = serialFilter(query, s_tracks);
+        const qint64 serialMs   = timer.restart();
+        const TrackList matches = query.filter(s_tracks);
+        const qint64 parallelMs = timer.elapsed();
+
+        ASSERT_TRUE(query.isValid()) << search.toStdString();
+        ASSERT_EQ(serial.size(), matches.size()) << search.toStdString();
+
+        std::cout << search.toStdString() << ": " << matches.size() << " matches, compiled in " << compileUs
+                  << "us\n  single thread: " << serialMs << "ms, chunked: " << parallelMs << "ms\n";
+    }
+}
+} // namespace Fooyin::Testing
@@ -0,0 +1,101 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <core/library/tracksort.h>
+#include <core/track.h>
+
+#include <QCollator>
+#include <QElapsedTimer>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iostream>
+
+namespace {
+constexpr auto TrackCount = 200000;
+// Default value of Settings::Core::LibrarySortScript
+constexpr auto LibrarySortScript = "%albumartist% - %year% - %album% - $num(%disc%,5) - $num(%track%,5) - %title%";
+
+Fooyin::TrackList syntheticTracks()
+{
+    Fooyin::TrackList tracks;
+    tracks.reserve(TrackCount);
+
+    // Interleave albums so the input isn't already close to sorted
+    for(int i{0}; i < TrackCount; ++i) {
+        const int n = (i * 7919) % TrackCount;
+        Fooyin::Track track{QStringLiteral("/music/%1/%2.flac").arg(n / 500).arg(n)};
+        track.setTitle(QStringLiteral("Title %1").arg(n));
+        track.setAlbum(QStringLiteral("Album %1").arg(n / 12));
+        track.setAlbumArtists({QStringLiteral("Album Artist %1").arg(n / 120)});
+        track.setTrackNumber((n % 12) + 1);
+        track.setDiscNumber(1);
+        track.setDate(QString::number(1970 + (n % 50)));
+        tracks.push_back(track);
+    }
+
+    return tracks;
+}
+
+// The previous implementation, which collated the sort strings on every comparison
+Fooyin::TrackList collatorSort(const Fooyin::TrackList& tracks)
+{
+    Fooyin::TrackList sortedTracks{tracks};
+
+    QCollator collator;
+    collator.setNumericMode(true);
+
+    std::ranges::sort(sortedTracks, [&collator](const Fooyin::Track& lhs, const Fooyin::Track& rhs) {
+        return collator.compare(lhs.sort(), rhs.sort()) < 0;
+    });
+    return sortedTracks;
+}
+
+QStringList sortFields(const Fooyin::TrackList& tracks)
+{
+    QStringList fields;
+    fields.reserve(static_cast<qsizetype>(tracks.size()));
+    std::ranges::transform(tracks, std::back_inserter(fields), [](const Fooyin::Track& track) { return track.sort(); });
+    return fields;
+}
+} // namespace
+
+namespace Fooyin::Testing {
+TEST(TrackSortBenchmark, LibrarySortScript)
+{
+    const TrackList tracks = Sorting::calcSortFields(QString::fromLatin1(LibrarySortScript), syntheticTracks());
+
+    QElapsedTimer timer;
+    timer.start();
+    const TrackList collatorSorted = collatorSort(tracks);
+    const qint64 collatorMs        = timer.restart();
+    const TrackList keySorted      = Sorting::sortTracks(tracks);
+    const qint64 sortKeyMs         = timer.elapsed();
+
+    // Ties may be ordered differently, but the sequence of sort fields must match
+    ASSERT_EQ(sortFields(collatorSorted), sortFields(keySorted));
+
+    std::cout << "Sorted " << TrackCount << " tracks\n  collator compare: " << collatorMs
+              << "ms, sort keys: " << sortKeyMs << "ms\n";
+
+    RecordProperty("CollatorMs", static_cast<int>(collatorMs));
+    RecordProperty("SortKeyMs", static_cast<int>(sortKeyMs));
+}
+} // namespace Fooyin::Testing
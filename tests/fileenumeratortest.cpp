@@ -0,0 +1,132 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <utils/fileenumerator.h>
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <gtest/gtest.h>
+
+namespace {
+QStringList takeAll(Fooyin::FileEnumerator& enumerator)
+{
+    QStringList files;
+    QStringList batch;
+    while(!(batch = enumerator.takeFiles(2)).isEmpty()) {
+        EXPECT_LE(batch.size(), 2);
+        files.append(batch);
+    }
+    return files;
+}
+} // namespace
+
+namespace Fooyin::Testing {
+class FileEnumeratorTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(m_dir.isValid());
+
+        const QStringList files{QStringLiteral("a.flac"),         QStringLiteral("b.MP3"),
+                                QStringLiteral("cover.jpg"),      QStringLiteral("Album/1.flac"),
+                                QStringLiteral("Album/2.flac"),   QStringLiteral("Album/Disc 2/1.ogg"),
+                                QStringLiteral(".hidden/3.flac"), QStringLiteral("Album/.4.flac")};
+
+        for(const QString& file : files) {
+            const QString path = m_dir.filePath(file);
+            ASSERT_TRUE(QDir{}.mkpath(QFileInfo{path}.absolutePath()));
+            QFile output{path};
+            ASSERT_TRUE(output.open(QIODevice::WriteOnly));
+        }
+    }
+
+    [[nodiscard]] QString path(const QString& file) const
+    {
+        return m_dir.filePath(file);
+    }
+
+    QTemporaryDir m_dir;
+};
+
+TEST_F(FileEnumeratorTest, FindsMatchingFiles)
+{
+    FileEnumerator enumerator{{m_dir.path()}, {QStringLiteral("*.flac"), QStringLiteral("*.mp3")}};
+
+    const QStringList expected{path(QStringLiteral("a.flac")), path(QStringLiteral("b.MP3")),
+                               path(QStringLiteral("Album/1.flac")), path(QStringLiteral("Album/2.flac"))};
+    EXPECT_EQ(expected, takeAll(enumerator));
+}
+
+TEST_F(FileEnumeratorTest, SortsEachDirectoryIgnoringCase)
+{
+    for(const QString& file : {QStringLiteral("Z.flac"), QStringLiteral("c.flac"), QStringLiteral("Album/10.flac")}) {
+        QFile output{path(file)};
+        ASSERT_TRUE(output.open(QIODevice::WriteOnly));
+    }
+
+    FileEnumerator enumerator{{m_dir.path()}, {QStringLiteral("*.flac")}};
+
+    const QStringList expected{path(QStringLiteral("a.flac")),        path(QStringLiteral("c.flac")),
+                               path(QStringLiteral("Z.flac")),        path(QStringLiteral("Album/1.flac")),
+                               path(QStringLiteral("Album/10.flac")), path(QStringLiteral("Album/2.flac"))};
+    EXPECT_EQ(expected, takeAll(enumerator));
+}
+
+TEST_F(FileEnumeratorTest, NoFiltersFindsAllFiles)
+{
+    FileEnumerator enumerator{{m_dir.path()}};
+
+    EXPECT_EQ(6, takeAll(enumerator).size());
+}
+
+TEST_F(FileEnumeratorTest, ParallelWalkFindsSameFiles)
+{
+    FileEnumerator serial{{m_dir.path()}};
+    FileEnumerator parallel{{m_dir.path()}, {}, 4};
+
+    // Directories can finish in any order when walked in parallel
+    QStringList serialFiles   = takeAll(serial);
+    QStringList parallelFiles = takeAll(parallel);
+    serialFiles.sort();
+    parallelFiles.sort();
+
+    EXPECT_EQ(serialFiles, parallelFiles);
+}
+
+TEST_F(FileEnumeratorTest, SymlinkLoopIsVisitedOnce)
+{
+    ASSERT_TRUE(QFile::link(m_dir.path(), path(QStringLiteral("Album/loop"))));
+
+    FileEnumerator enumerator{{m_dir.path()}, {QStringLiteral("*.ogg")}};
+
+    EXPECT_EQ(QStringList{path(QStringLiteral("Album/Disc 2/1.ogg"))}, takeAll(enumerator));
+}
+
+TEST_F(FileEnumeratorTest, CancelStopsWalk)
+{
+    FileEnumerator enumerator{{m_dir.path()}};
+    enumerator.cancel();
+
+    // Anything found before cancelling may still be returned, but the walk must end
+    EXPECT_LE(takeAll(enumerator).size(), 6);
+}
+} // namespace Fooyin::Testing
@@ -0,0 +1,256 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "core/library/libraryindex.h"
+
+#include <core/library/trackstore.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+namespace {
+Fooyin::Track makeTrack(int id, const QString& sort)
+{
+    Fooyin::Track track;
+    track.setId(id);
+    track.setSort(sort);
+    return track;
+}
+
+Fooyin::Track makeTrack(int id, const QString& sort, const QString& filepath)
+{
+    Fooyin::Track track{filepath};
+    track.setId(id);
+    track.setSort(sort);
+    return track;
+}
+
+Fooyin::TrackIds trackIds(const Fooyin::TrackList& tracks)
+{
+    Fooyin::TrackIds ids;
+    std::ranges::transform(tracks, std::back_inserter(ids), [](const Fooyin::Track& track) { return track.id(); });
+    return ids;
+}
+} // namespace
+
+namespace Fooyin::Testing {
+class LibraryIndexTest : public ::testing::Test
+{
+protected:
+    LibraryIndex m_index;
+};
+
+TEST_F(LibraryIndexTest, ResetSortsTracks)
+{
+    m_index.reset({makeTrack(1, QStringLiteral("b")), makeTrack(2, QStringLiteral("track 10")),
+                   makeTrack(3, QStringLiteral("a")), makeTrack(4, QStringLiteral("track 9"))});
+
+    EXPECT_EQ(4U, m_index.size());
+    EXPECT_EQ((TrackIds{3, 1, 4, 2}), trackIds(m_index.tracks()));
+}
+
+TEST_F(LibraryIndexTest, InsertKeepsOrder)
+{
+    m_index.reset({makeTrack(1, QStringLiteral("a")), makeTrack(2, QStringLiteral("c"))});
+    m_index.insert(makeTrack(3, QStringLiteral("b")));
+
+    EXPECT_EQ((TrackIds{1, 3, 2}), trackIds(m_index.tracks()));
+}
+
+TEST_F(LibraryIndexTest, EqualSortKeepsInsertionOrder)
+{
+    m_index.reset({makeTrack(1, QStringLiteral("a")), makeTrack(2, QStringLiteral("a"))});
+    m_index.insert(makeTrack(3, QStringLiteral("a")));
+
+    EXPECT_EQ((TrackIds{1, 2, 3}), trackIds(m_index.tracks()));
+
+    // Updating a track shouldn't move it amongst tracks with the same sort field
+    m_index.insert(makeTrack(1, QStringLiteral("a")));
+
+    EXPECT_EQ((TrackIds{1, 2, 3}), trackIds(m_index.tracks()));
+}
+
+TEST_F(LibraryIndexTest, UpdateRepositionsTrack)
+{
+    m_index.reset({makeTrack(1, QStringLiteral("a")), makeTrack(2, QStringLiteral("b")),
+                   makeTrack(3, QStringLiteral("c"))});
+    m_index.insert(makeTrack(1, QStringLiteral("d")));
+
+    EXPECT_EQ(3U, m_index.size());
+    EXPECT_EQ((TrackIds{2, 3, 1}), trackIds(m_index.tracks()));
+    EXPECT_EQ(u"d", m_index.tracksForIds({1}).front().sort());
+}
+
+TEST_F(LibraryIndexTest, RemoveTrack)
+{
+    m_index.reset({makeTrack(1, QStringLiteral("a")), makeTrack(2, QStringLiteral("b"))});
+
+    EXPECT_TRUE(m_index.remove(1));
+    EXPECT_FALSE(m_index.remove(1));
+    EXPECT_FALSE(m_index.contains(1));
+    EXPECT_EQ((TrackIds{2}), trackIds(m_index.tracks()));
+}
+
+TEST_F(LibraryIndexTest, TracksForIds)
+{
+    m_index.reset({makeTrack(1, QStringLiteral("a")), makeTrack(2, QStringLiteral("b")),
+                   makeTrack(3, QStringLiteral("c"))});
+
+    EXPECT_EQ((TrackIds{3, 1}), trackIds(m_index.tracksForIds({3, 5, 1})));
+}
+
+TEST_F(LibraryIndexTest, TracksInDirectory)
+{
+    m_index.reset({makeTrack(1, QStringLiteral("a"), QStringLiteral("/music/a/2.flac")),
+                   makeTrack(2, QStringLiteral("b"), QStringLiteral("/music/ab/1.flac")),
+                   makeTrack(3, QStringLiteral("c"), QStringLiteral("/music/a/1.flac")),
+                   makeTrack(4, QStringLiteral("d"), QStringLiteral("/music/a/disc 2/1.flac"))});
+
+    EXPECT_EQ((TrackIds{3, 1, 4}), trackIds(m_index.tracksInDirectory(QStringLiteral("/music/a"))));
+    EXPECT_EQ((TrackIds{4}), trackIds(m_index.tracksInDirectory(QStringLiteral("/music/a/disc 2/"))));
+    EXPECT_EQ(4U, m_index.tracksInDirectory(QStringLiteral("/music")).size());
+    EXPECT_TRUE(m_index.tracksInDirectory(QStringLiteral("/other")).empty());
+}
+
+TEST_F(LibraryIndexTest, TracksInDirectoryFollowsUpdates)
+{
+    m_index.reset({makeTrack(1, QStringLiteral("a"), QStringLiteral("/music/a/1.flac")),
+                   makeTrack(2, QStringLiteral("b"), QStringLiteral("/music/a/2.flac"))});
+
+    m_index.insert(makeTrack(1, QStringLiteral("a"), QStringLiteral("/music/b/1.flac")));
+    m_index.remove(2);
+
+    EXPECT_TRUE(m_index.tracksInDirectory(QStringLiteral("/music/a")).empty());
+    EXPECT_EQ((TrackIds{1}), trackIds(m_index.tracksInDirectory(QStringLiteral("/music/b"))));
+}
+
+TEST_F(LibraryIndexTest, TracksForPaths)
+{
+    m_index.reset({makeTrack(1, QStringLiteral("a"), QStringLiteral("/music/a/1.flac")),
+                   makeTrack(2, QStringLiteral("b"), QStringLiteral("/music/a/2.flac")),
+                   makeTrack(3, QStringLiteral("c"), QStringLiteral("/music/a/1.flac.bak"))});
+
+    EXPECT_EQ((TrackIds{2, 1}), trackIds(m_index.tracksForPaths({QStringLiteral("/music/a/2.flac"),
+                                                                 QStringLiteral("/music/a/1.flac")})));
+    EXPECT_TRUE(m_index.tracksForPaths({QStringLiteral("/music/a")}).empty());
+
+    m_index.insert(makeTrack(1, QStringLiteral("a"), QStringLiteral("/music/b/1.flac")));
+
+    EXPECT_TRUE(m_index.tracksForPaths({QStringLiteral("/music/a/1.flac")}).empty());
+    EXPECT_EQ((TrackIds{1}), trackIds(m_index.tracksForPaths({QStringLiteral("/music/b/1.flac")})));
+}
+
+TEST_F(LibraryIndexTest, TracksWithHash)
+{
+    Track track1 = makeTrack(1, QStringLiteral("a"));
+    track1.setHash(QStringLiteral("hash1"));
+    Track track2 = makeTrack(2, QStringLiteral("b"));
+    track2.setHash(QStringLiteral("hash2"));
+    Track track3 = makeTrack(3, QStringLiteral("c"));
+    track3.setHash(QStringLiteral("hash1"));
+
+    m_index.reset({track1, track2, track3});
+
+    TrackIds ids = trackIds(m_index.tracksWithHash(QStringLiteral("hash1")));
+    std::ranges::sort(ids);
+    EXPECT_EQ((TrackIds{1, 3}), ids);
+
+    // Changing a track's hash moves it to the new one
+    track3.setHash(QStringLiteral("hash2"));
+    m_index.insert(track3);
+    m_index.remove(2);
+
+    EXPECT_EQ((TrackIds{1}), trackIds(m_index.tracksWithHash(QStringLiteral("hash1"))));
+    EXPECT_EQ((TrackIds{3}), trackIds(m_index.tracksWithHash(QStringLiteral("hash2"))));
+}
+
+TEST_F(LibraryIndexTest, StatsUpdateKeepsPosition)
+{
+    m_index.reset({makeTrack(1, QStringLiteral("a")), makeTrack(2, QStringLiteral("a")),
+                   makeTrack(3, QStringLiteral("b"))});
+
+    Track played = m_index.tracksForIds({1}).front();
+    played.setPlayCount(5);
+    m_index.insert(played);
+
+    EXPECT_EQ((TrackIds{1, 2, 3}), trackIds(m_index.tracks()));
+    EXPECT_EQ(5, m_index.tracks().front().playCount());
+}
+
+TEST_F(LibraryIndexTest, StoreFollowsIndex)
+{
+    Track track1 = makeTrack(1, QStringLiteral("b"));
+    track1.setLibraryId(1);
+    track1.setAlbum(QStringLiteral("Album"));
+    Track track2 = makeTrack(2, QStringLiteral("a"));
+    track2.setLibraryId(2);
+    track2.setAlbum(QStringLiteral("Album"));
+
+    m_index.reset({track1, track2});
+
+    const TrackStore& store = m_index.store();
+    ASSERT_EQ(2U, store.size());
+    EXPECT_EQ((std::vector<int>{1, 2}), std::vector<int>(store.ids().begin(), store.ids().end()));
+    // Both tracks share the same interned album
+    EXPECT_NE(0U, store.albumIds()[0]);
+    EXPECT_EQ(store.albumIds()[0], store.albumIds()[1]);
+    EXPECT_EQ(std::vector<size_t>{0}, store.rowsInLibrary(1));
+
+    Track track3 = makeTrack(3, QStringLiteral("c"));
+    track3.setLibraryId(1);
+    m_index.insert(track3);
+    m_index.remove(1);
+
+    // The last row takes the place of the removed one
+    EXPECT_EQ((std::vector<int>{3, 2}), std::vector<int>(store.ids().begin(), store.ids().end()));
+    EXPECT_EQ(0U, store.rowForId(3));
+    EXPECT_FALSE(store.rowForId(1));
+    EXPECT_EQ(std::vector<size_t>{0}, store.rowsInLibrary(1));
+    EXPECT_TRUE(store.rowsInLibrary(3).empty());
+
+    // Updating a track in place updates its row
+    track2.setPlayCount(5);
+    track2.setLibraryId(3);
+    m_index.insert(track2);
+
+    EXPECT_EQ(1U, store.rowForId(2));
+    EXPECT_EQ(5, store.track(1).playCount());
+    EXPECT_EQ(std::vector<size_t>{1}, store.rowsInLibrary(3));
+
+    m_index.clear();
+
+    EXPECT_TRUE(store.empty());
+}
+
+TEST_F(LibraryIndexTest, StoreRowsWithHash)
+{
+    Track track1 = makeTrack(1, QStringLiteral("a"));
+    track1.setHash(QStringLiteral("hash1"));
+    Track track2 = makeTrack(2, QStringLiteral("b"));
+    track2.setHash(QStringLiteral("hash2"));
+    Track track3 = makeTrack(3, QStringLiteral("c"));
+    track3.setHash(QStringLiteral("hash1"));
+
+    m_index.reset({track1, track2, track3});
+
+    EXPECT_EQ((std::vector<size_t>{0, 2}), m_index.store().rowsWithHash(QStringLiteral("hash1")));
+    EXPECT_TRUE(m_index.store().rowsWithHash(QStringLiteral("hash3")).empty());
+}
+} // namespace Fooyin::Testing
@@ -0,0 +1,111 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "core/library/librarysnapshot.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <gtest/gtest.h>
+
+namespace {
+Fooyin::Track makeTrack(int id, const QString& sort)
+{
+    Fooyin::Track track{QStringLiteral("/music/%1.flac").arg(id)};
+    track.setId(id);
+    track.setTitle(QStringLiteral("Title %1").arg(id));
+    track.setArtists({QStringLiteral("Artist"), QStringLiteral("Other Artist")});
+    track.setTrackNumber(id);
+    track.setDuration(180000);
+    track.addExtraTag(QStringLiteral("MOOD"), QStringLiteral("Calm"));
+    track.setPlayCount(id * 2);
+    track.generateHash();
+    track.setSort(sort);
+    return track;
+}
+} // namespace
+
+namespace Fooyin::Testing {
+class LibrarySnapshotTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(m_dir.isValid());
+    }
+
+    [[nodiscard]] QString snapshotPath() const
+    {
+        return m_dir.filePath(QStringLiteral("library.snapshot"));
+    }
+
+    QTemporaryDir m_dir;
+};
+
+TEST_F(LibrarySnapshotTest, RoundTrip)
+{
+    const TrackList tracks{makeTrack(2, QStringLiteral("a")), makeTrack(1, QStringLiteral("b"))};
+    const QString sort = QStringLiteral("%title%");
+
+    const LibrarySnapshot snapshot{snapshotPath()};
+    ASSERT_TRUE(snapshot.write(42, sort, tracks));
+
+    const auto contents = snapshot.read(42);
+    ASSERT_TRUE(contents.has_value());
+
+    EXPECT_EQ(42U, contents->generation);
+    EXPECT_EQ(sort, contents->sort);
+    ASSERT_EQ(tracks.size(), contents->tracks.size());
+
+    for(size_t i{0}; i < tracks.size(); ++i) {
+        const Track& expected = tracks.at(i);
+        const Track& actual   = contents->tracks.at(i);
+
+        EXPECT_EQ(expected.id(), actual.id());
+        EXPECT_EQ(expected.filepath(), actual.filepath());
+        EXPECT_EQ(expected.title(), actual.title());
+        EXPECT_EQ(expected.artists(), actual.artists());
+        EXPECT_EQ(expected.trackNumber(), actual.trackNumber());
+        EXPECT_EQ(expected.duration(), actual.duration());
+        EXPECT_EQ(expected.extraTags(), actual.extraTags());
+        EXPECT_EQ(expected.playCount(), actual.playCount());
+        EXPECT_EQ(expected.hash(), actual.hash());
+        EXPECT_EQ(expected.sort(), actual.sort());
+    }
+}
+
+TEST_F(LibrarySnapshotTest, GenerationMismatchIsIgnored)
+{
+    const LibrarySnapshot snapshot{snapshotPath()};
+    ASSERT_TRUE(snapshot.write(1, QStringLiteral("%title%"), {makeTrack(1, QStringLiteral("a"))}));
+
+    EXPECT_FALSE(snapshot.read(2).has_value());
+}
+
+TEST_F(LibrarySnapshotTest, TruncatedSnapshotIsIgnored)
+{
+    const LibrarySnapshot snapshot{snapshotPath()};
+    ASSERT_TRUE(snapshot.write(1, QStringLiteral("%title%"), {makeTrack(1, QStringLiteral("a"))}));
+
+    QFile file{snapshotPath()};
+    ASSERT_TRUE(file.resize(file.size() - 4));
+
+    EXPECT_FALSE(snapshot.read(1).has_value());
+}
+} // namespace Fooyin::Testing
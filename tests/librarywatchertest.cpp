@@ -0,0 +1,274 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "core/library/librarywatcher.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QEventLoop>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTimer>
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+
+namespace {
+constexpr auto Timeout = 5s;
+
+// Describes each event as "<type>:<path>", with paths relative to @p root, sorted so batches compare equal
+QStringList describe(const Fooyin::FileEvents& events, const QString& root)
+{
+    using Type = Fooyin::FileEvent::Type;
+
+    const QDir rootDir{root};
+    const auto relative = [&rootDir](const QString& path) { return rootDir.relativeFilePath(path); };
+
+    QStringList descriptions;
+    for(const Fooyin::FileEvent& event : events) {
+        QString description;
+        switch(event.type) {
+            case(Type::Created):
+                description = QStringLiteral("Created:%1").arg(relative(event.path));
+                break;
+            case(Type::Modified):
+                description = QStringLiteral("Modified:%1").arg(relative(event.path));
+                break;
+            case(Type::Removed):
+                description = QStringLiteral("Removed:%1").arg(relative(event.path));
+                break;
+            case(Type::Moved):
+                description = QStringLiteral("Moved:%1->%2").arg(relative(event.oldPath), relative(event.path));
+                break;
+        }
+        if(event.isDir) {
+            description.append(u'/');
+        }
+        descriptions.append(description);
+    }
+
+    descriptions.sort();
+    return descriptions;
+}
+
+bool writeFile(const QString& path, const QByteArray& data = {})
+{
+    QFile file{path};
+    return file.open(QIODevice::Append) && file.write(data) == data.size();
+}
+} // namespace
+
+namespace Fooyin::Testing {
+class LibraryWatcherTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(m_dir.isValid());
+        ASSERT_TRUE(writeFile(path(QStringLiteral("a.flac"))));
+        ASSERT_TRUE(QDir{}.mkpath(path(QStringLiteral("Album"))));
+        ASSERT_TRUE(writeFile(path(QStringLiteral("Album/1.flac"))));
+
+        // Long enough for each test's changes to arrive as a single batch
+        m_watcher.setDelay(300ms);
+        QObject::connect(&m_watcher, &LibraryWatcher::filesChanged, &m_watcher, [this](const FileEvents& events) {
+            m_events.insert(m_events.end(), events.cbegin(), events.cend());
+        });
+    }
+
+    [[nodiscard]] QString path(const QString& file) const
+    {
+        return m_dir.filePath(file);
+    }
+
+    //! Starts watching the temporary directory, returning once it's fully watched
+    bool startWatching()
+    {
+        bool watching{false};
+        QEventLoop loop;
+        QObject::connect(&m_watcher, &LibraryWatcher::watching, &loop, [&]() {
+            watching = true;
+            loop.quit();
+        });
+        QTimer::singleShot(Timeout, &loop, &QEventLoop::quit);
+
+        m_watcher.addPath(m_dir.path());
+        loop.exec();
+
+        return watching;
+    }
+
+    //! Returns the next batch of events, or nothing if none are reported in time
+    QStringList nextEvents(std::chrono::milliseconds timeout = Timeout)
+    {
+        if(m_events.empty()) {
+            QEventLoop loop;
+            QObject::connect(&m_watcher, &LibraryWatcher::filesChanged, &loop, &QEventLoop::quit);
+            QTimer::singleShot(timeout, &loop, &QEventLoop::quit);
+            loop.exec();
+        }
+
+        return describe(std::exchange(m_events, {}), m_dir.path());
+    }
+
+    int m_argc{0};
+    QCoreApplication m_app{m_argc, nullptr};
+    QTemporaryDir m_dir;
+    LibraryWatcher m_watcher;
+    FileEvents m_events;
+};
+
+#ifdef Q_OS_LINUX
+TEST_F(LibraryWatcherTest, ReportsFileChanges)
+{
+    ASSERT_TRUE(startWatching());
+
+    ASSERT_TRUE(writeFile(path(QStringLiteral("b.flac")), "data"));
+    EXPECT_EQ(QStringList{QStringLiteral("Created:b.flac")}, nextEvents());
+
+    ASSERT_TRUE(writeFile(path(QStringLiteral("Album/1.flac")), "data"));
+    EXPECT_EQ(QStringList{QStringLiteral("Modified:Album/1.flac")}, nextEvents());
+
+    ASSERT_TRUE(QFile::remove(path(QStringLiteral("a.flac"))));
+    EXPECT_EQ(QStringList{QStringLiteral("Removed:a.flac")}, nextEvents());
+}
+
+TEST_F(LibraryWatcherTest, MergesEventsForTheSamePath)
+{
+    ASSERT_TRUE(startWatching());
+
+    // Came and went, so dropped entirely
+    ASSERT_TRUE(writeFile(path(QStringLiteral("b.flac"))));
+    ASSERT_TRUE(QFile::remove(path(QStringLiteral("b.flac"))));
+    // Replaced, so just modified
+    ASSERT_TRUE(QFile::remove(path(QStringLiteral("a.flac"))));
+    ASSERT_TRUE(writeFile(path(QStringLiteral("a.flac")), "data"));
+    // Modified and then removed
+    ASSERT_TRUE(writeFile(path(QStringLiteral("Album/1.flac")), "data"));
+    ASSERT_TRUE(QFile::remove(path(QStringLiteral("Album/1.flac"))));
+
+    EXPECT_EQ((QStringList{QStringLiteral("Modified:a.flac"), QStringLiteral("Removed:Album/1.flac")}), nextEvents());
+}
+
+TEST_F(LibraryWatcherTest, PairsMoves)
+{
+    ASSERT_TRUE(startWatching());
+
+    ASSERT_TRUE(QFile::rename(path(QStringLiteral("a.flac")), path(QStringLiteral("Album/a.flac"))));
+    EXPECT_EQ(QStringList{QStringLiteral("Moved:a.flac->Album/a.flac")}, nextEvents());
+
+    ASSERT_TRUE(QDir{}.rename(path(QStringLiteral("Album")), path(QStringLiteral("Album 2"))));
+    EXPECT_EQ(QStringList{QStringLiteral("Moved:Album->Album 2/")}, nextEvents());
+
+    // The watch follows the directory to its new name
+    ASSERT_TRUE(writeFile(path(QStringLiteral("Album 2/2.flac"))));
+    EXPECT_EQ(QStringList{QStringLiteral("Created:Album 2/2.flac")}, nextEvents());
+}
+
+TEST_F(LibraryWatcherTest, MovesInAndOutOfTheTree)
+{
+    QTemporaryDir outside;
+    ASSERT_TRUE(outside.isValid());
+    ASSERT_TRUE(writeFile(outside.filePath(QStringLiteral("c.flac"))));
+
+    ASSERT_TRUE(startWatching());
+
+    ASSERT_TRUE(QFile::rename(path(QStringLiteral("a.flac")), outside.filePath(QStringLiteral("a.flac"))));
+    ASSERT_TRUE(QFile::rename(outside.filePath(QStringLiteral("c.flac")), path(QStringLiteral("c.flac"))));
+
+    EXPECT_EQ((QStringList{QStringLiteral("Created:c.flac"), QStringLiteral("Removed:a.flac")}), nextEvents());
+
+    // Nothing moved out is watched any more
+    ASSERT_TRUE(QDir{}.rename(path(QStringLiteral("Album")), outside.filePath(QStringLiteral("Album"))));
+    EXPECT_EQ(QStringList{QStringLiteral("Removed:Album/")}, nextEvents());
+
+    ASSERT_TRUE(writeFile(outside.filePath(QStringLiteral("Album/2.flac"))));
+    EXPECT_TRUE(nextEvents(1s).empty());
+}
+
+TEST_F(LibraryWatcherTest, WatchesNewDirectories)
+{
+    QTemporaryDir outside;
+    ASSERT_TRUE(outside.isValid());
+    ASSERT_TRUE(QDir{}.mkpath(outside.filePath(QStringLiteral("New/Disc 1"))));
+
+    ASSERT_TRUE(startWatching());
+
+    // Directories within a new one are watched too
+    ASSERT_TRUE(QDir{}.rename(outside.filePath(QStringLiteral("New")), path(QStringLiteral("New"))));
+    EXPECT_EQ(QStringList{QStringLiteral("Created:New/")}, nextEvents());
+
+    ASSERT_TRUE(writeFile(path(QStringLiteral("New/Disc 1/1.flac"))));
+    EXPECT_EQ(QStringList{QStringLiteral("Created:New/Disc 1/1.flac")}, nextEvents());
+
+    ASSERT_TRUE(QDir{path(QStringLiteral("New"))}.removeRecursively());
+    EXPECT_EQ((QStringList{QStringLiteral("Removed:New/"), QStringLiteral("Removed:New/Disc 1/"),
+                           QStringLiteral("Removed:New/Disc 1/1.flac")}),
+              nextEvents());
+}
+
+TEST_F(LibraryWatcherTest, FollowsSymlinks)
+{
+    QTemporaryDir outside;
+    ASSERT_TRUE(outside.isValid());
+    ASSERT_TRUE(QFile::link(outside.path(), path(QStringLiteral("Linked"))));
+
+    ASSERT_TRUE(startWatching());
+
+    ASSERT_TRUE(writeFile(outside.filePath(QStringLiteral("1.flac"))));
+    EXPECT_EQ(QStringList{QStringLiteral("Created:Linked/1.flac")}, nextEvents());
+}
+#endif
+
+TEST_F(LibraryWatcherTest, PollsForChanges)
+{
+    m_watcher.setPollOnly(true);
+    m_watcher.setPollInterval(1s);
+    ASSERT_TRUE(startWatching());
+
+    ASSERT_TRUE(writeFile(path(QStringLiteral("b.flac"))));
+    ASSERT_TRUE(QDir{}.mkpath(path(QStringLiteral("New"))));
+    ASSERT_TRUE(writeFile(path(QStringLiteral("Album/1.flac")), "data"));
+    ASSERT_TRUE(QFile::remove(path(QStringLiteral("a.flac"))));
+
+    EXPECT_EQ((QStringList{QStringLiteral("Created:New/"), QStringLiteral("Created:b.flac"),
+                           QStringLiteral("Modified:Album/1.flac"), QStringLiteral("Removed:a.flac")}),
+              nextEvents());
+
+    // Polling can't pair moves
+    ASSERT_TRUE(QFile::rename(path(QStringLiteral("b.flac")), path(QStringLiteral("New/b.flac"))));
+    EXPECT_EQ((QStringList{QStringLiteral("Created:New/b.flac"), QStringLiteral("Removed:b.flac")}), nextEvents());
+}
+
+TEST_F(LibraryWatcherTest, PollingFollowsSymlinks)
+{
+    QTemporaryDir outside;
+    ASSERT_TRUE(outside.isValid());
+    ASSERT_TRUE(QFile::link(outside.path(), path(QStringLiteral("Linked"))));
+
+    m_watcher.setPollOnly(true);
+    m_watcher.setPollInterval(1s);
+    ASSERT_TRUE(startWatching());
+
+    ASSERT_TRUE(writeFile(outside.filePath(QStringLiteral("1.flac"))));
+    EXPECT_EQ(QStringList{QStringLiteral("Created:Linked/1.flac")}, nextEvents());
+}
+} // namespace Fooyin::Testing
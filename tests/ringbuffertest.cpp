@@ -0,0 +1,107 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <utils/ringbuffer.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <thread>
+
+namespace Fooyin::Testing {
+TEST(RingBufferTest, CapacityRoundsUp)
+{
+    const RingBuffer<int> buffer{5};
+
+    EXPECT_EQ(8U, buffer.capacity());
+    EXPECT_EQ(0U, buffer.readAvailable());
+    EXPECT_EQ(8U, buffer.writeAvailable());
+}
+
+TEST(RingBufferTest, WrapsAround)
+{
+    RingBuffer<int> buffer{8};
+
+    std::array<int, 10> input{};
+    std::iota(input.begin(), input.end(), 0);
+
+    EXPECT_EQ(8U, buffer.write(input));
+    EXPECT_EQ(0U, buffer.writeAvailable());
+
+    std::array<int, 3> output{};
+    EXPECT_EQ(3U, buffer.read(output));
+    EXPECT_EQ((std::array<int, 3>{0, 1, 2}), output);
+
+    // Wraps to the start of the storage
+    EXPECT_EQ(3U, buffer.write(std::span{input}.first(3)));
+
+    std::array<int, 8> wrapped{};
+    EXPECT_EQ(8U, buffer.read(wrapped));
+    EXPECT_EQ((std::array<int, 8>{3, 4, 5, 6, 7, 0, 1, 2}), wrapped);
+    EXPECT_EQ(0U, buffer.readAvailable());
+}
+
+TEST(RingBufferTest, Skip)
+{
+    RingBuffer<int> buffer{4};
+
+    const std::array<int, 4> input{1, 2, 3, 4};
+    buffer.write(input);
+
+    EXPECT_EQ(3U, buffer.skip(3));
+    EXPECT_EQ(1U, buffer.skip(3));
+    EXPECT_EQ(0U, buffer.readAvailable());
+}
+
+TEST(RingBufferTest, ProducerConsumer)
+{
+    constexpr int Count = 1000000;
+
+    RingBuffer<int> buffer{1024};
+
+    std::thread producer{[&buffer]() {
+        int next{0};
+        std::array<int, 7> chunk{};
+        while(next < Count) {
+            const auto size = static_cast<size_t>(std::min(static_cast<int>(chunk.size()), Count - next));
+            std::iota(chunk.begin(), chunk.begin() + static_cast<std::ptrdiff_t>(size), next);
+            next += static_cast<int>(buffer.write(std::span{chunk}.first(size)));
+        }
+    }};
+
+    int expected{0};
+    bool inOrder{true};
+    std::array<int, 13> chunk{};
+
+    while(expected < Count) {
+        const size_t read = buffer.read(chunk);
+        for(size_t i{0}; i < read; ++i) {
+            inOrder = inOrder && chunk.at(i) == expected;
+            ++expected;
+        }
+    }
+
+    producer.join();
+
+    EXPECT_TRUE(inOrder);
+    EXPECT_EQ(0U, buffer.readAvailable());
+}
+} // namespace Fooyin::Testing
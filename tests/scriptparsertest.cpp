@@ -18,6 +18,7 @@
  */
 
 #include <core/scripting/scriptparser.h>
+#include <core/scripting/scriptregistry.h>
 #include <core/track.h>
 
 #include <gtest/gtest.h>
@@ -126,4 +127,68 @@ TEST_F(ScriptParserTest, TrackListTest)
     EXPECT_EQ(u"00:05", m_parser.evaluate(QStringLiteral("%playtime%"), tracks));
     EXPECT_EQ(u"Pop / Rock", m_parser.evaluate(QStringLiteral("%genres%"), tracks));
 }
+
+TEST_F(ScriptParserTest, CompiledMatchesTreeWalker)
+{
+    Track track;
+    track.setTitle(QStringLiteral("A Test"));
+    track.setAlbum(QStringLiteral("A Test Album"));
+    track.setArtists({QStringLiteral("Me"), QStringLiteral("You")});
+    track.setGenres({QStringLiteral("Pop"), QStringLiteral("Rock")});
+    track.setTrackNumber(3);
+    track.setDuration(192000);
+
+    const QStringList scripts{
+        QStringLiteral("%albumartist% - %year% - %album% - $num(%disc%,5) - $num(%track%,5) - %title%"),
+        QStringLiteral("[%disc% - ]$num(%track%,2)[ / %tracktotal%]"),
+        QStringLiteral("%<genre>% - %<artist>%"),
+        QStringLiteral("[%<genre>% ]%title%[ - %album%]"),
+        QStringLiteral("$if($strcmp(%title%,A Test),[%album% - ]%genre%,$timems(%duration%))"),
+        QStringLiteral("$if2(%composer%,%artist%) $ifgreater(%track%,2,late,early)"),
+        QStringLiteral("\"%title%\" [%composer%]"),
+    };
+
+    for(const QString& input : scripts) {
+        const auto script = m_parser.parse(input, track);
+        ASSERT_TRUE(script.program);
+
+        ParsedScript treeScript{script};
+        treeScript.program.reset();
+
+        EXPECT_EQ(m_parser.evaluate(treeScript, track), m_parser.evaluate(script, track)) << input.toStdString();
+    }
+}
+
+TEST_F(ScriptParserTest, ResolvedVariablesMatchNames)
+{
+    const ScriptRegistry registry;
+
+    Track track;
+    track.setTitle(QStringLiteral("A Test"));
+    track.setGenres({QStringLiteral("Pop"), QStringLiteral("Rock")});
+    track.setTrackNumber(3);
+    track.setDuration(192000);
+    track.addExtraTag(QStringLiteral("MOOD"), QStringLiteral("Happy"));
+
+    const TrackList tracks{track, track};
+
+    const QStringList vars{
+        QStringLiteral("title"),    QStringLiteral("genre"), QStringLiteral("track"),   QStringLiteral("disc"),
+        QStringLiteral("duration"), QStringLiteral("mood"),  QStringLiteral("missing"), QStringLiteral("trackcount"),
+    };
+
+    for(const QString& var : vars) {
+        const VariableAccessor accessor = registry.resolveVariable(var);
+
+        const ScriptResult byName     = registry.value(var, track);
+        const ScriptResult byAccessor = registry.value(accessor, track);
+        EXPECT_EQ(byName.value, byAccessor.value) << var.toStdString();
+        EXPECT_EQ(byName.cond, byAccessor.cond) << var.toStdString();
+
+        const ScriptResult listByName     = registry.value(var, tracks);
+        const ScriptResult listByAccessor = registry.value(accessor, tracks);
+        EXPECT_EQ(listByName.value, listByAccessor.value) << var.toStdString();
+        EXPECT_EQ(listByName.cond, listByAccessor.cond) << var.toStdString();
+    }
+}
 } // namespace Fooyin::Testing
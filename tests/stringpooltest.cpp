@@ -0,0 +1,111 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <core/track.h>
+#include <utils/stringpool.h>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+namespace Fooyin::Testing {
+TEST(StringPoolTest, EqualStringsShareData)
+{
+    // Built separately so they start out as different allocations
+    const QString first  = QStringLiteral("Artist %1").arg(1);
+    const QString second = QStringLiteral("Artist %1").arg(1);
+    ASSERT_NE(first.constData(), second.constData());
+
+    StringPool& pool = StringPool::instance();
+
+    const QString internedFirst  = pool.intern(first);
+    const QString internedSecond = pool.intern(second);
+
+    EXPECT_EQ(internedFirst, first);
+    EXPECT_EQ(internedFirst.constData(), internedSecond.constData());
+    EXPECT_NE(pool.intern(QStringLiteral("Artist %1").arg(2)).constData(), internedFirst.constData());
+}
+
+TEST(StringPoolTest, ListsShareDataAndStrings)
+{
+    StringPool& pool = StringPool::instance();
+
+    const QStringList first  = pool.intern(QStringList{QStringLiteral("Genre %1").arg(1), QStringLiteral("Genre B")});
+    const QStringList second = pool.intern(QStringList{QStringLiteral("Genre %1").arg(1), QStringLiteral("Genre B")});
+    const QStringList single = pool.intern(QStringList{QStringLiteral("Genre %1").arg(1)});
+
+    EXPECT_EQ(first.constData(), second.constData());
+    EXPECT_EQ(first.front().constData(), single.front().constData());
+}
+
+TEST(StringPoolTest, EmptyStringsArentPooled)
+{
+    StringPool& pool = StringPool::instance();
+
+    EXPECT_TRUE(pool.intern(QString{}).isNull());
+    EXPECT_TRUE(pool.intern(QStringList{}).isEmpty());
+
+    // Empty values are stored as '' rather than NULL, so mustn't become null
+    const QString empty = pool.intern(QStringLiteral(""));
+    EXPECT_TRUE(empty.isEmpty());
+    EXPECT_FALSE(empty.isNull());
+}
+
+TEST(StringPoolTest, ConcurrentInterning)
+{
+    constexpr int ThreadCount = 8;
+    constexpr int ValueCount  = 1000;
+
+    std::vector<std::vector<QString>> results(ThreadCount);
+    std::vector<std::thread> threads;
+
+    for(int t{0}; t < ThreadCount; ++t) {
+        threads.emplace_back([&results, t]() {
+            for(int i{0}; i < ValueCount; ++i) {
+                results.at(t).push_back(StringPool::instance().intern(QStringLiteral("Concurrent %1").arg(i)));
+            }
+        });
+    }
+    for(auto& thread : threads) {
+        thread.join();
+    }
+
+    for(int t{1}; t < ThreadCount; ++t) {
+        for(int i{0}; i < ValueCount; ++i) {
+            ASSERT_EQ(results.at(0).at(i).constData(), results.at(t).at(i).constData());
+        }
+    }
+}
+
+TEST(StringPoolTest, TracksShareMetadata)
+{
+    Track first{QStringLiteral("/music/1.flac")};
+    Track second{QStringLiteral("/music/2.flac")};
+
+    first.setAlbum(QStringLiteral("Album %1").arg(1));
+    second.setAlbum(QStringLiteral("Album %1").arg(1));
+    first.setArtists({QStringLiteral("Artist %1").arg(1)});
+    second.setArtists({QStringLiteral("Artist %1").arg(1)});
+
+    EXPECT_EQ(first.album().constData(), second.album().constData());
+    EXPECT_EQ(first.artists().constData(), second.artists().constData());
+    EXPECT_EQ(first.extension().constData(), second.extension().constData());
+}
+} // namespace Fooyin::Testing
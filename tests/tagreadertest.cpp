@@ -23,6 +23,8 @@
 
 #include <core/track.h>
 
+#include <QDir>
+
 #include <gtest/gtest.h>
 
 // clazy:excludeall=returning-void-expression
@@ -237,6 +239,24 @@ TEST_F(TagReaderTest, OpusRead)
     EXPECT_EQ(testTag.front(), QStringLiteral("A custom tag"));
 }
 
+TEST_F(TagReaderTest, OpusWithOggSuffixRead)
+{
+    QTemporaryFile file{QDir::tempPath() + QStringLiteral("/fooyin_test_XXXXXX.ogg")};
+    ASSERT_TRUE(file.open());
+    {
+        QFile resource{QStringLiteral(":/audio/audiotest.opus")};
+        ASSERT_TRUE(resource.open(QIODevice::ReadOnly));
+        file.write(resource.readAll());
+        file.flush();
+    }
+
+    Track track{file.fileName()};
+    Tagging::readMetaData(track);
+
+    EXPECT_EQ(track.type(), Track::Type::OggOpus);
+    EXPECT_EQ(track.title(), QStringLiteral("OPUS Test"));
+}
+
 TEST_F(TagReaderTest, WavRead)
 {
     const TempResource file{QStringLiteral(":/audio/audiotest.wav")};
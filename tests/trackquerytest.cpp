@@ -0,0 +1,211 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <core/library/trackquery.h>
+#include <core/track.h>
+
+#include <QDateTime>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+namespace {
+constexpr int64_t MsPerDay = 24 * 3600000;
+
+Fooyin::TrackIds trackIds(const Fooyin::TrackList& tracks)
+{
+    Fooyin::TrackIds ids;
+    std::ranges::transform(tracks, std::back_inserter(ids), [](const Fooyin::Track& track) { return track.id(); });
+    return ids;
+}
+} // namespace
+
+namespace Fooyin::Testing {
+class TrackQueryTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        const int64_t now = QDateTime::currentMSecsSinceEpoch();
+
+        Track track1;
+        track1.setId(1);
+        track1.setTitle(QStringLiteral("Hey Jude"));
+        track1.setArtists({QStringLiteral("The Beatles")});
+        track1.setAlbum(QStringLiteral("Past Masters"));
+        track1.setGenres({QStringLiteral("Rock"), QStringLiteral("Pop")});
+        track1.setDate(QStringLiteral("1968"));
+        track1.setDuration(431000);
+        track1.setPlayCount(12);
+        track1.setAddedTime(QDateTime{QDate{2023, 5, 20}, QTime{12, 0}}.toMSecsSinceEpoch());
+        track1.setLastPlayed(now - (2 * MsPerDay));
+        track1.addExtraTag(QStringLiteral("MOOD"), QStringLiteral("Uplifting"));
+
+        Track track2;
+        track2.setId(2);
+        track2.setTitle(QStringLiteral("Paranoid Android"));
+        track2.setArtists({QStringLiteral("Radiohead")});
+        track2.setAlbum(QStringLiteral("OK Computer: OKNOTOK"));
+        track2.setGenres({QStringLiteral("Rock")});
+        track2.setDate(QStringLiteral("1997"));
+        track2.setDuration(383000);
+        track2.setPlayCount(3);
+        track2.setAddedTime(QDateTime{QDate{2024, 1, 2}, QTime{9, 30}}.toMSecsSinceEpoch());
+        track2.setLastPlayed(now - (60 * MsPerDay));
+
+        Track track3;
+        track3.setId(3);
+        track3.setTitle(QStringLiteral("Windowlicker"));
+        track3.setArtists({QStringLiteral("Aphex Twin")});
+        track3.setAlbum(QStringLiteral("Windowlicker"));
+        track3.setGenres({QStringLiteral("Electronic")});
+        track3.setDate(QStringLiteral("1999"));
+        track3.setDuration(366000);
+        track3.setAddedTime(QDateTime{QDate{2024, 1, 15}, QTime{18, 0}}.toMSecsSinceEpoch());
+
+        m_tracks = {track1, track2, track3};
+    }
+
+    [[nodiscard]] TrackIds filter(const QString& query) const
+    {
+        return trackIds(TrackQuery{query}.filter(m_tracks));
+    }
+
+    TrackList m_tracks;
+};
+
+TEST_F(TrackQueryTest, EmptyMatchesAll)
+{
+    EXPECT_TRUE(TrackQuery{}.isEmpty());
+    EXPECT_TRUE(TrackQuery{QStringLiteral("  ")}.isEmpty());
+    EXPECT_EQ((TrackIds{1, 2, 3}), filter({}));
+}
+
+TEST_F(TrackQueryTest, PlainWords)
+{
+    EXPECT_EQ((TrackIds{1}), filter(QStringLiteral("beatles")));
+    EXPECT_EQ((TrackIds{3}), filter(QStringLiteral("WINDOW")));
+    // Every word must match, but not necessarily in the same field
+    EXPECT_EQ((TrackIds{2}), filter(QStringLiteral("radiohead computer")));
+    EXPECT_EQ((TrackIds{}), filter(QStringLiteral("\"radiohead computer\"")));
+    EXPECT_EQ((TrackIds{2}), filter(QStringLiteral("\"ok comp")));
+    // Only built-in fields are treated as predicates
+    EXPECT_EQ((TrackIds{2}), filter(QStringLiteral("computer: oknotok")));
+    EXPECT_EQ((TrackIds{}), filter(QStringLiteral("mood:uplift")));
+}
+
+TEST_F(TrackQueryTest, TextFields)
+{
+    EXPECT_EQ((TrackIds{1, 2}), filter(QStringLiteral("genre:rock")));
+    EXPECT_EQ((TrackIds{1}), filter(QStringLiteral("genre=pop")));
+    EXPECT_EQ((TrackIds{3}), filter(QStringLiteral("genre!=rock")));
+    EXPECT_EQ((TrackIds{1}), filter(QStringLiteral("artist:\"the beatles\"")));
+    EXPECT_EQ((TrackIds{1}), filter(QStringLiteral("title: jude")));
+    EXPECT_EQ((TrackIds{}), filter(QStringLiteral("title=jude")));
+}
+
+TEST_F(TrackQueryTest, CustomTags)
+{
+    EXPECT_EQ((TrackIds{1}), filter(QStringLiteral("%mood%:uplift")));
+    EXPECT_EQ((TrackIds{1}), filter(QStringLiteral("%MOOD%=uplifting")));
+    EXPECT_EQ((TrackIds{2, 3}), filter(QStringLiteral("%mood%=\"\"")));
+    // Built-in fields can be named the same way
+    EXPECT_EQ((TrackIds{1}), filter(QStringLiteral("%title%:jude")));
+}
+
+TEST_F(TrackQueryTest, Numbers)
+{
+    EXPECT_EQ((TrackIds{2, 3}), filter(QStringLiteral("year>1990")));
+    EXPECT_EQ((TrackIds{1, 2}), filter(QStringLiteral("year:1960..1997")));
+    EXPECT_EQ((TrackIds{2, 3}), filter(QStringLiteral("year:1997..")));
+    EXPECT_EQ((TrackIds{1}), filter(QStringLiteral("playcount>=10")));
+    EXPECT_EQ((TrackIds{2, 3}), filter(QStringLiteral("playcount!=12")));
+    EXPECT_EQ((TrackIds{2, 3}), filter(QStringLiteral("duration<6:30")));
+    EXPECT_EQ((TrackIds{1}), filter(QStringLiteral("duration>400")));
+}
+
+TEST_F(TrackQueryTest, Dates)
+{
+    EXPECT_EQ((TrackIds{2, 3}), filter(QStringLiteral("addedtime:2024")));
+    EXPECT_EQ((TrackIds{2}), filter(QStringLiteral("addedtime=2024-01-02")));
+    EXPECT_EQ((TrackIds{1, 2}), filter(QStringLiteral("addedtime<=2024-01-02")));
+    EXPECT_EQ((TrackIds{3}), filter(QStringLiteral("addedtime>2024-01-02")));
+    EXPECT_EQ((TrackIds{2}), filter(QStringLiteral("addedtime:2023-06..2024-01-10")));
+    // Relative times are counted back from now, and tracks never played don't match
+    EXPECT_EQ((TrackIds{1}), filter(QStringLiteral("lastplayed>7d")));
+    EXPECT_EQ((TrackIds{2}), filter(QStringLiteral("lastplayed<4w")));
+}
+
+TEST_F(TrackQueryTest, BooleanOperators)
+{
+    EXPECT_EQ((TrackIds{1, 3}), filter(QStringLiteral("beatles OR aphex")));
+    EXPECT_EQ((TrackIds{2, 3}), filter(QStringLiteral("NOT beatles")));
+    EXPECT_EQ((TrackIds{2}), filter(QStringLiteral("genre:rock AND NOT year<1990")));
+    // AND binds tighter than OR
+    EXPECT_EQ((TrackIds{1, 3}), filter(QStringLiteral("genre:electronic OR genre:rock year<1990")));
+    EXPECT_EQ((TrackIds{3}), filter(QStringLiteral("(genre:electronic OR genre:rock) year>1998")));
+}
+
+TEST_F(TrackQueryTest, InvalidQueryFallsBack)
+{
+    const TrackQuery query{QStringLiteral("year>abc")};
+    EXPECT_FALSE(query.isValid());
+    EXPECT_EQ(0, query.error().position);
+
+    EXPECT_FALSE(TrackQuery{QStringLiteral("(beatles")}.isValid());
+    EXPECT_FALSE(TrackQuery{QStringLiteral("beatles OR")}.isValid());
+    EXPECT_FALSE(TrackQuery{QStringLiteral("title<abc")}.isValid());
+
+    // Unparseable queries are searched for as a single phrase
+    EXPECT_FALSE(TrackQuery{QStringLiteral("AND")}.isValid());
+    EXPECT_EQ((TrackIds{2}), filter(QStringLiteral("AND")));
+}
+
+TEST_F(TrackQueryTest, Narrows)
+{
+    const auto narrows = [](const char* query, const char* previous) {
+        return TrackQuery{QString::fromLatin1(query)}.narrows(TrackQuery{QString::fromLatin1(previous)});
+    };
+
+    EXPECT_TRUE(narrows("beat", ""));
+    EXPECT_TRUE(narrows("beatles", "beat"));
+    EXPECT_TRUE(narrows("beatles jude", "beatles"));
+    EXPECT_TRUE(narrows("\"hey jude\"", "jude"));
+    EXPECT_FALSE(narrows("beat", "beatles"));
+    EXPECT_FALSE(narrows("beatles OR aphex", "beatles"));
+    EXPECT_FALSE(narrows("year<1999", "year<19"));
+}
+
+TEST_F(TrackQueryTest, ParallelFilterKeepsOrder)
+{
+    TrackList tracks;
+    for(int i{0}; i < 50000; ++i) {
+        Track track{m_tracks.at(i % 3)};
+        track.setId(i);
+        tracks.push_back(track);
+    }
+
+    const TrackList matches = TrackQuery{QStringLiteral("genre:rock")}.filter(tracks);
+
+    ASSERT_EQ(33334U, matches.size());
+    EXPECT_TRUE(std::ranges::is_sorted(trackIds(matches)));
+    EXPECT_TRUE(std::ranges::all_of(matches, [](const Track& track) { return track.id() % 3 != 2; }));
+}
+} // namespace Fooyin::Testing